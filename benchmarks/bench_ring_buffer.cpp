@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+#include "ring_buffer.hpp"
+#include <deque>
+#include <vector>
+#include <string>
+#include <random>
+#include <cstring>
+
+#ifdef RING_BUFFER_BENCH_BOOST
+#include <boost/circular_buffer.hpp>
+#endif
+
+//
+/// @brief Benchmarks for the container hot paths, compared against the standard sequence containers and boost::circular_buffer.
+//================Element types=================//
+
+// Trivially copyable element of one cache line.
+struct Trivial64
+{
+    int values[16];
+};
+
+template<class T>
+T makeValue(size_t i);
+
+template<>
+int makeValue<int>(size_t i)
+{
+    return static_cast<int>(i);
+}
+
+template<>
+Trivial64 makeValue<Trivial64>(size_t i)
+{
+    Trivial64 value;
+    std::memset(&value, 0, sizeof(value));
+    value.values[0] = static_cast<int>(i);
+    return value;
+}
+
+// Long enough to not fit the small string optimization, so each element owns an allocation.
+template<>
+std::string makeValue<std::string>(size_t i)
+{
+    return std::string(32, 'x') + std::to_string(i);
+}
+
+inline size_t checksum(int value) { return static_cast<size_t>(value); }
+inline size_t checksum(const Trivial64& value) { return static_cast<size_t>(value.values[0]); }
+inline size_t checksum(const std::string& value) { return value.size(); }
+
+//================Container adapters=================//
+
+// Hides the differences in the container interfaces from the benchmarks.
+template<class Container>
+struct container_ops
+{
+    static constexpr bool fifo = true;
+
+    static void makeRoom(Container&) {}
+    static void popFront(Container& container) { container.pop_front(); }
+};
+
+// std::vector has no pop_front, and erasing its first element is linear, so it is left out of the FIFO benchmarks.
+template<class T>
+struct container_ops<std::vector<T>>
+{
+    static constexpr bool fifo = false;
+
+    static void makeRoom(std::vector<T>&) {}
+    static void popFront(std::vector<T>& container) { container.erase(container.begin()); }
+};
+
+#ifdef RING_BUFFER_BENCH_BOOST
+// boost::circular_buffer overwrites when full, grow it like the other containers instead.
+template<class T>
+struct container_ops<boost::circular_buffer<T>>
+{
+    static constexpr bool fifo = true;
+
+    static void makeRoom(boost::circular_buffer<T>& container)
+    {
+        if (container.full())
+        {
+            container.set_capacity(std::max<size_t>(16, container.capacity() * 2));
+        }
+    }
+    static void popFront(boost::circular_buffer<T>& container) { container.pop_front(); }
+};
+#endif
+
+template<class Container>
+void pushBack(Container& container, typename Container::value_type value)
+{
+    container_ops<Container>::makeRoom(container);
+    container.push_back(std::move(value));
+}
+
+template<class Container>
+Container makeFilled(size_t count)
+{
+    Container container;
+    for (size_t i = 0; i < count; ++i)
+    {
+        pushBack(container, makeValue<typename Container::value_type>(i));
+    }
+    return container;
+}
+
+//================Benchmarks=================//
+
+// Steady state queue: one push and one pop per iteration on a buffer holding range(0) elements. The ring buffer wraps around instead of moving elements.
+template<class Container>
+void BM_FifoPushPop(benchmark::State& state)
+{
+    using T = typename Container::value_type;
+    auto container = makeFilled<Container>(state.range(0));
+    const T value = makeValue<T>(42);
+
+    for (auto _ : state)
+    {
+        pushBack(container, value);
+        container_ops<Container>::popFront(container);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Stack usage: range(0) pushes followed by as many pops from the back.
+template<class Container>
+void BM_LifoPushPop(benchmark::State& state)
+{
+    using T = typename Container::value_type;
+    Container container = makeFilled<Container>(state.range(0));
+    container.clear();
+    const T value = makeValue<T>(42);
+
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            pushBack(container, value);
+        }
+        while (!container.empty())
+        {
+            container.pop_back();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Random access with operator[] to a buffer that has wrapped around its physical end.
+template<class Container>
+void BM_RandomAccess(benchmark::State& state)
+{
+    const size_t count = state.range(0);
+    auto container = makeFilled<Container>(count);
+    if (container_ops<Container>::fifo)
+    {
+        for (size_t i = 0; i < count / 2; ++i)
+        {
+            pushBack(container, makeValue<typename Container::value_type>(i));
+            container_ops<Container>::popFront(container);
+        }
+    }
+
+    std::mt19937 generator(1);
+    std::vector<size_t> indices(1024);
+    for (auto& index : indices)
+    {
+        index = generator() % count;
+    }
+
+    for (auto _ : state)
+    {
+        size_t sum = 0;
+        for (auto index : indices)
+        {
+            sum += checksum(container[index]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+// Full iteration over range(0) elements with iterators.
+template<class Container>
+void BM_Iterate(benchmark::State& state)
+{
+    const auto container = makeFilled<Container>(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t sum = 0;
+        for (const auto& value : container)
+        {
+            sum += checksum(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Insert to and erase from the middle of a buffer holding range(0) elements.
+template<class Container>
+void BM_MidInsertErase(benchmark::State& state)
+{
+    using T = typename Container::value_type;
+    auto container = makeFilled<Container>(state.range(0));
+    const T value = makeValue<T>(42);
+
+    for (auto _ : state)
+    {
+        container_ops<Container>::makeRoom(container);
+        auto it = container.insert(container.begin() + container.size() / 2, value);
+        container.erase(it);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Growth from an empty container to range(0) elements, including every reallocation.
+template<class Container>
+void BM_GrowFromEmpty(benchmark::State& state)
+{
+    using T = typename Container::value_type;
+    const T value = makeValue<T>(42);
+
+    for (auto _ : state)
+    {
+        Container container;
+        for (int64_t i = 0; i < state.range(0); ++i)
+        {
+            pushBack(container, value);
+        }
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//================Registration=================//
+
+template<class Container>
+void registerContainer(const std::string& name)
+{
+    auto registerOne = [&name](const char* benchmarkName, void (*function)(benchmark::State&))
+    {
+        benchmark::RegisterBenchmark((std::string(benchmarkName) + "<" + name + ">").c_str(), function)->RangeMultiplier(16)->Range(64, 1 << 16);
+    };
+
+    if (container_ops<Container>::fifo)
+    {
+        registerOne("FifoPushPop", BM_FifoPushPop<Container>);
+    }
+    registerOne("LifoPushPop", BM_LifoPushPop<Container>);
+    registerOne("RandomAccess", BM_RandomAccess<Container>);
+    registerOne("Iterate", BM_Iterate<Container>);
+    registerOne("MidInsertErase", BM_MidInsertErase<Container>);
+    registerOne("GrowFromEmpty", BM_GrowFromEmpty<Container>);
+}
+
+template<class T>
+void registerElement(const std::string& name)
+{
+    registerContainer<ring_buffer<T>>("ring_buffer," + name);
+    registerContainer<pow2_ring_buffer<T>>("pow2_ring_buffer," + name);
+    registerContainer<std::deque<T>>("deque," + name);
+    registerContainer<std::vector<T>>("vector," + name);
+#ifdef RING_BUFFER_BENCH_BOOST
+    registerContainer<boost::circular_buffer<T>>("circular_buffer," + name);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    registerElement<int>("int");
+    registerElement<Trivial64>("Trivial64");
+    registerElement<std::string>("string");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -7,13 +7,31 @@
 #include <utility>
 #include <stdexcept>
 #include <cstring>
+#include <cstdint>
 #include <vector>
+#include <type_traits>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <string>
+
+// With C++20 the element and index operations of the buffer can run in constant expressions, see static_ring_buffer.
+#if __cplusplus >= 202002L && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define RING_BUFFER_HAS_CONSTEXPR 1
+#define RING_BUFFER_CONSTEXPR constexpr
+#else
+#define RING_BUFFER_CONSTEXPR
+#endif
 
 namespace
 {
     // Buffer always reserves two "extra" spaces. This ensures that reserve and other relocating functions work correctly (the "never full" invariant).
     constexpr size_t allocBuffer = 2;
 
+    // Assumed size of a cache line. Indices shared between threads are padded to this to avoid false sharing.
+    constexpr size_t cacheLineSize = 64;
+
     //Temporary object holder.
     template<typename Alloc>
     struct _alloc_temp
@@ -39,7 +57,7 @@ namespace
         }
 
         template<typename... Args>
-        explicit _alloc_temp(Alloc allocator, Args&&... args) noexcept(
+        explicit _alloc_temp(Alloc& allocator, Args&&... args) noexcept(
         noexcept(_traits::construct(_alloc, std::addressof(_getValue()), std::forward<Args>(args)...)))
         : _alloc(allocator)
         {
@@ -53,7 +71,28 @@ namespace
 
     };
 
-    
+    template<typename...>
+    using _void_t = void;
+
+    // True if Alloc declares its own destroy member for T*.
+    template<typename Alloc, typename = void>
+    struct _has_destroy : std::false_type {};
+
+    // Only detects the member, which C++20 deprecates for std::pmr::polymorphic_allocator.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+    template<typename Alloc>
+    struct _has_destroy<Alloc, _void_t<decltype(std::declval<Alloc&>().destroy(std::declval<typename Alloc::value_type*>()))>> : std::true_type {};
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+    // True if destroying an element through Alloc does nothing: the element is trivially destructible and Alloc is std::allocator or has no destroy of its own.
+    template<typename Alloc>
+    struct _trivial_destroy : std::integral_constant<bool, std::is_trivially_destructible<typename Alloc::value_type>::value &&
+        (std::is_same<Alloc, std::allocator<typename Alloc::value_type>>::value || !_has_destroy<Alloc>::value)> {};
 }
 
 //Base class that wraps memory allocation into an initialization (RAII).
@@ -69,9 +108,12 @@ namespace
         T* m_data;  /*!< Pointer to allocated memory.*/
         Allocator m_allocator;  /*!< Allocator used to allocate/deallocate and construct/destruct elements. Default is std::allocator<T>*/
 
-        ring_buffer_base(const Allocator& alloc, size_type capacity)
-            : m_allocator(alloc), m_data(alloc_traits::allocate(m_allocator, capacity)), m_capacity(capacity)
+        /// @brief Allocates memory for capacity elements. A capacity of 0 allocates nothing, for storages that are about to take over other memory.
+        RING_BUFFER_CONSTEXPR ring_buffer_base(const Allocator& alloc, size_type capacity)
+            : m_capacity(capacity), m_data(nullptr), m_allocator(alloc)
         {
+            // m_allocator is declared after m_data, allocate only once it has been initialized.
+            m_data = capacity ? alloc_traits::allocate(m_allocator, capacity) : nullptr;
         }
 
         ring_buffer_base(const ring_buffer_base&) = delete;
@@ -87,1769 +129,4782 @@ namespace
             return *this;
         }
 
-        template<typename U>
-        void swap(ring_buffer_base<U>& left, ring_buffer_base<U>& right) noexcept
+        void swap(ring_buffer_base& left, ring_buffer_base& right) noexcept
         {
             std::swap(left.m_allocator, right.m_allocator);    
             std::swap(left.m_data, right.m_data);
             std::swap(left.m_capacity, right.m_capacity);
         }
 
-        ~ring_buffer_base() { alloc_traits::deallocate(m_allocator, m_data, m_capacity); }
-    };
-
-// Forward declaration of _rBuf_const_iterator.
-template<class _rBuf>
-class _rBuf_const_iterator;
+        RING_BUFFER_CONSTEXPR ~ring_buffer_base() { alloc_traits::deallocate(m_allocator, m_data, m_capacity); }
 
-/// @brief Dynamic Ringbuffer is a dynamically growing circular AllocatorAware std::container with support for queue, stack and priority queue adaptor functionality.
-/// @tparam T Type of the elements.
-/// @tparam Allocator Allocator used for (de)allocation and (de)construction. Defaults to std::allocator<T>
-template<typename T, typename Allocator = std::allocator<T>> 
-class ring_buffer : private ring_buffer_base<T,Allocator>
-{
+        static constexpr size_type inline_capacity = 0;  /*!< Amount of elements that can be stored inside the object itself.*/
+        static constexpr bool is_mirrored = false;  /*!< True if the memory is mapped twice back to back, so that m_data[i] and m_data[i + m_capacity] are the same element.*/
 
-public:
+        /// @brief True if the elements live inside the object. Heap storage never does.
+        RING_BUFFER_CONSTEXPR bool isInline() const noexcept { return false; }
 
-    using base = typename ring_buffer<T,Allocator>::ring_buffer_base;
+        /// @brief Allocates memory for capacity elements. Does not take ownership of it.
+        /// @param capacity Amount of elements to allocate for. Storages may round it up.
+        T* allocateStorage(size_type& capacity) { return alloc_traits::allocate(m_allocator, capacity); }
 
-    using size_type = typename base::size_type;
-    using allocator_type = typename base::allocator_type;
-    using alloc_traits = typename base::alloc_traits;
+        /// @brief Deallocates memory returned by allocateStorage().
+        void deallocateStorage(T* data, size_type capacity) noexcept { alloc_traits::deallocate(m_allocator, data, capacity); }
 
-    using value_type = T;
-    using reference = T&;
-    using const_reference = const T&;
-    using pointer = T*;
-    using const_pointer = const T*;
-    using difference_type = std::ptrdiff_t;
+        /// @brief Deallocates the current memory and takes ownership of data. The current memory must not hold any constructed elements.
+        void replaceStorage(T* data, size_type capacity) noexcept
+        {
+            deallocateStorage(m_data, m_capacity);
+            m_data = data;
+            m_capacity = capacity;
+        }
 
-    /// @brief Custom iterator class.
-    /// @tparam _rBuf ring_buffer class type.
-    template<class _rBuf>
-    class _rBuf_const_iterator
-    {
+        /// @brief Gives up the ownership of the current memory without deallocating it, after it has been handed to another storage.
+        void detachStorage() noexcept
+        {
+            m_data = nullptr;
+            m_capacity = 0;
+        }
 
-    public:
-        using iterator_category = std::random_access_iterator_tag;
+        /// @brief Deallocates the current memory, leaving the storage without any. The current memory must not hold any constructed elements.
+        void releaseStorage() noexcept
+        {
+            deallocateStorage(m_data, m_capacity);
+            detachStorage();
+        }
+    };
 
-        using value_type = typename _rBuf::value_type;
-        using difference_type = typename _rBuf::difference_type;
-        using pointer = typename _rBuf::const_pointer;
-        using reference = const value_type&;
+    template<typename T, typename Allocator>
+    constexpr typename ring_buffer_base<T, Allocator>::size_type ring_buffer_base<T, Allocator>::inline_capacity;
+    template<typename T, typename Allocator>
+    constexpr bool ring_buffer_base<T, Allocator>::is_mirrored;
 
-    public:
-        _rBuf_const_iterator() : m_container(nullptr), m_logicalIndex(0) {}
+//Storage with room for N elements inside the object. Memory is allocated only when the capacity needs to exceed N.
+    template<typename T, typename Allocator, size_t N>
+    struct small_ring_buffer_base {
 
-        /// @brief Constructor.
-        /// @param index Index representing the logical element of the buffer where iterator points to.
-        explicit _rBuf_const_iterator(const _rBuf* container, difference_type index) : m_container(container), m_logicalIndex(index) {}
+        static_assert(N >= allocBuffer, "inline capacity must hold at least allocBuffer elements");
 
-        /// @brief Arrow operator.
-        /// @return pointer.
-        /// @details Constant complexity.
-        pointer operator->() const
-        {
-            return &(*m_container)[m_logicalIndex];
-        }
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+        using alloc_traits = std::allocator_traits<allocator_type>;
 
-        /// @brief Postfix increment
-        /// @note If the iterator is incremented over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator& operator++() noexcept
-        {
-            m_logicalIndex++;
+        static constexpr size_type inline_capacity = N;  /*!< Amount of elements that can be stored inside the object itself.*/
+        static constexpr bool is_mirrored = false;  /*!< True if the memory is mapped twice back to back.*/
 
-            return (*this);
-        }
+        size_type m_capacity;  /*!< Capacity of the buffer. N while the inline storage is in use.*/
 
-        /// @brief Postfix increment
-        /// @param  int empty parameter to guide overload resolution.
-        /// @note If the iterator is incremented over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator operator++(int)
-        {
-            auto temp(*this);
-            ++m_logicalIndex;
+        T* m_data;  /*!< Pointer to the inline storage or to allocated memory.*/
+        Allocator m_allocator;  /*!< Allocator used to allocate/deallocate and construct/destruct elements. Default is std::allocator<T>*/
 
-            return temp;
-        }
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type m_inline[N];  /*!< Inline storage for up to N elements.*/
 
-        /// @brief Prefix decrement.
-        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator& operator--()
+        small_ring_buffer_base(const Allocator& alloc, size_type capacity)
+            : m_capacity(std::max(capacity, N)), m_data(nullptr), m_allocator(alloc)
         {
-            --m_logicalIndex;
-            return(*this);
+            m_data = capacity <= N ? inlineStorage() : alloc_traits::allocate(m_allocator, capacity);
         }
 
-        /// @brief Postfix decrement
-        /// @param  int empty parameter to guide overload resolution.
-        /// @note Decrementing iterator past begin() results in undefined behaviour.
-        /// @details Constant complexity.
-        _rBuf_const_iterator operator--(int)
+        small_ring_buffer_base(const small_ring_buffer_base&) = delete;
+        small_ring_buffer_base& operator=(const small_ring_buffer_base&) = delete;
+        small_ring_buffer_base& operator=(small_ring_buffer_base&&) = delete;
+
+        /// @brief Takes over allocated memory. Inline elements can't be taken over by pointer, in that case the new object points to its own inline storage and the owner relocates the elements.
+        small_ring_buffer_base(small_ring_buffer_base&& other) noexcept
+            : m_capacity(other.m_capacity), m_data(other.isInline() ? inlineStorage() : other.m_data), m_allocator(std::move(other.m_allocator))
         {
-            auto temp(*this);
-            --m_logicalIndex;
-            return temp;
+            if (!other.isInline())
+            {
+                other.detachStorage();
+            }
         }
 
-        /// @brief Moves iterator.
-        /// @param offset Amount of elements to move. Negative values move iterator backwards.
-        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator& operator+=(difference_type offset) noexcept
+        ~small_ring_buffer_base() { deallocateStorage(m_data, m_capacity); }
+
+        T* inlineStorage() noexcept { return reinterpret_cast<T*>(m_inline); }
+
+        bool isInline() const noexcept { return m_data == reinterpret_cast<const T*>(m_inline); }
+
+        /// @brief Hands out the inline storage if capacity fits in it and it is not in use, otherwise allocates memory.
+        /// @param capacity Amount of elements to allocate for. Rounded up to N if the inline storage is used.
+        T* allocateStorage(size_type& capacity)
         {
-            if (offset < 0)
+            if (capacity <= N && !isInline())
             {
-                m_logicalIndex -= abs(offset);
+                capacity = N;
+                return inlineStorage();
             }
-            else
+            return alloc_traits::allocate(m_allocator, capacity);
+        }
+
+        void deallocateStorage(T* data, size_type capacity) noexcept
+        {
+            if (data != inlineStorage())
             {
-                m_logicalIndex += offset;
+                alloc_traits::deallocate(m_allocator, data, capacity);
             }
-            return (*this);
         }
 
-        /// @brief Move iterator forward by specified amount.
-        /// @param movement Amount of elements to move the iterator.
-        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator operator+(const difference_type offset) const
+        void replaceStorage(T* data, size_type capacity) noexcept
         {
-            _rBuf_const_iterator temp(m_container, m_logicalIndex);
-            return (temp += offset);
+            deallocateStorage(m_data, m_capacity);
+            m_data = data;
+            m_capacity = capacity;
         }
 
-        /// @brief Addition operator with the offset at the beginning of the operation.
-        /// @param offset The number of positions to move the iterator forward.
-        /// @param iter Base iterator to what the offset is added to.
-        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
-        /// @details Constant complexity.
-        friend _rBuf_const_iterator operator+(const difference_type offset, _rBuf_const_iterator iter)
+        /// @brief Gives up the ownership of allocated memory without deallocating it, falling back to the inline storage.
+        void detachStorage() noexcept
         {
-            auto temp = iter;
-            temp += offset;
-            return temp;
+            m_data = inlineStorage();
+            m_capacity = N;
         }
 
-        /// @brief Returns an iterator that points to an element, which is the current element decremented by the given offset.
-        /// @param offset The number of positions to move the iterator backward.
-        /// @return An iterator pointing to the element that is offset positions before the current element.
-        /// @details Constant complexity.
-        _rBuf_const_iterator& operator-=(const difference_type offset) noexcept
+        /// @brief Deallocates the allocated memory, falling back to the inline storage. The current memory must not hold any constructed elements.
+        void releaseStorage() noexcept
         {
-            return (*this += -offset);
+            deallocateStorage(m_data, m_capacity);
+            detachStorage();
         }
+    };
 
-        /// @brief Returns an iterator that points to an element, which is the current element decremented by the given offset.
-        /// @param offset The number of positions to move the iterator backward.
-        /// @return An iterator pointing to the element that is offset positions before the current element.
-        /// @note If offset is such that the index of the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_const_iterator operator-(const difference_type offset) const
+    template<typename T, typename Allocator, size_t N>
+    constexpr typename small_ring_buffer_base<T, Allocator, N>::size_type small_ring_buffer_base<T, Allocator, N>::inline_capacity;
+    template<typename T, typename Allocator, size_t N>
+    constexpr bool small_ring_buffer_base<T, Allocator, N>::is_mirrored;
+
+//Storage with room for exactly N elements inside the object. Never allocates, the allocator is only used to construct and destroy the elements.
+    template<typename T, typename Allocator, size_t N>
+    struct static_ring_buffer_base {
+
+        static_assert(N >= allocBuffer, "static capacity must hold at least allocBuffer elements");
+
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        static constexpr size_type inline_capacity = N;  /*!< Amount of elements that can be stored inside the object itself.*/
+        static constexpr bool is_mirrored = false;  /*!< True if the memory is mapped twice back to back.*/
+
+        // A union leaves the elements unconstructed, unlike an array of T, and can be used in constant expressions, unlike raw bytes.
+        union inline_storage
         {
-            _rBuf_const_iterator temp(m_container, m_logicalIndex);
-            return (temp -= offset);
-        }
+            RING_BUFFER_CONSTEXPR inline_storage() noexcept {}
+            RING_BUFFER_CONSTEXPR ~inline_storage() {}
+            T m_elements[N];
+        };
 
-        /// @brief Gets distance between two iterators.
-        /// @param iterator Iterator to get distance to.
-        /// @return Amount of elements between the iterators.
-        /// @details Constant complexity.
-        difference_type operator-(const _rBuf_const_iterator& other) const noexcept
+        size_type m_capacity;  /*!< Capacity of the buffer. Always N.*/
+
+        T* m_data;  /*!< Pointer to the inline storage.*/
+        Allocator m_allocator;  /*!< Allocator used to construct/destruct elements.*/
+
+        inline_storage m_inline;  /*!< Storage for the N elements.*/
+
+        /// @brief The requested capacity is ignored, the storage always has room for N elements.
+        RING_BUFFER_CONSTEXPR static_ring_buffer_base(const Allocator& alloc, size_type)
+            : m_capacity(N), m_data(m_inline.m_elements), m_allocator(alloc)
         {
-            return (m_logicalIndex - other.m_logicalIndex);
         }
 
-        /// @brief Index operator.
-        /// @param offset The offset from iterator.
-        /// @return Return reference to element pointed by the iterator with offset.
-        /// @note If offset is such that the iterator is beyond end() or begin() this function has undefined behaviour.
-        /// @details Constant complexity.
-        reference operator[](const difference_type offset) const noexcept
+        static_ring_buffer_base(const static_ring_buffer_base&) = delete;
+        static_ring_buffer_base& operator=(const static_ring_buffer_base&) = delete;
+        static_ring_buffer_base& operator=(static_ring_buffer_base&&) = delete;
+
+        /// @brief Elements can't be taken over by pointer, the new object points to its own storage and the owner relocates the elements.
+        static_ring_buffer_base(static_ring_buffer_base&& other) noexcept
+            : m_capacity(N), m_data(m_inline.m_elements), m_allocator(std::move(other.m_allocator))
         {
-            return m_container->operator[](m_logicalIndex + offset);
         }
 
-        /// @brief Comparison operator== overload
-        /// @param other iterator to compare
-        /// @return True if iterators point to same element in same container.
-        /// @details Constant complexity.
-        bool operator==(const _rBuf_const_iterator& other) const noexcept
+        RING_BUFFER_CONSTEXPR bool isInline() const noexcept { return true; }
+
+        /// @brief There is no memory besides the inline storage.
+        /// @throw Always throws std::length_error.
+        [[noreturn]] T* allocateStorage(size_type&)
         {
-            return (m_logicalIndex == other.m_logicalIndex) && (m_container == other.m_container);
+            throw std::length_error("static_ring_buffer capacity exceeded");
         }
 
-        /// @brief Comparison operator != overload
-        /// @param other iterator to compare
-        /// @return ture if underlying pointers are not the same
-        /// @details Constant complexity.
-        bool operator!=(const _rBuf_const_iterator& other) const noexcept
+        void deallocateStorage(T*, size_type) noexcept {}
+
+        void replaceStorage(T*, size_type) noexcept {}
+
+        void detachStorage() noexcept {}
+
+        void releaseStorage() noexcept {}
+    };
+
+    template<typename T, typename Allocator, size_t N>
+    constexpr typename static_ring_buffer_base<T, Allocator, N>::size_type static_ring_buffer_base<T, Allocator, N>::inline_capacity;
+    template<typename T, typename Allocator, size_t N>
+    constexpr bool static_ring_buffer_base<T, Allocator, N>::is_mirrored;
+
+//Heap storage that keeps one retired memory area as a spare instead of deallocating it. The next reallocation in the same direction takes the spare
+//if it is large enough, so a buffer that repeatedly grows and shrinks between the same capacities stops calling the allocator.
+    template<typename T, typename Allocator = std::allocator<T>>
+    struct spare_ring_buffer_base {
+
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        static constexpr size_type inline_capacity = 0;  /*!< Amount of elements that can be stored inside the object itself.*/
+        static constexpr bool is_mirrored = false;  /*!< True if the memory is mapped twice back to back.*/
+
+        size_type m_capacity;  /*!< Capacity of the buffer.*/
+
+        T* m_data;  /*!< Pointer to allocated memory.*/
+        Allocator m_allocator;  /*!< Allocator used to allocate/deallocate and construct/destruct elements.*/
+        T* m_spare;  /*!< Retired memory kept for the next reallocation, holds no elements. Null if there is none.*/
+        size_type m_spareCapacity;  /*!< Capacity of m_spare, 0 if there is none.*/
+
+        spare_ring_buffer_base(const Allocator& alloc, size_type capacity)
+            : m_capacity(capacity), m_data(nullptr), m_allocator(alloc), m_spare(nullptr), m_spareCapacity(0)
         {
-            return !(m_logicalIndex == other.m_logicalIndex && m_container == other.m_container);
+            m_data = capacity ? alloc_traits::allocate(m_allocator, capacity) : nullptr;
         }
 
-        /// @brief Comparison operator < overload
-        /// @param other iterator to compare against.
-        /// @return True if other is larger.
-        /// @note Comparing to an iterator from another container is undefined.
-        /// @details Constant complexity.
-        bool operator<(const _rBuf_const_iterator& other) const noexcept
+        spare_ring_buffer_base(const spare_ring_buffer_base&) = delete;
+        spare_ring_buffer_base& operator=(const spare_ring_buffer_base&) = delete;
+        spare_ring_buffer_base& operator=(spare_ring_buffer_base&&) = delete;
+
+        spare_ring_buffer_base(spare_ring_buffer_base&& other) noexcept
+            : m_capacity(std::exchange(other.m_capacity, 0)), m_data(std::exchange(other.m_data, nullptr)), m_allocator(std::move(other.m_allocator)),
+            m_spare(std::exchange(other.m_spare, nullptr)), m_spareCapacity(std::exchange(other.m_spareCapacity, 0))
         {
-            return (m_logicalIndex < other.m_logicalIndex);
         }
 
-        /// @brief Comparison operator > overload
-        /// @param other iterator to compare against.
-        /// @return True if other is smaller.
-        /// @note Comparing to an iterator from another container is undefined.
-        /// @details Constant complexity.
-        bool operator>(const _rBuf_const_iterator& other) const noexcept
+        ~spare_ring_buffer_base()
         {
-            return (other.m_logicalIndex < m_logicalIndex);
+            releaseSpare();
+            alloc_traits::deallocate(m_allocator, m_data, m_capacity);
         }
 
-        /// @brief Less or equal operator.
-        /// @param other Other iterator to compare against.
-        /// @return Returns true if index of this is less or equal than other's. Otherwise false.
-        /// @note Comparing to an iterator from another container is undefined.
-        /// @details Constant complexity.
-        bool operator<=(const _rBuf_const_iterator& other) const noexcept
+        /// @brief Heap storage is never inline.
+        bool isInline() const noexcept { return false; }
+
+        /// @brief Takes the spare if it has room for capacity elements and lies on the same side of m_capacity, so growing never takes a smaller
+        /// area and shrinking never takes a larger one than the current memory. Allocates otherwise.
+        /// @param capacity Amount of elements to allocate for. Set to the capacity of the spare if it is taken.
+        T* allocateStorage(size_type& capacity)
         {
-            return (!(other < m_logicalIndex));
+            if (m_spare && m_spareCapacity >= capacity && (capacity > m_capacity) == (m_spareCapacity > m_capacity))
+            {
+                capacity = std::exchange(m_spareCapacity, 0);
+                return std::exchange(m_spare, nullptr);
+            }
+            return alloc_traits::allocate(m_allocator, capacity);
         }
 
-        /// @brief Greater or equal than operator.
-        /// @param other Iterator to compare against.
-        /// @return Returns true if this's index is greater than or equal to other.
-        /// @note Comparing to an iterator from another container is undefined.
-        /// @details Constant complexity.
-        bool operator>=(const _rBuf_const_iterator& other) const noexcept
+        /// @brief Keeps data as the spare if it is larger than the current one, which is deallocated. Deallocates data otherwise.
+        void deallocateStorage(T* data, size_type capacity) noexcept
         {
-            return (!(m_logicalIndex < other.m_logicalIndex));
+            if (!data)
+            {
+                return;
+            }
+            if (capacity > m_spareCapacity)
+            {
+                releaseSpare();
+                m_spare = data;
+                m_spareCapacity = capacity;
+            }
+            else
+            {
+                alloc_traits::deallocate(m_allocator, data, capacity);
+            }
         }
 
-        /// @brief Custom assingment operator overload.
-        /// @param index Logical index of the element which point to.
-        /// @details Constant complexity.
-        _rBuf_const_iterator& operator=(const size_t index) noexcept
+        /// @brief Retires the current memory and takes ownership of data. The current memory must not hold any constructed elements.
+        void replaceStorage(T* data, size_type capacity) noexcept
         {
-            m_logicalIndex = index;
-            return (*this);
-        };
+            deallocateStorage(m_data, m_capacity);
+            m_data = data;
+            m_capacity = capacity;
+        }
 
-        /// @brief Dereference operator.
-        /// @return Object pointed by iterator.
-        /// @details Constant complexity.
-        reference operator*() const noexcept
+        /// @brief Gives up the ownership of the current memory without deallocating it, after it has been handed to another storage.
+        void detachStorage() noexcept
         {
-            return (*m_container)[m_logicalIndex];
-
+            m_data = nullptr;
+            m_capacity = 0;
         }
 
-        /// @brief Returns the logical index of the element the iterator is pointing to.
-        /// @details Constant complexity.
-        difference_type getIndex() const noexcept
+        /// @brief Retires the current memory, leaving the storage without any. The current memory must not hold any constructed elements.
+        void releaseStorage() noexcept
         {
-            return m_logicalIndex;
+            deallocateStorage(m_data, m_capacity);
+            detachStorage();
         }
 
-    protected:
-        // The parent container.
-        const _rBuf* m_container;
-
-        // The iterator does not point to any memory location, but is interfaced to the Ring Buffer via an index which is the logical index
-        // to an element. Logical index 0 is the first element in the buffer and last is size - 1.
-        difference_type m_logicalIndex;
+        /// @brief Deallocates the spare.
+        void releaseSpare() noexcept
+        {
+            if (m_spare)
+            {
+                alloc_traits::deallocate(m_allocator, m_spare, m_spareCapacity);
+                m_spare = nullptr;
+                m_spareCapacity = 0;
+            }
+        }
     };
 
-    /// @brief Custom iterator class.
-    /// @tparam T Type of the element what iterator points to.
-    template<class _rBuf>
-    class _rBuf_iterator : public _rBuf_const_iterator<_rBuf>
-    {
+    template<typename T, typename Allocator>
+    constexpr typename spare_ring_buffer_base<T, Allocator>::size_type spare_ring_buffer_base<T, Allocator>::inline_capacity;
+    template<typename T, typename Allocator>
+    constexpr bool spare_ring_buffer_base<T, Allocator>::is_mirrored;
 
-    public:
-        using iterator_category = std::random_access_iterator_tag;
+/// @brief Customization point telling whether elements of T can be relocated with memcpy, without calling the move constructor and destructor.
+/// @tparam T Type of the elements.
+/// @note Defaults to std::is_trivially_copyable. Can be specialized to std::true_type for types that are trivially relocatable but not trivially copyable, e.g. types holding a std::unique_ptr.
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
 
-        using c_iterator = _rBuf_const_iterator<_rBuf>;
-        using value_type = typename _rBuf::value_type;
-        using difference_type = typename _rBuf::difference_type;
-        using pointer = typename _rBuf::pointer;
-        using reference = value_type&;
+/// @brief Customization point telling whether two elements of T compare equal exactly when their bytes are equal, so that they can be compared with memcmp.
+/// @tparam T Type of the elements.
+/// @note Defaults to true for integral, enumeration and pointer types. Floating point types are excluded because of NaN and signed zero.
+/// Can be specialized to std::true_type for trivially copyable types without padding whose operator== compares all members.
+template<typename T>
+struct is_bitwise_comparable : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> {};
 
-    public:
+namespace
+{
+    // Header in front of a serialized ring_buffer, followed by the elements from front to back.
+    struct _serial_header
+    {
+        static constexpr std::uint32_t magic = 0x31534252;  // "RBS1" in little endian.
 
-        /// @brief Default constructor
-        _rBuf_iterator() = default;
+        std::uint32_t _magic;
+        std::uint32_t _elementSize;  // sizeof the element type if the elements are raw bytes, 0 if they went through ring_buffer_serializer.
+        std::uint64_t _size;
+    };
 
-        /// @brief Constructor.
-        /// @param container Pointer to the ring_buffer element which owns this iterator.
-        /// @param index Index pointing to the logical element of the ring_buffer.
-        /// @details Constant complexity.
-        explicit _rBuf_iterator(_rBuf* container, size_type index) : c_iterator(container, index) {}
+    // Output that appends to a vector, so snapshot() can serialize into memory.
+    struct _vector_writer
+    {
+        std::vector<char>& _bytes;
 
-        /// @brief Dereference operator
-        /// @return  Returns the object the iterator is currently pointing to.
-        /// @details Constant complexity.
-        reference operator*() const noexcept
+        _vector_writer& write(const char* data, std::ptrdiff_t count)
         {
-            return (*(const_cast<_rBuf*>(c_iterator::m_container)))[c_iterator::m_logicalIndex];
+            _bytes.insert(_bytes.end(), data, data + count);
+            return *this;
+        }
+
+        explicit operator bool() const noexcept { return true; }
+    };
+
+    // Input that reads from a byte range and fails once it runs out, so restore() can deserialize from memory.
+    struct _memory_reader
+    {
+        const char* _data;
+        size_t _size;
+        bool _good;
+
+        _memory_reader& read(char* out, std::ptrdiff_t count) noexcept
+        {
+            const auto bytes = static_cast<size_t>(count);
+            _good = _good && bytes <= _size;
+            if (_good && bytes)
+            {
+                std::memcpy(out, _data, bytes);
+                _data += bytes;
+                _size -= bytes;
+            }
+            return *this;
+        }
+
+        explicit operator bool() const noexcept { return _good; }
+    };
+
+    // Upper bound of the bytes left in an input, so that a corrupt size in the data is rejected before it is allocated.
+    // Streams make no promise, only _memory_reader knows its end.
+    template<typename In>
+    RING_BUFFER_CONSTEXPR size_t _readableBytes(const In&) noexcept
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    inline size_t _readableBytes(const _memory_reader& in) noexcept
+    {
+        return in._good ? in._size : 0;
+    }
+}
+
+/// @brief Customization point for serializing elements that aren't trivially copyable, see ring_buffer::serialize().
+/// @tparam T Type of the elements.
+/// @note Specializations provide template<typename Out> static void write(Out& out, const T& value) and template<typename In> static T read(In& in),
+/// where out.write(const char*, count) and in.read(char*, count) behave like the std::ostream and std::istream members.
+/// Trivially copyable elements are stored as raw bytes and don't use it. A specialization for std::basic_string is provided.
+template<typename T>
+struct ring_buffer_serializer;
+
+/// @brief Serializes a string as its 64 bit length followed by its characters.
+template<typename CharT, typename Traits, typename Alloc>
+struct ring_buffer_serializer<std::basic_string<CharT, Traits, Alloc>>
+{
+    using string_type = std::basic_string<CharT, Traits, Alloc>;
+
+    template<typename Out>
+    static void write(Out& out, const string_type& value)
+    {
+        const std::uint64_t length = value.size();
+        out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out.write(reinterpret_cast<const char*>(value.data()), static_cast<std::ptrdiff_t>(value.size() * sizeof(CharT)));
+    }
+
+    /// @throw Throws std::runtime_error if in ends before the string does.
+    template<typename In>
+    static string_type read(In& in)
+    {
+        std::uint64_t length = 0;
+        if (!in.read(reinterpret_cast<char*>(&length), sizeof(length)) || length > string_type().max_size() || length > _readableBytes(in) / sizeof(CharT))
+        {
+            throw std::runtime_error("ring_buffer: invalid serialized string");
+        }
+        string_type value(static_cast<size_t>(length), CharT());
+        if (!in.read(reinterpret_cast<char*>(&value[0]), static_cast<std::ptrdiff_t>(value.size() * sizeof(CharT))))
+        {
+            throw std::runtime_error("ring_buffer: invalid serialized string");
+        }
+        return value;
+    }
+};
+
+
+/// @brief Default capacity policy. Capacity grows by a factor of 1.5 and physical indices are wrapped with modulo.
+struct default_capacity_policy
+{
+    /// @brief True if a full buffer overwrites its oldest elements instead of growing.
+    static constexpr bool overwrites = false;
+
+    /// @brief True if the buffer collects ring_buffer_statistics and calls growth and overflow hooks.
+    static constexpr bool collects_stats = false;
+
+    /// @brief True if the buffer shrinks on its own after sustained low occupancy.
+    static constexpr bool shrinks_when_idle = false;
+
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = ring_buffer_base<T, Allocator>;
+
+    /// @brief Rounds a requested capacity up to a capacity the policy can work with.
+    /// @param capacity Requested capacity.
+    /// @return Capacity to allocate.
+    static constexpr size_t fit(size_t capacity) noexcept
+    {
+        return capacity;
+    }
+
+    /// @brief Calculates the next capacity when the buffer needs to grow.
+    /// @param capacity Current capacity.
+    /// @return Capacity after growth.
+    static constexpr size_t grow(size_t capacity) noexcept
+    {
+        return capacity / 2 + capacity;
+    }
+
+    /// @brief Wraps an index to the physical memory area.
+    /// @param index Index to wrap. Can be any value.
+    /// @param capacity Capacity of the buffer.
+    /// @return Index in range [0, capacity).
+    static constexpr size_t wrap(size_t index, size_t capacity) noexcept
+    {
+        return index % capacity;
+    }
+
+    /// @brief Moves an index forward with wrap around.
+    /// @param index Index to move, must be less than capacity.
+    /// @param n Amount of steps, must be less than or equal to capacity.
+    /// @param capacity Capacity of the buffer.
+    /// @return The moved index.
+    static constexpr size_t advance(size_t index, size_t n, size_t capacity) noexcept
+    {
+        return (index + n >= capacity) ? index + n - capacity : index + n;
+    }
+
+    /// @brief Moves an index backward with wrap around.
+    /// @param index Index to move, must be less than capacity.
+    /// @param n Amount of steps, must be less than or equal to capacity.
+    /// @param capacity Capacity of the buffer.
+    /// @return The moved index.
+    static constexpr size_t retreat(size_t index, size_t n, size_t capacity) noexcept
+    {
+        return (index < n) ? index + capacity - n : index - n;
+    }
+
+    /// @brief Calculates the amount of elements between tail and head.
+    /// @param tail Index of the first element.
+    /// @param head Index past the last element.
+    /// @param capacity Capacity of the buffer.
+    /// @return Amount of elements in [tail, head).
+    static constexpr size_t distance(size_t tail, size_t head, size_t capacity) noexcept
+    {
+        return (head < tail) ? head + capacity - tail : head - tail;
+    }
+};
+
+/// @brief Power-of-two capacity policy. Capacity is always kept at a power of two and grows by doubling, which allows wrapping indices with a bitmask instead of a division.
+struct pow2_capacity_policy
+{
+    /// @brief True if a full buffer overwrites its oldest elements instead of growing.
+    static constexpr bool overwrites = false;
+
+    /// @brief True if the buffer collects ring_buffer_statistics and calls growth and overflow hooks.
+    static constexpr bool collects_stats = false;
+
+    /// @brief True if the buffer shrinks on its own after sustained low occupancy.
+    static constexpr bool shrinks_when_idle = false;
+
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = ring_buffer_base<T, Allocator>;
+
+    /// @brief Rounds a requested capacity up to the next power of two.
+    /// @param capacity Requested capacity.
+    /// @return Smallest power of two that is greater than or equal to capacity.
+    /// @throw Throws std::length_error if capacity is larger than the highest power of two size_t can represent.
+    static constexpr size_t fit(size_t capacity)
+    {
+        if (capacity > (std::numeric_limits<size_t>::max() >> 1) + 1)
+        {
+            throw std::length_error("ring_buffer: capacity exceeds the largest power of two");
+        }
+        size_t result = 1;
+        while (result < capacity)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    /// @brief Doubles the capacity, which keeps the power of two invariant.
+    /// @param capacity Current capacity.
+    /// @return Capacity after growth.
+    static constexpr size_t grow(size_t capacity) noexcept
+    {
+        return capacity * 2;
+    }
+
+    /// @brief Wraps an index to the physical memory area with a bitmask.
+    static constexpr size_t wrap(size_t index, size_t capacity) noexcept
+    {
+        return index & (capacity - 1);
+    }
+
+    /// @brief Moves an index forward with wrap around.
+    static constexpr size_t advance(size_t index, size_t n, size_t capacity) noexcept
+    {
+        return (index + n) & (capacity - 1);
+    }
+
+    /// @brief Moves an index backward with wrap around. Relies on unsigned wrap around of size_t.
+    static constexpr size_t retreat(size_t index, size_t n, size_t capacity) noexcept
+    {
+        return (index - n) & (capacity - 1);
+    }
+
+    /// @brief Calculates the amount of elements between tail and head.
+    static constexpr size_t distance(size_t tail, size_t head, size_t capacity) noexcept
+    {
+        return (head - tail) & (capacity - 1);
+    }
+};
+
+/// @brief Overwriting capacity policy. Capacity is pinned and a full buffer overwrites elements instead of growing, giving a hard memory bound.
+/// @tparam Policy Policy used for rounding the capacity and wrapping the indices. Defaults to default_capacity_policy.
+/// @note push_back, emplace_back and the bulk appends drop the oldest element from the front, push_front and emplace_front drop the newest element from the back.
+/// Operations that would need more room than the capacity otherwise (insert, assign, copy assignment...) throw std::length_error. The capacity can only be changed explicitly with reserve() or shrink_to_fit().
+template<typename Policy = default_capacity_policy>
+struct overwrite_capacity_policy : Policy
+{
+    /// @brief True if a full buffer overwrites its oldest elements instead of growing.
+    static constexpr bool overwrites = true;
+
+    /// @brief Capacity never grows implicitly.
+    /// @param capacity Current capacity.
+    /// @return The same capacity.
+    static constexpr size_t grow(size_t capacity) noexcept
+    {
+        return capacity;
+    }
+};
+
+/// @brief Small buffer capacity policy. Up to N elements are stored inside the buffer object, memory is allocated only beyond that.
+/// @tparam N Inline capacity. The buffer holds at most N - 1 elements inline, as one slot is always kept free. Must be a capacity Policy can work with.
+/// @tparam Policy Policy used for growth and wrapping the indices. Defaults to default_capacity_policy.
+/// @note shrink_to_fit() moves the elements back inline and releases the allocated memory once they fit. Moving and swapping buffers that use the inline storage
+/// relocates the elements, value_type's move constructor should not throw.
+template<size_t N, typename Policy = default_capacity_policy>
+struct small_capacity_policy : Policy
+{
+    static_assert(Policy::fit(N) == N, "inline capacity must be a capacity the policy can work with");
+
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = small_ring_buffer_base<T, Allocator, N>;
+};
+
+/// @brief Static capacity policy. The buffer has room for exactly N elements inside the object and never allocates, and the capacity is a compile time constant in the index math.
+/// @tparam N Capacity. The buffer holds at most N - 1 elements, as one slot is always kept free. With a power of two N indices are wrapped with a bitmask.
+/// @note Operations that need more room throw std::length_error, wrap this policy with overwrite_capacity_policy to drop the oldest elements instead.
+/// Inserting into the middle, and data() on wrapped elements, also throw std::length_error if value_type can't be shifted without exceptions. Moving and swapping relocate the elements.
+/// With C++20 (RING_BUFFER_HAS_CONSTEXPR) the buffer can be used in constant expressions, see static_ring_buffer.
+template<size_t N>
+struct static_capacity_policy
+{
+    /// @brief True if a full buffer overwrites its oldest elements instead of growing.
+    static constexpr bool overwrites = false;
+
+    /// @brief True if the buffer collects ring_buffer_statistics and calls growth and overflow hooks.
+    static constexpr bool collects_stats = false;
+
+    /// @brief True if the buffer shrinks on its own after sustained low occupancy.
+    static constexpr bool shrinks_when_idle = false;
+
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = static_ring_buffer_base<T, Allocator, N>;
+
+    static constexpr bool is_pow2 = (N & (N - 1)) == 0;  /*!< True if indices are wrapped with a bitmask.*/
+
+    /// @brief Requests are passed on as is, the storage refuses anything larger than N.
+    static constexpr size_t fit(size_t capacity) noexcept
+    {
+        return capacity;
+    }
+
+    /// @brief Capacity never grows.
+    static constexpr size_t grow(size_t capacity) noexcept
+    {
+        return capacity;
+    }
+
+    /// @brief Wraps an index to [0, N). The capacity argument is always N and ignored, so the division is by a constant.
+    static constexpr size_t wrap(size_t index, size_t) noexcept
+    {
+        return is_pow2 ? index & (N - 1) : index % N;
+    }
+
+    /// @brief Moves an index forward with wrap around.
+    static constexpr size_t advance(size_t index, size_t n, size_t) noexcept
+    {
+        return is_pow2 ? (index + n) & (N - 1) : (index + n >= N ? index + n - N : index + n);
+    }
+
+    /// @brief Moves an index backward with wrap around.
+    static constexpr size_t retreat(size_t index, size_t n, size_t) noexcept
+    {
+        return is_pow2 ? (index - n) & (N - 1) : (index < n ? index + N - n : index - n);
+    }
+
+    /// @brief Calculates the amount of elements between tail and head.
+    static constexpr size_t distance(size_t tail, size_t head, size_t) noexcept
+    {
+        return is_pow2 ? (head - tail) & (N - 1) : (head < tail ? head + N - tail : head - tail);
+    }
+};
+
+template<size_t N>
+constexpr bool static_capacity_policy<N>::is_pow2;
+
+/// @brief Growth function multiplying the capacity by Numerator / Denominator. The default matches default_capacity_policy.
+template<size_t Numerator = 3, size_t Denominator = 2>
+struct geometric_growth
+{
+    static_assert(Numerator > Denominator, "geometric growth factor must be greater than one");
+
+    /// @brief Calculates the next capacity.
+    /// @param capacity Current capacity.
+    /// @return Capacity after growth.
+    constexpr size_t operator()(size_t capacity) const noexcept
+    {
+        return capacity / Denominator * Numerator + capacity % Denominator * Numerator / Denominator;
+    }
+};
+
+/// @brief Growth function doubling the capacity.
+using doubling_growth = geometric_growth<2, 1>;
+
+/// @brief Growth function adding a fixed amount of elements to the capacity. Keeps memory overhead bounded, but growing to n elements takes n / Increment reallocations.
+template<size_t Increment>
+struct fixed_growth
+{
+    static_assert(Increment > 0, "capacity must grow");
+
+    /// @brief Calculates the next capacity.
+    /// @param capacity Current capacity.
+    /// @return Capacity after growth.
+    constexpr size_t operator()(size_t capacity) const noexcept
+    {
+        return capacity + Increment;
+    }
+};
+
+/// @brief Growth capacity policy. Replaces the growth of Policy with a growth function and keeps a minimum capacity.
+/// @tparam Growth Default constructible function object taking the current capacity and returning the next one, e.g. geometric_growth, doubling_growth, fixed_growth or a caller-provided type.
+/// @tparam MinCapacity Minimum capacity the buffer allocates, so a new buffer holds MinCapacity - 1 elements before it reallocates for the first time.
+/// @tparam Policy Policy used for rounding the capacity and wrapping the indices. Defaults to default_capacity_policy.
+/// @note The capacity returned by Growth is still rounded by Policy::fit, and the buffer grows further if one step is not enough for an operation.
+/// shrink_to_fit() and reserve() don't go below MinCapacity. Combine with overwrite_capacity_policy by wrapping this policy, not the other way around.
+template<typename Growth, size_t MinCapacity = 0, typename Policy = default_capacity_policy>
+struct growth_capacity_policy : Policy
+{
+    /// @brief Rounds a requested capacity up to at least MinCapacity and to a capacity Policy can work with.
+    /// @param capacity Requested capacity.
+    /// @return Capacity to allocate.
+    static constexpr size_t fit(size_t capacity) noexcept(noexcept(Policy::fit(capacity)))
+    {
+        return Policy::fit(std::max(capacity, MinCapacity));
+    }
+
+    /// @brief Calculates the next capacity with Growth.
+    /// @param capacity Current capacity.
+    /// @return Capacity after growth.
+    static size_t grow(size_t capacity)
+    {
+        return Growth()(capacity);
+    }
+};
+
+/// @brief Statistics capacity policy. Makes the buffer count its growths, relocations and traffic, see ring_buffer::statistics(), and enables the growth and overflow hooks.
+/// @tparam Policy Policy used for everything else. Defaults to default_capacity_policy.
+/// @note Without this policy the counters compile away and the buffer is as large as before. Wrap the other policies with this one, e.g.
+/// stats_capacity_policy<overwrite_capacity_policy<>>.
+template<typename Policy = default_capacity_policy>
+struct stats_capacity_policy : Policy
+{
+    /// @brief True if the buffer collects ring_buffer_statistics and calls growth and overflow hooks.
+    static constexpr bool collects_stats = true;
+};
+
+/// @brief Spare capacity policy. A buffer that moves to new memory keeps its retired memory as a spare, and the next reallocation takes it instead of allocating.
+/// @tparam Policy Policy used for growth and wrapping the indices. Defaults to default_capacity_policy.
+/// @note At most one spare is kept, the largest retired area. Growth takes it if it is large enough and shrinking takes it if it is smaller than the current memory,
+/// so a buffer cycling between a burst and an idle capacity stops calling the allocator after the first cycle. The spare costs its memory until
+/// ring_buffer::release_spare() or destruction. Combine with hysteresis_capacity_policy, see elastic_ring_buffer.
+template<typename Policy = default_capacity_policy>
+struct spare_capacity_policy : Policy
+{
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = spare_ring_buffer_base<T, Allocator>;
+};
+
+/// @brief Hysteresis capacity policy. The buffer shrinks on its own, but only after its occupancy stayed below a low watermark for a while, and then only
+/// down to a high watermark, so it neither holds on to the memory of a past burst forever nor regrows through every step of Policy::grow on the next one.
+/// @tparam LowPercent Occupancy in percent of the capacity below which the buffer counts as idle.
+/// @tparam HighPercent Occupancy in percent of the capacity right after the buffer shrinks. Must be greater than LowPercent, so a shrink doesn't start the next one.
+/// @tparam Patience Amount of pops in a row that leave the buffer idle before it shrinks. A bulk pop counts once, a pop that leaves the buffer at or above the low watermark starts over.
+/// @tparam Policy Policy used for growth and wrapping the indices. Defaults to default_capacity_policy.
+/// @note The occupancy is checked by pop_front, pop_back, pop_front_n, drop_back and the consume functions, which can then reallocate and invalidate
+/// all iterators, pointers and references. A failed allocation leaves the buffer as it is. Pushes stay as cheap as with Policy.
+template<size_t LowPercent = 25, size_t HighPercent = 50, size_t Patience = 1024, typename Policy = default_capacity_policy>
+struct hysteresis_capacity_policy : Policy
+{
+    static_assert(0 < LowPercent && LowPercent < HighPercent && HighPercent <= 100, "watermarks must satisfy 0 < LowPercent < HighPercent <= 100");
+    static_assert(Patience > 0, "the buffer must stay idle before it shrinks");
+
+    /// @brief True if the buffer shrinks on its own after sustained low occupancy.
+    static constexpr bool shrinks_when_idle = true;
+
+    /// @brief Amount of pops in a row that leave the buffer idle before it shrinks.
+    static constexpr size_t idle_patience = Patience;
+
+    /// @brief Tells whether size elements in capacity slots are below the low watermark.
+    static constexpr bool is_idle(size_t size, size_t capacity) noexcept
+    {
+        return size < capacity / 100 * LowPercent + capacity % 100 * LowPercent / 100;
+    }
+
+    /// @brief Capacity in which size elements fill HighPercent of the slots, before rounding by fit.
+    static constexpr size_t shrink_target(size_t size) noexcept
+    {
+        return size / HighPercent * 100 + size % HighPercent * 100 / HighPercent + allocBuffer;
+    }
+};
+
+template<size_t LowPercent, size_t HighPercent, size_t Patience, typename Policy>
+constexpr size_t hysteresis_capacity_policy<LowPercent, HighPercent, Patience, Policy>::idle_patience;
+
+/// @brief Counts elements dropped by an overwriting ring buffer. Empty unless Enabled, so non-overwriting buffers don't pay for it.
+template<bool Enabled>
+struct ring_buffer_drop_counter
+{
+    RING_BUFFER_CONSTEXPR size_t getDrops() const noexcept { return 0; }
+    RING_BUFFER_CONSTEXPR void addDrops(size_t) noexcept {}
+    RING_BUFFER_CONSTEXPR void clearDrops() noexcept {}
+    void swapDrops(ring_buffer_drop_counter&) noexcept {}
+};
+
+template<>
+struct ring_buffer_drop_counter<true>
+{
+    size_t m_dropped = 0;  /*!< Amount of elements overwritten since construction or the last reset.*/
+
+    RING_BUFFER_CONSTEXPR size_t getDrops() const noexcept { return m_dropped; }
+    RING_BUFFER_CONSTEXPR void addDrops(size_t count) noexcept { m_dropped += count; }
+    RING_BUFFER_CONSTEXPR void clearDrops() noexcept { m_dropped = 0; }
+    void swapDrops(ring_buffer_drop_counter& other) noexcept { std::swap(m_dropped, other.m_dropped); }
+};
+
+/// @brief Counts pops in a row that left the buffer idle, for hysteresis_capacity_policy. Empty unless Enabled.
+template<bool Enabled>
+struct ring_buffer_idle_counter
+{
+    RING_BUFFER_CONSTEXPR size_t addIdlePop() noexcept { return 0; }
+    RING_BUFFER_CONSTEXPR void clearIdlePops() noexcept {}
+};
+
+template<>
+struct ring_buffer_idle_counter<true>
+{
+    size_t m_idlePops = 0;  /*!< Pops since the occupancy was last at or above the low watermark.*/
+
+    size_t addIdlePop() noexcept { return ++m_idlePops; }
+    void clearIdlePops() noexcept { m_idlePops = 0; }
+};
+
+/// @brief Counters of a ring buffer whose capacity policy collects statistics. See ring_buffer::statistics().
+struct ring_buffer_statistics
+{
+    size_t growths = 0;  /*!< Times the elements moved to a larger memory area.*/
+    size_t bytes_relocated = 0;  /*!< Bytes of elements moved to another memory area by growth, shrinking, assignment or growing in place.*/
+    size_t linearizations = 0;  /*!< Calls of data() that had to move the elements to make them contiguous.*/
+    size_t slow_inserts = 0;  /*!< Inserts that relocated the whole buffer although capacity was left, because value_type can't be shifted in place without exceptions.*/
+    size_t peak_size = 0;  /*!< Largest size() after an element was added.*/
+    size_t pushes = 0;  /*!< Elements added by push, emplace, insert, append and commit_back.*/
+    size_t pops = 0;  /*!< Elements removed by pop, consume, advance_front, drop_back and erase. clear() is not counted.*/
+    size_t overflows = 0;  /*!< Elements overwritten by an overwriting policy.*/
+};
+
+/// @brief Collects ring_buffer_statistics and holds the hooks. Empty unless Enabled, so buffers without stats_capacity_policy don't pay for it.
+template<bool Enabled>
+struct ring_buffer_stats_collector
+{
+    ring_buffer_statistics getStats() const noexcept { return ring_buffer_statistics(); }
+    void clearStats() noexcept {}
+    void swapStats(ring_buffer_stats_collector&) noexcept {}
+    void setGrowthHook(std::function<void(size_t, size_t)>) noexcept {}
+    void setOverflowHook(std::function<void(size_t)>) noexcept {}
+    RING_BUFFER_CONSTEXPR void countPushes(size_t, size_t) noexcept {}
+    RING_BUFFER_CONSTEXPR void countPops(size_t) noexcept {}
+    void countRelocation(size_t, size_t, size_t) noexcept {}
+    void countLinearization() noexcept {}
+    void countSlowInsert() noexcept {}
+    RING_BUFFER_CONSTEXPR void countOverflows(size_t) noexcept {}
+};
+
+template<>
+struct ring_buffer_stats_collector<true>
+{
+    ring_buffer_statistics m_stats;
+    std::function<void(size_t, size_t)> m_growthHook;  /*!< Called with the old and the new capacity after growth.*/
+    std::function<void(size_t)> m_overflowHook;  /*!< Called with the amount of overwritten elements.*/
+
+    ring_buffer_stats_collector() = default;
+    /// @brief Copies start with fresh counters and without hooks.
+    ring_buffer_stats_collector(const ring_buffer_stats_collector&) noexcept {}
+    ring_buffer_stats_collector& operator=(const ring_buffer_stats_collector&) noexcept { return *this; }
+    ring_buffer_stats_collector(ring_buffer_stats_collector&& other) noexcept
+        : m_stats(std::exchange(other.m_stats, ring_buffer_statistics())), m_growthHook(std::move(other.m_growthHook)), m_overflowHook(std::move(other.m_overflowHook))
+    {
+        other.m_growthHook = nullptr;
+        other.m_overflowHook = nullptr;
+    }
+
+    ring_buffer_statistics getStats() const noexcept { return m_stats; }
+    void clearStats() noexcept { m_stats = ring_buffer_statistics(); }
+    void swapStats(ring_buffer_stats_collector& other) noexcept
+    {
+        std::swap(m_stats, other.m_stats);
+        m_growthHook.swap(other.m_growthHook);
+        m_overflowHook.swap(other.m_overflowHook);
+    }
+    void setGrowthHook(std::function<void(size_t, size_t)> hook) noexcept { m_growthHook = std::move(hook); }
+    void setOverflowHook(std::function<void(size_t)> hook) noexcept { m_overflowHook = std::move(hook); }
+
+    void countPushes(size_t count, size_t size) noexcept
+    {
+        m_stats.pushes += count;
+        m_stats.peak_size = std::max(m_stats.peak_size, size);
+    }
+
+    void countPops(size_t count) noexcept { m_stats.pops += count; }
+
+    void countRelocation(size_t oldCapacity, size_t newCapacity, size_t bytes) noexcept
+    {
+        m_stats.bytes_relocated += bytes;
+        if (newCapacity > oldCapacity)
+        {
+            ++m_stats.growths;
+            if (m_growthHook)
+            {
+                m_growthHook(oldCapacity, newCapacity);
+            }
+        }
+    }
+
+    void countLinearization() noexcept { ++m_stats.linearizations; }
+    void countSlowInsert() noexcept { ++m_stats.slow_inserts; }
+
+    void countOverflows(size_t count) noexcept
+    {
+        m_stats.overflows += count;
+        if (m_overflowHook)
+        {
+            m_overflowHook(count);
+        }
+    }
+};
+
+/// @brief Non-owning view to a contiguous segment of memory inside a ring buffer.
+/// @tparam T Type of the elements. Const qualified for read-only views.
+template<typename T>
+class ring_buffer_span
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    /// @brief Default constructor. Constructs an empty view.
+    constexpr ring_buffer_span() noexcept : m_data(nullptr), m_size(0) {}
+
+    /// @brief Constructs a view to count elements starting from data.
+    /// @param data Pointer to the first element of the segment.
+    /// @param count Amount of elements in the segment.
+    constexpr ring_buffer_span(pointer data, size_type count) noexcept : m_data(data), m_size(count) {}
+
+    /// @brief Converting constructor from a non-const view to a const view.
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U(*)[], T(*)[]>::value>>
+    constexpr ring_buffer_span(const ring_buffer_span<U>& other) noexcept : m_data(other.data()), m_size(other.size()) {}
+
+    /// @brief Pointer to the first element of the segment.
+    constexpr pointer data() const noexcept { return m_data; }
+
+    /// @brief Amount of elements in the segment.
+    constexpr size_type size() const noexcept { return m_size; }
+
+    /// @brief Size of the segment in bytes.
+    constexpr size_type size_bytes() const noexcept { return m_size * sizeof(T); }
+
+    /// @brief Check if the segment is empty.
+    constexpr bool empty() const noexcept { return m_size == 0; }
+
+    constexpr iterator begin() const noexcept { return m_data; }
+    constexpr iterator end() const noexcept { return m_data + m_size; }
+
+    /// @brief Index operator. Behaviour is undefined if index >= size().
+    constexpr reference operator[](size_type index) const noexcept { return m_data[index]; }
+
+private:
+    pointer m_data;
+    size_type m_size;
+};
+
+// Forward declaration of _rBuf_const_iterator.
+template<class _rBuf>
+class _rBuf_const_iterator;
+
+/// @brief Dynamic Ringbuffer is a dynamically growing circular AllocatorAware std::container with support for queue, stack and priority queue adaptor functionality.
+/// @tparam T Type of the elements.
+/// @tparam Allocator Allocator used for (de)allocation and (de)construction. Defaults to std::allocator<T>
+/// @tparam CapacityPolicy Policy that decides how capacity grows and how indices are wrapped. Defaults to default_capacity_policy.
+template<typename T, typename Allocator = std::allocator<T>, typename CapacityPolicy = default_capacity_policy> 
+class ring_buffer : private CapacityPolicy::template storage<T,Allocator>, private ring_buffer_drop_counter<CapacityPolicy::overwrites>,
+    private ring_buffer_stats_collector<CapacityPolicy::collects_stats>, private ring_buffer_idle_counter<CapacityPolicy::shrinks_when_idle>
+{
+
+public:
+
+    using base = typename CapacityPolicy::template storage<T,Allocator>;
+    using drop_counter = ring_buffer_drop_counter<CapacityPolicy::overwrites>;
+    using stats_collector = ring_buffer_stats_collector<CapacityPolicy::collects_stats>;
+    using idle_counter = ring_buffer_idle_counter<CapacityPolicy::shrinks_when_idle>;
+
+    using size_type = typename base::size_type;
+    using allocator_type = typename base::allocator_type;
+    using alloc_traits = typename base::alloc_traits;
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using difference_type = std::ptrdiff_t;
+
+    using span = ring_buffer_span<T>;
+    using const_span = ring_buffer_span<const T>;
+
+    /// @brief Custom iterator class.
+    /// @tparam _rBuf ring_buffer class type.
+    template<class _rBuf>
+    class _rBuf_const_iterator
+    {
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+
+        using value_type = typename _rBuf::value_type;
+        using difference_type = typename _rBuf::difference_type;
+        using pointer = typename _rBuf::const_pointer;
+        using reference = const value_type&;
+
+    public:
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator() : m_ptr(nullptr), m_begin(nullptr), m_end(nullptr), m_logicalIndex(0) {}
+
+        /// @brief Constructor.
+        /// @param container Pointer to the ring_buffer which owns this iterator.
+        /// @param index Index representing the logical element of the buffer where iterator points to.
+        RING_BUFFER_CONSTEXPR explicit _rBuf_const_iterator(const _rBuf* container, difference_type index)
+            : m_ptr(container->physicalAddress(index)), m_begin(container->m_data), m_end(container->m_data + container->m_capacity), m_logicalIndex(index) {}
+
+        /// @brief Arrow operator.
+        /// @return pointer.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR pointer operator->() const
+        {
+            return m_ptr;
+        }
+
+        /// @brief Postfix increment
+        /// @note If the iterator is incremented over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator& operator++() noexcept
+        {
+            _increment();
+            return (*this);
+        }
+
+        /// @brief Postfix increment
+        /// @param  int empty parameter to guide overload resolution.
+        /// @note If the iterator is incremented over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator operator++(int)
+        {
+            auto temp(*this);
+            _increment();
+            return temp;
+        }
+
+        /// @brief Prefix decrement.
+        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator& operator--()
+        {
+            _decrement();
+            return(*this);
+        }
+
+        /// @brief Postfix decrement
+        /// @param  int empty parameter to guide overload resolution.
+        /// @note Decrementing iterator past begin() results in undefined behaviour.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator operator--(int)
+        {
+            auto temp(*this);
+            _decrement();
+            return temp;
+        }
+
+        /// @brief Moves iterator.
+        /// @param offset Amount of elements to move. Negative values move iterator backwards.
+        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator& operator+=(difference_type offset) noexcept
+        {
+            _advance(offset);
+            return (*this);
+        }
+
+        /// @brief Move iterator forward by specified amount.
+        /// @param movement Amount of elements to move the iterator.
+        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator operator+(const difference_type offset) const
+        {
+            _rBuf_const_iterator temp(*this);
+            return (temp += offset);
+        }
+
+        /// @brief Addition operator with the offset at the beginning of the operation.
+        /// @param offset The number of positions to move the iterator forward.
+        /// @param iter Base iterator to what the offset is added to.
+        /// @note If offset is such that the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
+        /// @details Constant complexity.
+        friend RING_BUFFER_CONSTEXPR _rBuf_const_iterator operator+(const difference_type offset, _rBuf_const_iterator iter)
+        {
+            auto temp = iter;
+            temp += offset;
+            return temp;
+        }
+
+        /// @brief Returns an iterator that points to an element, which is the current element decremented by the given offset.
+        /// @param offset The number of positions to move the iterator backward.
+        /// @return An iterator pointing to the element that is offset positions before the current element.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator& operator-=(const difference_type offset) noexcept
+        {
+            return (*this += -offset);
+        }
+
+        /// @brief Returns an iterator that points to an element, which is the current element decremented by the given offset.
+        /// @param offset The number of positions to move the iterator backward.
+        /// @return An iterator pointing to the element that is offset positions before the current element.
+        /// @note If offset is such that the index of the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator operator-(const difference_type offset) const
+        {
+            _rBuf_const_iterator temp(*this);
+            return (temp -= offset);
+        }
+
+        /// @brief Gets distance between two iterators.
+        /// @param iterator Iterator to get distance to.
+        /// @return Amount of elements between the iterators.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR difference_type operator-(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (m_logicalIndex - other.m_logicalIndex);
+        }
+
+        /// @brief Index operator.
+        /// @param offset The offset from iterator.
+        /// @return Return reference to element pointed by the iterator with offset.
+        /// @note If offset is such that the iterator is beyond end() or begin() this function has undefined behaviour.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR reference operator[](const difference_type offset) const noexcept
+        {
+            return *(*this + offset);
+        }
+
+        /// @brief Comparison operator== overload
+        /// @param other iterator to compare
+        /// @return True if iterators point to same element in same container.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator==(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (m_logicalIndex == other.m_logicalIndex) && (m_begin == other.m_begin);
+        }
+
+        /// @brief Comparison operator != overload
+        /// @param other iterator to compare
+        /// @return ture if underlying pointers are not the same
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator!=(const _rBuf_const_iterator& other) const noexcept
+        {
+            return !(m_logicalIndex == other.m_logicalIndex && m_begin == other.m_begin);
+        }
+
+        /// @brief Comparison operator < overload
+        /// @param other iterator to compare against.
+        /// @return True if other is larger.
+        /// @note Comparing to an iterator from another container is undefined.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator<(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (m_logicalIndex < other.m_logicalIndex);
+        }
+
+        /// @brief Comparison operator > overload
+        /// @param other iterator to compare against.
+        /// @return True if other is smaller.
+        /// @note Comparing to an iterator from another container is undefined.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator>(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (other.m_logicalIndex < m_logicalIndex);
+        }
+
+        /// @brief Less or equal operator.
+        /// @param other Other iterator to compare against.
+        /// @return Returns true if index of this is less or equal than other's. Otherwise false.
+        /// @note Comparing to an iterator from another container is undefined.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator<=(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (!(other.m_logicalIndex < m_logicalIndex));
+        }
+
+        /// @brief Greater or equal than operator.
+        /// @param other Iterator to compare against.
+        /// @return Returns true if this's index is greater than or equal to other.
+        /// @note Comparing to an iterator from another container is undefined.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator>=(const _rBuf_const_iterator& other) const noexcept
+        {
+            return (!(m_logicalIndex < other.m_logicalIndex));
+        }
+
+        /// @brief Custom assingment operator overload.
+        /// @param index Logical index of the element which point to.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_const_iterator& operator=(const size_t index) noexcept
+        {
+            _advance(static_cast<difference_type>(index) - m_logicalIndex);
+            return (*this);
+        };
+
+        /// @brief Dereference operator.
+        /// @return Object pointed by iterator.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR reference operator*() const noexcept
+        {
+            return *m_ptr;
+        }
+
+        /// @brief Returns the logical index of the element the iterator is pointing to.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR difference_type getIndex() const noexcept
+        {
+            return m_logicalIndex;
+        }
+
+    protected:
+        /// @brief Steps to the next element. Wraps only when crossing the physical end of memory.
+        RING_BUFFER_CONSTEXPR void _increment() noexcept
+        {
+            ++m_logicalIndex;
+            if (++m_ptr == m_end)
+            {
+                m_ptr = m_begin;
+            }
+        }
+
+        /// @brief Steps to the previous element. Wraps only when crossing the physical beginning of memory.
+        RING_BUFFER_CONSTEXPR void _decrement() noexcept
+        {
+            --m_logicalIndex;
+            if (m_ptr == m_begin)
+            {
+                m_ptr = m_end;
+            }
+            --m_ptr;
+        }
+
+        /// @brief Moves the iterator by offset elements with at most one wrap around.
+        /// @param offset Signed amount of elements to move, absolute value must not exceed the capacity of the buffer.
+        RING_BUFFER_CONSTEXPR void _advance(difference_type offset) noexcept
+        {
+            m_logicalIndex += offset;
+
+            const difference_type capacity = m_end - m_begin;
+            difference_type physical = (m_ptr - m_begin) + offset;
+            if (physical >= capacity)
+            {
+                physical -= capacity;
+            }
+            else if (physical < 0)
+            {
+                physical += capacity;
+            }
+            m_ptr = m_begin + physical;
+        }
+
+        // Pointer to the element in physical memory, so that dereferencing needs no index arithmetic.
+        pointer m_ptr;
+
+        // Physical memory area of the parent container, [m_begin, m_end). Used for wrapping m_ptr and identifying the container.
+        pointer m_begin;
+        pointer m_end;
+
+        // Logical index to the element. Logical index 0 is the first element in the buffer and last is size - 1.
+        // Used for distance and ordering between iterators.
+        difference_type m_logicalIndex;
+    };
+
+    /// @brief Custom iterator class.
+    /// @tparam T Type of the element what iterator points to.
+    template<class _rBuf>
+    class _rBuf_iterator : public _rBuf_const_iterator<_rBuf>
+    {
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+
+        using c_iterator = _rBuf_const_iterator<_rBuf>;
+        using value_type = typename _rBuf::value_type;
+        using difference_type = typename _rBuf::difference_type;
+        using pointer = typename _rBuf::pointer;
+        using reference = value_type&;
+
+    public:
+
+        /// @brief Default constructor
+        _rBuf_iterator() = default;
+
+        /// @brief Constructor.
+        /// @param container Pointer to the ring_buffer element which owns this iterator.
+        /// @param index Index pointing to the logical element of the ring_buffer.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR explicit _rBuf_iterator(_rBuf* container, size_type index) : c_iterator(container, index) {}
+
+        /// @brief Dereference operator
+        /// @return  Returns the object the iterator is currently pointing to.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR reference operator*() const noexcept
+        {
+            return *const_cast<pointer>(c_iterator::m_ptr);
         }
 
         /// @brief Arrow operator. 
         /// @return Returns a pointer to the object the iterator is currently pointing to.
         /// @details Constant complexity.
-        pointer operator->() const noexcept
+        RING_BUFFER_CONSTEXPR pointer operator->() const noexcept
+        {
+            return const_cast<pointer>(c_iterator::operator->());
+        }
+
+        /// @brief Prefix increment.
+        /// @note Incrementing the iterator over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator& operator++() noexcept
+        {
+            c_iterator::_increment();
+            return (*this);
+        }
+
+        /// @brief Postfix increment
+        /// @param  int empty parameter to guide overload resolution.
+        /// @note Incrementing the iterator over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator operator++(int)
+        {
+            auto temp(*this);
+            c_iterator::_increment();
+            return temp;
+        }
+
+        /// @brief Prefix decrement
+        /// @Details Constant complexity.
+        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
+        RING_BUFFER_CONSTEXPR _rBuf_iterator& operator--() noexcept
+        {
+            c_iterator::_decrement();
+            return(*this);
+        }
+
+        /// @brief Postfix decrement
+        /// @param  int empty parameter to guide overload resolution.
+        /// @details Constant complexity.
+        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
+        RING_BUFFER_CONSTEXPR _rBuf_iterator operator--(int)
+        {
+            auto temp(*this);
+            c_iterator::_decrement();
+            return temp;
+        }
+
+        /// @brief Moves iterator forward.
+        /// @param offset Amount of elements to move.
+        /// @note Moving the iterator beyond begin() or end() makes the iterator point to an invalid element (dereferencing is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator& operator+=(difference_type offset) noexcept
+        {
+            c_iterator::_advance(offset);
+            return (*this);
+        }
+
+        /// @brief Create a temporary iterator that has been moved forward by specified amount.
+        /// @param offset Amount of elements to move the iterator.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator operator+(const difference_type offset) const
+        {
+            _rBuf_iterator temp(*this);
+            return (temp += offset);
+        }
+
+        /// @brief Friend operator+. Creates a copy of an iterator which has been moved by given amount.
+        /// @param offset Amount of elements to move the iterator. 
+        /// @param iter Reference to base iterator.
+        /// @note Enables (n + a) expression, where n is a constant and a is iterator type.
+        /// @details Constant complexity.
+        friend RING_BUFFER_CONSTEXPR _rBuf_iterator operator+(const difference_type offset, const _rBuf_iterator& iter)
+        {
+            auto temp = iter;
+            temp += offset;
+            return temp;
+        }
+
+        /// @brief Decrement this iterator by offset.
+        /// @param offset The number of positions to move the iterator backward.
+        /// @return An iterator pointing to the element that is offset positions before the current element.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator& operator-=(const difference_type offset) noexcept
+        {
+            return (*this += -offset);
+        }
+
+        /// @brief Get iterator decremented by offset.
+        /// @param offset Signed amount to decrement from the iterator index.
+        /// @return An iterator pointing to an element that points to *this - offset.
+        /// @note If offset is such that the index of the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator operator-(const difference_type offset) const
+        {
+            _rBuf_iterator temp(*this);
+            return (temp -= offset);
+        }
+
+        /// @brief Decrement operator between two iterators.
+        /// @param other Other iterator.
+        /// @return Return the difference between the elements to what the iterators point to.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR difference_type operator-(const _rBuf_iterator& other) const noexcept
+        {
+            return (c_iterator::m_logicalIndex - other.c_iterator::m_logicalIndex);
+        }
+
+        /// @brief Index operator.
+        /// @param offset Signed offset from iterator index.
+        /// @return Return object pointer by the iterator with an offset.
+        /// @note If offset is such that the iterator is beyond end() or begin() this function has undefined behaviour.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR reference operator[](const difference_type offset) const noexcept
+        {
+            return *(*this + offset);
+        }
+
+        /// @brief Comparison operator < overload.
+        /// @param other iterator to compare.
+        /// @return true if others index is larger.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator<(const _rBuf_iterator& other) const noexcept
+        {
+            return (c_iterator::m_logicalIndex < other.c_iterator::m_logicalIndex);
+        }
+
+        /// @brief Comparison operator > overload.
+        /// @param other iterator to compare against.
+        /// @return True if others index is smaller.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator>(const _rBuf_iterator& other) const noexcept
+        {
+            return (c_iterator::m_logicalIndex > other.c_iterator::m_logicalIndex);
+        }
+
+        /// @brief Comparison <= overload.
+        /// @param other Other iterator to compare against.
+        /// @return True if other points to logically smaller or the same indexed element.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator<=(const _rBuf_iterator& other) const noexcept
+        {
+            return (c_iterator::m_logicalIndex <= other.c_iterator::m_logicalIndex);
+        }
+
+        /// @brief Comparison >= overload.
+        /// @param other Other iterator to compare against.
+        /// @return True if other points to logically larger or same indexed element.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR bool operator>=(const _rBuf_iterator& other) const noexcept
+        {
+            return (c_iterator::m_logicalIndex >= other.c_iterator::m_logicalIndex);
+        }
+
+        /// @brief Custom assingment operator overload.
+        /// @param index Logical index of the element to set the iterator to.
+        /// @note Undefined behaviour for negative index.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR _rBuf_iterator& operator=(const size_t index) noexcept
+        {
+            c_iterator::_advance(static_cast<difference_type>(index) - c_iterator::m_logicalIndex);
+            return (*this);
+        };
+
+        /// @brief Index getter.
+        /// @return Returns the index of the element this iterator is pointing to.
+        /// @details Constant complexity.
+        RING_BUFFER_CONSTEXPR difference_type getIndex() noexcept
+        {
+            return c_iterator::m_logicalIndex;
+        }
+    };
+
+
+    using iterator = _rBuf_iterator<ring_buffer>;
+    using const_iterator = _rBuf_const_iterator<ring_buffer>;
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// @brief Default constructor.
+    /// @post this->empty() == true.
+    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation.
+    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR ring_buffer() : ring_buffer(allocator_type())
+    {
+    }
+
+    /// @brief Constructs the container with a custom allocator.
+    /// @param alloc Custom allocator for the buffer.
+    /// @post this->empty() == true.
+    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
+    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR explicit ring_buffer(const allocator_type& alloc) : base(alloc, CapacityPolicy::fit(allocBuffer)), m_headIndex(0), m_tailIndex(0)
+    {
+    }
+
+    /// @brief Constructs the buffer to a given size with given values and optionally a custom allocator.
+    /// @param size Amount of elements to be initialized in the buffer.
+    /// @param val Reference to a value which the elements are initialized to.
+    /// @param alloc Custom allocator.
+    /// @pre T needs to satisfy CopyInsertable.
+    /// @post std::distance(begin(), end()) == size().
+    /// @note Allocates memory for count + allocBuffer elements.
+    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
+    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
+    /// @details Linear complexity in relation to amount of constructed elements (O(n)).
+    ring_buffer(size_type count, const_reference val, const allocator_type& alloc = allocator_type()) : base(alloc, CapacityPolicy::fit(count + allocBuffer)), m_headIndex(count), m_tailIndex(0)
+    {
+        std::uninitialized_fill_n(base::m_data, count, val);
+    }
+    
+    /// @brief Custom constructor. Initializes a buffer with count amount of default constructed value_type elements.
+    /// @param count amount of default constructed value_type elements.
+    /// @pre T must satisfy DefaultInsertable.
+    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
+    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
+    /// @details Linear complexity in relation to count (O(n)).
+    explicit ring_buffer(size_type count, const allocator_type& alloc = allocator_type()) : base(alloc, CapacityPolicy::fit(count + allocBuffer)), m_headIndex(count), m_tailIndex(0)
+    {
+        size_t first = 0;
+        size_t current = 0;
+
+        try
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                alloc_traits::construct(base::m_allocator, base::m_data + current);
+                current++;
+            }
+        }
+        catch (...)
+        {
+            for (; first != current; first++)
+            {
+                alloc_traits::destroy(base::m_allocator, base::m_data + first);
+            }
+            
+            m_headIndex = 0;
+
+            throw;
+        }
+    }
+
+    /// @brief Construct the buffer from range [begin,end).
+    /// @param beginIt Iterator to first element of range.
+    /// @param endIt Iterator pointing to past-the-last element of range.
+    /// @pre valye_type must satisfy CopyInsertable. InputIt must be deferencable to value_type, and incrementing rangeBegin (repeatedly) must reach rangeEnd. Otherwise behaviour is undefined.
+    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
+    /// @exception If any exception is thrown no memory is leaked and program remains in a valid state. (Basic exception guarantee).
+    /// @details Linear complexity in relation to the size of the range (O(n)).
+    /// @note Behavior is undefined if elements in range are not valid.
+    template<typename InputIt,typename = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::value_type,value_type>::value>>
+    ring_buffer(InputIt beginIt, InputIt endIt, const allocator_type& alloc = allocator_type())
+        : base(alloc, CapacityPolicy::fit(std::distance<InputIt>(beginIt,endIt) + allocBuffer)), m_headIndex(std::distance<InputIt>(beginIt, endIt)), m_tailIndex(0)
+    {
+        std::uninitialized_copy(beginIt, endIt, base::m_data);
+    }
+
+    /// @brief Initializer list contructor.
+    /// @param init Initializer list to initialize the buffer from.
+    /// @pre T must satisfy CopyInsertable.
+    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
+    /// @exception If any exception is thrown no memory is leaked and program remains in a valid state. (Basic exception guarantee).
+    /// @details Linear complexity in relation to initializer list size (O(n)).
+    ring_buffer(std::initializer_list<T> init) : ring_buffer(init.begin(),init.end())
+    {
+    }
+
+    /// @brief Copy constructor.
+    /// @param rhs Reference to a RingBuffer to create a copy from.
+    /// @pre T must meet CopyInsertable.
+    /// @post this == ring_buffer(rhs).
+    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
+    /// @note The copy starts with no dropped elements, fresh statistics and no hooks, none of them are copied from rhs.
+    /// @except If any exception is thrown, invariants are preserved.(Basic Exception Guarantee).
+    /// @details Linear complexity in relation to buffer size.
+    ring_buffer(const ring_buffer& rhs) 
+    : base(alloc_traits::select_on_container_copy_construction(rhs.m_allocator), rhs.capacity()), drop_counter(), stats_collector(), idle_counter(),
+        m_headIndex(rhs.size()), m_tailIndex(0)
+    {
+        std::uninitialized_copy(rhs.begin(), rhs.end(), base::m_data);
+    }
+
+    /// @brief Copy constructor with custom allocator.
+    /// @param rhs Reference to a RingBuffer to create a copy from.
+    /// @param alloc Allocator for the new buffer.
+    /// @pre T must meet CopyInsertable.
+    /// @post this == ring_buffer(rhs) but with a different allocator.
+    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
+    /// @note Like the copy constructor, the counters and hooks of rhs are not copied.
+    /// @except If any exception is thrown, invariants are preserved.(Basic Exception Guarantee).
+    /// @details Linear complexity in relation to buffer size.
+    ring_buffer(const ring_buffer& rhs, const allocator_type& alloc)
+        : base(alloc, rhs.m_capacity), drop_counter(), stats_collector(), idle_counter(), m_headIndex(rhs.size()), m_tailIndex(0)
+    {
+        std::uninitialized_copy(rhs.begin(), rhs.end(), base::m_data);
+    }
+
+    /// @brief Move constructor.
+    /// @param other Rvalue reference to other buffer.
+    /// @note If other stores its elements inline, they are relocated one by one and value_type's move constructor should not throw.
+    /// @details Constant complexity, linear in relation to size of the buffer for inline elements.
+    ring_buffer(ring_buffer&& other) noexcept : base(std::move(other)), drop_counter(other), stats_collector(std::move(other)), m_headIndex(std::exchange(other.m_headIndex, 0)), m_tailIndex(std::exchange(other.m_tailIndex,0)),
+        m_reallocations(std::exchange(other.m_reallocations, 0))
+    {
+        // The storage points to its own inline memory only if other's elements were inline.
+        if (base::isInline())
+        {
+            moveInline(other, has_inline_storage());
+        }
+    }
+
+    /// @brief Move constructor with different allocator.
+    /// @param other Rvalue reference to other buffer.
+    /// @param alloc Allocator for the new ring buffer.
+    /// @note If alloc compares equal to other's allocator the memory is taken over like in the move constructor. Otherwise the elements are relocated once
+    /// to memory allocated with alloc, with memcpy if value_type is trivially relocatable.
+    /// @throw Can throw std::bad_alloc, or something from value_type's move constructor if the allocators differ.
+    /// @exception If any exception is thrown, other is unchanged unless value_type's move constructor throws.
+    /// @details Constant complexity if the allocators are equal, otherwise linear in relation to buffer size.
+    ring_buffer(ring_buffer&& other, const allocator_type& alloc)
+        : base(alloc, alloc == other.m_allocator ? 0 : other.m_capacity), m_headIndex(0), m_tailIndex(0)
+    {
+        if (base::m_allocator == other.m_allocator)
+        {
+            takeStorage(other);
+        }
+        else
+        {
+            relocateFrom(other);
+        }
+    }
+
+    /// Destructor.
+    RING_BUFFER_CONSTEXPR ~ring_buffer()
+    {
+        destroy_elements();
+    }
+
+    /// @brief Inserts an element to the buffer.
+    /// @param pos Iterator where the the element should be inserted. 
+    /// @param value Value to insert.
+    /// @return iterator pointing to the inserted value.
+    /// @pre T must meet CopyInsertable. 
+    /// @note If there is capacity left, the element is inserted in place by moving the elements on the shorter side of pos, otherwise the buffer grows.
+    /// @throw Might throw std::bad_alloc, or something from T's copy constructor if not NoThrow.
+    /// @exception  If any exception is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplaceBase(pos.getIndex(), 1, value);
+    }
+
+    /// @brief Inserts an element to the buffer.
+    /// @param pos Iterator where the the element should be inserted
+    /// @param value Value to insert.
+    /// @return Iterator that pos to the inserted element.
+    /// @pre T must meet MoveInsertable.
+    /// @throw Might throw std::bad_alloc, or something from T's move/copy constructor.
+    /// @note If there is capacity left, the element is inserted in place by moving the elements on the shorter side of pos, otherwise the buffer grows.
+    /// @exception If any exception is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplaceBase(pos.getIndex(), 1, std::move(value));
+    }
+
+    /// @brief Inserts an element to the buffer.
+    /// @param pos Iterator where the the element should be inserted
+    /// @param count Amount of T elements to be inserted.
+    /// @param value Value to insert.
+    /// @pre T must meet the requirements of CopyInsertable.
+    /// @return Iterator that pos to the inserted element.
+    /// @throw Might throw std::bad_alloc, or something from T's copy constructor if not NoThrow.
+    /// @note If there is capacity left, the elements are inserted in place by moving the elements on the shorter side of pos, otherwise the buffer grows.
+    /// @exception  If any exception is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to inserted elements and the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    iterator insert(const_iterator pos, const size_type count, const value_type& value)
+    {
+        if(count == 0) return iterator(this, pos.getIndex());
+        return emplaceBase(pos.getIndex(), count, value);
+    }
+
+    /// @brief Inserts a range of elements into the buffer to a specific position.
+    /// @tparam InputIt Type of iterator for the range.
+    /// @param pos A valid dereferenceable iterator to the position where range will be inserted to.
+    /// @param sourceBegin Iterator to first element of the range.
+    /// @param sourceEnd Iterator past the last element of the range.
+    /// @return Returns an iterator to an element in the buffer which is copy of the first element in the range.
+    /// @pre T must meet requirements of CopyInsertable. Iterators must point to elements that are implicitly convertible to value_type and sourceEnd must be reachable from sourceBegin. Otherwise behavior is undefined.
+    /// @throw Can throw std::bad_alloc or something from value_types constructor and iterator operations. 
+    /// @note If there is capacity left, the range is inserted in place by moving the elements on the shorter side of pos, otherwise the buffer grows.
+    /// @exception If any exceptiong is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to inserted elements and the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    template <typename InputIt>
+    iterator insert(const_iterator pos, InputIt sourceBegin, InputIt sourceEnd)
+    {
+        if(std::distance(sourceBegin, sourceEnd) == 0) return iterator(this, pos.getIndex() );
+        return insertRangeBase(pos, sourceBegin, sourceEnd);
+    }
+
+    /// @brief Inserts initializer list into buffer to a specific position.
+    /// @param pos Iterator where the list will be inserted.
+    /// @param list Initiliazer list to insert.
+    /// @pre pos must be a valid dereferenceable iterator within the container. Otherwise behavior is undefined.
+    /// @return Returns Iterator to the first element inserted, or the element pointed by pos if the initializer list was empty.
+    /// @throw Can throw std::bad_alloc and something from value_types constructor.
+    /// @exception If any exceptiong is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to inserted elements and the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    iterator insert(const_iterator pos, std::initializer_list<T> list)
+    {   
+        if (list.size() == 0) return iterator(this, pos.getIndex());
+        return insertRangeBase(pos, list.begin(), list.end());
+    }
+
+    /// @brief Construct an element in place from arguments.
+    /// @param pos Iterator before which the new element will be constructed.
+    /// @param args Argument pack containing arguments to construct value_type element.
+    /// @return Returns an iterator pointing to the element constructed from args.
+    /// @pre T must meet EmplaceConstructible and MoveInsertable.
+    /// @post All iterators are invalidated. Pointers and references are invalidated on the side of pos that was moved. If more memory is allocated, pointers and references to all elements are invalidated.
+    /// @note If there is capacity left, the element is constructed in place by moving the elements on the shorter side of pos, otherwise the buffer grows.
+    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element.
+    /// @exception If any exception is thrown, the function does nothing (Strong exception guarantee).
+    /// @details Linear complexity in relation to the distance from pos to the closer end of the buffer, or to buffer size if memory is allocated.
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        return emplaceBase(pos.getIndex(), 1, std::forward<Args>(args)...);
+    }
+
+    /// @brief Constructs an element in place to front from argumets.
+    /// @param args Argument pack containing arguments to construct value_type element.
+    /// @pre value_type is EmplaceConstructible from args.
+    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element.
+    /// @exception If any exception is thrown, function has no effect. (Strong exception guarantee).
+    /// @note With an overwriting CapacityPolicy a full buffer drops its last element instead of allocating.
+    /// @details  Amortized constant complexity.
+    template<class... Args>
+    RING_BUFFER_CONSTEXPR void emplace_front(Args&&... args)
+    {
+        if (base::m_capacity < size() + allocBuffer)
+        {
+            if (CapacityPolicy::overwrites && base::m_capacity >= allocBuffer)
+            {
+                // The slot before the tail is the one free slot, construct there first so a throwing constructor has no effect.
+                auto newIndex = m_tailIndex;
+                decrement(newIndex);
+                alloc_traits::construct(base::m_allocator, base::m_data + newIndex, std::forward<Args>(args)...);
+                decrement(m_headIndex);
+                alloc_traits::destroy(base::m_allocator, base::m_data + m_headIndex);
+                m_tailIndex = newIndex;
+                drop_counter::addDrops(1);
+                stats_collector::countOverflows(1);
+                recordPushes(1);
+                return;
+            }
+
+            reallocateWithGap(nextCapacity(size() + allocBuffer), 0, 1, [&](pointer gap, size_type)
+            {
+                alloc_traits::construct(base::m_allocator, gap, std::forward<Args>(args)...);
+            });
+            recordPushes(1);
+            return;
+        }
+
+        // Decrement temporary index in case constructor throws to retain invariants (elements of the buffer are always initialized).
+        auto newIndex = m_tailIndex;
+        decrement(newIndex);
+        alloc_traits::construct(base::m_allocator, base::m_data + newIndex, std::forward<Args>(args)...);
+        m_tailIndex = newIndex;
+        recordPushes(1);
+    }
+
+    /// @brief Constructs an element in place to front from argumets.
+    /// @param args Argument pack containing arguments to construct value_type element.
+    /// @pre value_type is EmplaceConstructible from args.
+    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element.
+    /// @exception If any exception is thrown, function has no effect. (Strong exception guarantee).
+    /// @note With an overwriting CapacityPolicy a full buffer drops its first element instead of allocating.
+    /// @details Amortized constant complexity.
+    template<class... Args>
+    RING_BUFFER_CONSTEXPR void emplace_back(Args&&... args)
+    {
+        if (base::m_capacity < size() + allocBuffer)
+        {
+            if (CapacityPolicy::overwrites && base::m_capacity >= allocBuffer)
+            {
+                // The head is the one free slot, construct there first so a throwing constructor has no effect.
+                alloc_traits::construct(base::m_allocator, base::m_data + m_headIndex, std::forward<Args>(args)...);
+                alloc_traits::destroy(base::m_allocator, base::m_data + m_tailIndex);
+                increment(m_tailIndex);
+                increment(m_headIndex);
+                drop_counter::addDrops(1);
+                stats_collector::countOverflows(1);
+                recordPushes(1);
+                return;
+            }
+
+            reallocateWithGap(nextCapacity(size() + allocBuffer), size(), 1, [&](pointer gap, size_type)
+            {
+                alloc_traits::construct(base::m_allocator, gap, std::forward<Args>(args)...);
+            });
+            recordPushes(1);
+            return;
+        }
+
+        alloc_traits::construct(base::m_allocator, base::m_data + m_headIndex, std::forward<Args>(args)...);
+        increment(m_headIndex);
+        recordPushes(1);
+    }
+
+    /// @brief Erase an element at a given position.
+    /// @param pos Pointer to the element to be erased.
+    /// @pre value_type must be nothrow-MoveConstructible. pos must be a valid dereferenceable iterator within the container. Otherwise behavior is undefined.
+    /// @return Returns an iterator that was immediately following the ereased element. If the erased element was last in the buffer, returns a pointer to end().
+    /// @exception If value_type is nothrow_move_constructible and nothrow_move_assignable function is noexcept. Otherwise provides no exception guarantee at all.
+    /// @note The elements on the shorter side of pos are moved, so erasing near either end is fast. Iterators, pointers and references to the moved side are invalidated.
+    /// @details Linear Complexity in relation to the distance from pos to the closer end of the buffer.
+    iterator erase(const_iterator pos)
+    {
+        return eraseBase(pos, pos + 1);
+    }
+
+    /// @brief Erase the specified elements from the container according to the range [first,last). The elements on the shorter side of the range are move assigned over it, and the leftover elements at that end are destroyed.
+    /// @param first iterator to the first element to erase.
+    /// @param last iterator past the last element to erase.
+    /// @pre First and last must be valid iterators to *this.
+    /// @return Returns an iterator to the element that was immediately following the last erased elements. If last == end(), then new end() is returned.
+    /// @throw Possibly throws from value_types move/copy assignment operator if last != end().
+    /// @exception If value_type is nothrow_move_constructible and nothrow_move_assignable function is noexcept. Otherwisde provides no exception guarantee at all.
+    /// @details Linear Complexity in relation to size of the range, and then linear in the amount of elements on the shorter side of the range.
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return eraseBase(first, last);
+    }
+
+    /// @brief Destroys all elements in a buffer. Does not modify capacity.
+    /// @post All existing references, pointers and iterators are to be considered invalid.
+    /// @note If value_type is trivially destructible and the allocator does not customize destroy, no destructors are called and only the indices are reset.
+    /// @details Constant complexity for trivially destructible elements, otherwise linear complexity in relation to size of the buffer.
+    RING_BUFFER_CONSTEXPR void clear() noexcept
+    {
+        destroy_elements();
+
+        m_headIndex = 0;
+        m_tailIndex = 0;
+    }
+
+    /// @brief Replaces the elements in the buffer with copy of [sourceBegin, sourceEnd)
+    /// @param sourceBegin Iterator to beginning of the range.
+    /// @param sourceEnd Past the end iterator of the range.
+    /// @pre value_type is CopyInsertable and elements of [sourceBegin, sourceEnd) are not in *this. InputIt must be dereferenceable to value_type, and incrementing sourceBegin (repeatedly) must reach sourceEnd. Otherwise behaviour is undefined.
+    /// @post All existing references, pointers and iterators are to be considered invalid.
+    /// @throw Can throw std::bad_alloc or something from value_types constructor if not nothrow. 
+    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated, in case of any exception the function does nothing (Strong Exception Guarantee) 
+    /// @details Linear Complexity. Calls destructor for each element in buffer and CopyConstructor for the assigned range.
+    template <typename InputIt>
+    void assign(InputIt sourceBegin, InputIt sourceEnd)
+    {
+        size_type amount = std::distance(sourceBegin, sourceEnd);
+        if (base::m_capacity < amount + allocBuffer)
+        {
+            auto newCapacity = nextCapacity(amount + allocBuffer);
+            pointer newData = base::allocateStorage(newCapacity);
+            try
+            {
+                std::uninitialized_copy(sourceBegin, sourceEnd, newData);
+            }
+            catch (...)
+            {
+                base::deallocateStorage(newData, newCapacity);
+                throw;
+            }
+
+            const auto oldCapacity = base::m_capacity;
+            destroy_elements();
+            base::replaceStorage(newData, newCapacity);
+            recordReallocation(oldCapacity, 0);
+            m_headIndex = amount;
+            m_tailIndex = 0;
+
+            return;
+        }
+
+        clear();
+        std::uninitialized_copy(sourceBegin, sourceEnd, base::m_data);
+        m_headIndex = amount;
+    }
+
+    /// @brief Replaces the elements in the buffer with copy of the initializer list.
+    /// @param list Source of elements to assign.
+    /// @pre value_type is CopyInsertable.
+    /// @post All existing references, pointers and iterators are to be considered invalid.
+    /// @throw Can throw std::bad_alloc or something from value_types constructor if not nothrow. 
+    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated, in case of any exception the function does nothing (Strong Exception Guarantee) 
+    /// @details Linear Complexity. Calls destructor for each element in buffer and CopyConstructor for each element in the list.
+    void assign(std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+    }
+
+    /// @brief Replaces the elements in the buffer with given value.
+    /// @param amount Size of the buffer after the assignment.
+    /// @param value Value of all elements after the assignment.
+    /// @pre value_type is CopyInsertable.
+    /// @post All existing references, pointers and iterators are to be considered invalid.
+    /// @throw Can throw std::bad_alloc or from value_types constructor.
+    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated and exception is thrown, function has no effect (Strong exception guarantee)
+    /// @details Linear Complexity. Calls destructor for each element in buffer and amount times values constructor.
+    void assign(const size_type amount, const value_type& value)
+    {
+
+        if (base::m_capacity < amount + allocBuffer)
+        {
+            auto newCapacity = nextCapacity(amount + allocBuffer);
+            pointer newData = base::allocateStorage(newCapacity);
+            try
+            {
+                std::uninitialized_fill_n(newData, amount, value);
+            }
+            catch (...)
+            {
+                base::deallocateStorage(newData, newCapacity);
+                throw;
+            }
+
+            const auto oldCapacity = base::m_capacity;
+            destroy_elements();
+            base::replaceStorage(newData, newCapacity);
+            recordReallocation(oldCapacity, 0);
+            m_headIndex = amount;
+            m_tailIndex = 0;
+
+            return;
+        }
+        
+        clear();
+        std::uninitialized_fill_n(base::m_data, amount, value);
+        m_headIndex = amount;
+    }
+
+    /// @brief Copy assignment operator.
+    /// @param other Ringbuffer to be copy assigned.
+    /// @return Returns reference to the assignment target container.
+    /// @post *this == other. All iterators, pointers and references of the target container should be considered invalid. Does not guarantee that target containers capacity equals the original.
+    /// @throw Can throw std::bad_alloc or something from value_types constructor.
+    /// @exception If any exception is thrown, invariants are retained and no memory is leaked (Basic Exception Guarantee).
+    /// @details Linear complexity in relation to buffer size. 
+    ring_buffer& operator=(const ring_buffer& other)
+    {
+
+        if (this == &other) return *this;
+
+        if (alloc_traits::propagate_on_container_copy_assignment::value && (base::m_allocator != other.m_allocator))
+        {
+            auto temp = ring_buffer(other);
+
+            // Old memory is released with the old allocator before the allocator is replaced.
+            clear();
+            base::releaseStorage();
+            propagateAllocator(temp.m_allocator, typename alloc_traits::propagate_on_container_copy_assignment());
+            takeStorage(temp);
+        }
+        else
+        {
+            validateCapacity(other.size() - base::m_capacity);
+
+            auto targetSize = size();
+            auto sourceSize = other.size();
+
+            if (targetSize <= sourceSize)
+            {
+                std::copy(other.begin(), other.begin() + targetSize, begin());
+                for (size_type i = size(); i < sourceSize; i++)
+                {
+                    push_back(other[i]);
+                }
+            }
+            else
+            {
+                std::copy(other.begin(), other.end(), begin());
+                for (size_type i = sourceSize; i < targetSize; i++)
+                {
+                    pop_back();
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    /// @brief Move assignment operator.
+    /// @param other Rvalue ref to other buffer.
+    /// @pre value_type is MoveConstructible.
+    /// @post *this has values other had before the assignment.
+    /// @return Reference to the buffer to move from.
+    /// @note If the allocator does not propagate and the allocators differ, the elements are relocated once to this buffer's memory, with memcpy if value_type is
+    /// trivially relocatable. The memory is reused if it is large enough.
+    /// @throw Can throw std::bad_alloc, or something from value_type's move constructor, only if the allocator does not propagate and the allocators differ.
+    /// @exception If an exception is thrown the buffer is left empty and other is unchanged unless value_type's move constructor throws.
+    /// @details Constant complexity, linear in relation to size of the buffers if the elements are relocated.
+    ring_buffer& operator=(ring_buffer&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+    {
+        if (!alloc_traits::propagate_on_container_move_assignment::value && base::m_allocator != other.m_allocator)
+        {
+            clear();
+            if (base::m_capacity < other.size() + allocBuffer)
+            {
+                const auto oldCapacity = base::m_capacity;
+                auto newCapacity = other.m_capacity;
+                pointer newData = base::allocateStorage(newCapacity);
+                base::replaceStorage(newData, newCapacity);
+                recordReallocation(oldCapacity, 0);
+            }
+            stats_collector::countRelocation(0, 0, other.size() * sizeof(T));
+            relocateFrom(other);
+        }
+        else
+        {
+            ring_buffer temp(std::move(other));
+            temp.swap(*this);
+        }
+
+        return *this;
+    }
+
+    /// @brief Initializer list assign operator. 
+    /// @param init Initializer list to assign to the buffer.
+    /// @return Returns a reference to the buffer.
+    /// @pre T is CopyInsertable.
+    /// @post All existing iterators are invalidated. 
+    /// @note Internally calls assign(), which destroys all elements before CopyInserting from initializer list.
+    /// @details Linear complexity in relation to amount of existing elements and size of initializer list.
+    ring_buffer& operator=(std::initializer_list<T> init)
+    {
+        assign(init);
+        return *this;
+    }
+
+    /// @brief Index operator.
+    /// @param logicalIndex Index of the element. If LogicalIndex >= size(), this function has undefined behaviour.
+    /// @details Constant complexity.
+    /// @note The operator acts as interface that hides the physical memory layout from the user. Logical index neeeds to be added to internal tail index to get actual element address. 
+    /// @return Returns a reference to the element.
+    RING_BUFFER_CONSTEXPR reference operator[](const size_type logicalIndex) noexcept
+    {
+        return base::m_data[CapacityPolicy::wrap(m_tailIndex + logicalIndex, base::m_capacity)];
+    }
+
+    /// @brief Index operator.
+    /// @param logicalIndex Index of the element used to access n:th element of the buffer.
+    /// @details Constant complexity
+    /// @note The operator acts as interface that hides the physical memory layout from the user. Logical index neeeds to be added to internal tail index to get actual element address.
+    /// @return Returns a const reference the the element ad logicalIndex.
+    RING_BUFFER_CONSTEXPR const_reference operator[](const size_type logicalIndex) const noexcept
+    {
+        return base::m_data[CapacityPolicy::wrap(m_tailIndex + logicalIndex, base::m_capacity)];
+    }
+
+    /// @brief Get a specific element of the buffer with bounds checking.
+    /// @param logicalIndex Index of the element.
+    /// @return Returns a reference the the element at index.
+    /// @throw Throws std::out_of_range if index is larger or equal to buffers size.
+    /// @exception If any exceptions is thrown this function has no effect (Strong exception guarantee).
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR reference at(size_type logicalIndex)
+    {
+        if(logicalIndex >= size())
+        {
+            throw std::out_of_range("Index is out of range");
+        }
+
+        return base::m_data[CapacityPolicy::advance(m_tailIndex, logicalIndex, base::m_capacity)];
+    }
+
+    /// @brief Get a specific element of the buffer.
+    /// @param logicalIndex Index of the element.
+    /// @return Returns a const reference the the element at index.
+    /// @throw Throws std::out_of_range if index is larger or equal to buffers size.
+    /// @exception If any exceptions is thrown this function has no effect (Strong exception guarantee).
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_reference at(size_type logicalIndex) const
+    {
+        if(logicalIndex >= size())
+        {
+            throw std::out_of_range("Index is out of range.");
+        }
+
+        return base::m_data[CapacityPolicy::advance(m_tailIndex, logicalIndex, base::m_capacity)];
+    }
+
+    /// @brief Member swap implementation. Swaps RingBuffers member to member.
+    /// @param other Reference to a ring_buffer to swap with.
+    /// @details Constant complexity.
+    /// @note Requires allocator_type to return true_type from propagate_on_container_swap, otherwise memory operations 
+    void swap(ring_buffer& other) noexcept
+    {
+        using std::swap;
+        if (base::isInline() || other.isInline())
+        {
+            // Inline elements can't be swapped by pointer, move them through a temporary instead.
+            ring_buffer temp(std::move(other));
+            other.takeStorage(*this);
+            takeStorage(temp);
+            drop_counter::swapDrops(other);
+            // temp took the statistics of other, so they reach this buffer in two swaps.
+            stats_collector::swapStats(other);
+            stats_collector::swapStats(temp);
+            // Likewise the move left other's reallocation count in temp.
+            other.m_reallocations = std::exchange(m_reallocations, temp.m_reallocations);
+            return;
+        }
+
+        swapAllocator(other, typename alloc_traits::propagate_on_container_swap());
+        swap(base::m_data, other.m_data);
+        swap(base::m_capacity, other.m_capacity);
+        swap(m_headIndex, other.m_headIndex);
+        swap(m_tailIndex, other.m_tailIndex);
+        drop_counter::swapDrops(other);
+        stats_collector::swapStats(other);
+        swap(m_reallocations, other.m_reallocations);
+    }
+
+    /// @brief Friend swap.
+    /// @param a Swap candidate.
+    /// @param b Swap candidate.
+    /// @details Constant complexity.
+    friend void swap(ring_buffer& a, ring_buffer& b) noexcept
+    {
+        a.swap(b);
+    }
+
+    /// @brief Sorts ringbuffer so that the elements are contiguous in physical memory.
+    /// @return Returns a pointer to the first element.
+    /// @pre T must meet MoveInsertable, or CopyInsertable.
+    /// @post data() == &this[0] and [data(), data() + size()) contains all elements.
+    /// @throw Can throw std::bad_alloc.
+    /// @exception If T's Move (or copy in case T does not provide Move Semantics) constructor throws, behaviour is undefined. Otherwise if exceptions are thrown (std::bad_alloc) this function has no effect (Strong exception guarantee).
+    /// @note If the elements are already contiguous, nothing is moved and pointers and references stay valid. Otherwise invalidates all existing pointers and references.
+    /// With mirrored storage the elements are always contiguous. Inline elements are rearranged in place without allocating, if value_type can be shifted without exceptions.
+    /// @details Constant complexity if the elements are already contiguous, otherwise linear complexity in relation to buffer size.
+    pointer data()
+    {
+        if(!size())
+        {
+            m_headIndex = 0;
+            m_tailIndex = 0;
+            return base::m_data;
+        }
+
+        if (m_tailIndex <= m_headIndex || base::is_mirrored)
+        {
+            return base::m_data + m_tailIndex;
+        }
+
+        // Inline storage has no second memory area to relocate to, and a static storage can't allocate one.
+        if (base::isInline() && is_nothrow_shiftable::value)
+        {
+            linearizeInPlace();
+            stats_collector::countLinearization();
+            return base::m_data;
+        }
+
+        reallocate(base::m_capacity);
+        stats_collector::countLinearization();
+        return base::m_data;
+    }
+
+    /// @brief Get the first contiguous segment of elements, from the first element towards the end of physical memory.
+    /// @return View to the elements in [tail, end of memory) or [tail, head) if the buffer does not wrap around.
+    /// @note Together array_one() and array_two() contain all elements of the buffer in logical order. Does not modify the buffer.
+    /// @details Constant complexity.
+    span array_one() noexcept
+    {
+        return span(base::m_data + m_tailIndex, firstSegmentSize());
+    }
+
+    /// @brief Get the first contiguous segment of elements, from the first element towards the end of physical memory.
+    /// @return Read-only view to the elements in [tail, end of memory) or [tail, head) if the buffer does not wrap around.
+    /// @details Constant complexity.
+    const_span array_one() const noexcept
+    {
+        return const_span(base::m_data + m_tailIndex, firstSegmentSize());
+    }
+
+    /// @brief Get the second contiguous segment of elements, which has wrapped around to the beginning of physical memory.
+    /// @return View to the elements in [beginning of memory, head), or an empty view if the buffer does not wrap around.
+    /// @details Constant complexity.
+    span array_two() noexcept
+    {
+        return span(base::m_data, size() - firstSegmentSize());
+    }
+
+    /// @brief Get the second contiguous segment of elements, which has wrapped around to the beginning of physical memory.
+    /// @return Read-only view to the elements in [beginning of memory, head), or an empty view if the buffer does not wrap around.
+    /// @details Constant complexity.
+    const_span array_two() const noexcept
+    {
+        return const_span(base::m_data, size() - firstSegmentSize());
+    }
+
+    /// @brief Get the first contiguous segment of unused memory, starting from the position of the next push_back().
+    /// @return View to uninitialized memory past the last element.
+    /// @note Together free_array_one() and free_array_two() contain capacity() - size() - 1 slots, one slot is always kept free. Use commit_back() to take written slots into use.
+    /// @details Constant complexity.
+    span free_array_one() noexcept
+    {
+        return span(base::m_data + m_headIndex, firstFreeSegmentSize());
+    }
+
+    /// @brief Get the second contiguous segment of unused memory, which wraps around to the beginning of physical memory.
+    /// @return View to uninitialized memory, or an empty view if the free memory does not wrap around.
+    /// @details Constant complexity.
+    span free_array_two() noexcept
+    {
+        return span(base::m_data, base::m_capacity - size() - 1 - firstFreeSegmentSize());
+    }
+
+    /// @brief Splits the elements into contiguous chunks of about count elements, for handing them to several threads.
+    /// @param count Minimum amount of elements per chunk, greater than 0.
+    /// @return Chunks in logical order. No chunk crosses the physical end of the memory.
+    /// @note Each chunk is extended to end on a cache line boundary, so that no two chunks share a cache line and every chunk except the first one
+    /// of each segment starts on a cache line. Only the last chunk of each segment can be shorter than count.
+    /// @details Linear complexity in relation to the amount of chunks.
+    std::vector<span> chunks(size_type count)
+    {
+        std::vector<span> result;
+        appendChunks(result, array_one(), count);
+        appendChunks(result, array_two(), count);
+        return result;
+    }
+
+    /// @brief Splits the elements into contiguous read-only chunks of about count elements. See chunks().
+    std::vector<const_span> chunks(size_type count) const
+    {
+        std::vector<const_span> result;
+        appendChunks(result, array_one(), count);
+        appendChunks(result, array_two(), count);
+        return result;
+    }
+
+    /// @brief Splits the elements into about parts contiguous chunks of equal size. See chunks().
+    /// @param parts Amount of chunks wanted.
+    /// @return At most parts chunks if the elements don't wrap around, at most parts + 1 if they do. Empty if the buffer is empty or parts is 0.
+    std::vector<span> partition(size_type parts)
+    {
+        return parts && !empty() ? chunks((size() + parts - 1) / parts) : std::vector<span>();
+    }
+
+    /// @brief Splits the elements into about parts contiguous read-only chunks of equal size. See partition().
+    std::vector<const_span> partition(size_type parts) const
+    {
+        return parts && !empty() ? chunks((size() + parts - 1) / parts) : std::vector<const_span>();
+    }
+
+    /// @brief Takes count slots from the free segments into use as the last elements of the buffer.
+    /// @param count Amount of slots written through free_array_one() and free_array_two().
+    /// @pre T must be trivially copyable and count <= capacity() - size() - 1. The slots must have been written, otherwise behaviour is undefined.
+    /// @post size() is increased by count.
+    /// @details Constant complexity.
+    void commit_back(size_type count) noexcept
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "commit_back requires a trivially copyable value_type");
+        m_headIndex = CapacityPolicy::advance(m_headIndex, count, base::m_capacity);
+        recordPushes(count);
+    }
+
+    /// @brief Finds the first element equal to value.
+    /// @param value Value to search for.
+    /// @return Iterator to the first element equal to value, or end() if there is none.
+    /// @note Searches each contiguous segment through a pointer, with memchr for single byte elements that are bitwise comparable.
+    /// @details Linear complexity in relation to size of the buffer.
+    iterator find(const value_type& value)
+    {
+        return begin() + static_cast<difference_type>(findIndex(value));
+    }
+
+    /// @brief Finds the first element equal to value.
+    /// @param value Value to search for.
+    /// @return const_iterator to the first element equal to value, or end() if there is none.
+    /// @details Linear complexity in relation to size of the buffer.
+    const_iterator find(const value_type& value) const
+    {
+        return begin() + static_cast<difference_type>(findIndex(value));
+    }
+
+    /// @brief Counts the elements equal to value.
+    /// @param value Value to count.
+    /// @return Amount of elements equal to value.
+    /// @note Counts each contiguous segment through a pointer, which the compiler can vectorize for arithmetic types.
+    /// @details Linear complexity in relation to size of the buffer.
+    size_type count(const value_type& value) const
+    {
+        const auto first = array_one();
+        const auto second = array_two();
+        return static_cast<size_type>(std::count(first.begin(), first.end(), value) + std::count(second.begin(), second.end(), value));
+    }
+
+    /// @brief Checks if the buffer holds an element equal to value.
+    /// @param value Value to search for.
+    /// @return True if an element equal to value is found.
+    /// @details Linear complexity in relation to size of the buffer.
+    bool contains(const value_type& value) const
+    {
+        return findIndex(value) != size();
+    }
+
+    /// @brief Gets the size of the container.
+    /// @return Size of buffer.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR size_type size() const noexcept
+    {
+        return CapacityPolicy::distance(m_tailIndex, m_headIndex, base::m_capacity);
+    }
+
+    /// @brief Gets the theoretical maximum size of the container.
+    /// @return Maximum size of the buffer.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR size_type max_size() const noexcept
+    {
+        constexpr auto maxSize = std::numeric_limits<std::size_t>::max();
+        return maxSize / sizeof(T);
+    }
+
+    /// @brief Capacity getter.
+    /// @return m_capacity Returns how many elements have been allocated for the buffers use. 
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR size_type capacity() const noexcept
+    {
+        return base::m_capacity;
+    }
+
+    /// @brief Allocator getter.
+    /// @return Return the allocator used by the container.
+    /// @details Constant complexity.
+    allocator_type get_allocator() const noexcept
+    {
+        return base::m_allocator;
+    }
+
+    /// @brief Amount of elements overwritten by a full buffer.
+    /// @return Amount of dropped elements since construction or the last reset_dropped(). Always 0 unless CapacityPolicy overwrites.
+    /// @details Constant complexity.
+    size_type dropped() const noexcept
+    {
+        return drop_counter::getDrops();
+    }
+
+    /// @brief Resets the dropped() counter to zero.
+    void reset_dropped() noexcept
+    {
+        drop_counter::clearDrops();
+    }
+
+    /// @brief Amount of times the buffer has allocated a new memory area for its elements, either to grow, to reserve or to shrink.
+    /// @return Amount of reallocations since construction or the last reset_reallocations(). Moving the buffer transfers the count.
+    /// @note Useful for tuning the growth of CapacityPolicy, see growth_capacity_policy.
+    /// @details Constant complexity.
+    size_type reallocations() const noexcept
+    {
+        return m_reallocations;
+    }
+
+    /// @brief Resets the reallocations() counter to zero.
+    void reset_reallocations() noexcept
+    {
+        m_reallocations = 0;
+    }
+
+    /// @brief Capacity of the retired memory kept for the next reallocation.
+    /// @return Amount of elements the spare has room for, 0 if there is none.
+    /// @pre CapacityPolicy keeps a spare, see spare_capacity_policy.
+    size_type spare_capacity() const noexcept
+    {
+        static_assert(std::is_same<base, spare_ring_buffer_base<T, Allocator>>::value, "spare_capacity requires a capacity policy that keeps a spare, see spare_capacity_policy");
+        return base::m_spareCapacity;
+    }
+
+    /// @brief Deallocates the retired memory kept for the next reallocation, for example before a long idle period.
+    /// @pre CapacityPolicy keeps a spare, see spare_capacity_policy.
+    void release_spare() noexcept
+    {
+        static_assert(std::is_same<base, spare_ring_buffer_base<T, Allocator>>::value, "release_spare requires a capacity policy that keeps a spare, see spare_capacity_policy");
+        base::releaseSpare();
+    }
+
+    /// @brief Counters of growth, relocation and traffic of the buffer.
+    /// @return Statistics since construction or the last reset_statistics(). All zero unless CapacityPolicy collects statistics, see stats_capacity_policy.
+    /// @note Copies of a buffer start with fresh statistics, moving and swapping transfer them together with the hooks.
+    /// @details Constant complexity.
+    ring_buffer_statistics statistics() const noexcept
+    {
+        return stats_collector::getStats();
+    }
+
+    /// @brief Resets all statistics() counters to zero. The hooks stay set.
+    void reset_statistics() noexcept
+    {
+        stats_collector::clearStats();
+    }
+
+    /// @brief Sets a function called each time the buffer has moved its elements to a larger memory area, with the old and the new capacity.
+    /// @param hook Function taking (size_type oldCapacity, size_type newCapacity), or an empty function to remove the hook.
+    /// @pre CapacityPolicy collects statistics, see stats_capacity_policy. hook must not throw or modify the buffer, it is called from inside the growing operation
+    /// once the buffer is consistent again, and an exception terminates the program.
+    void on_growth(std::function<void(size_type, size_type)> hook) noexcept
+    {
+        static_assert(CapacityPolicy::collects_stats, "on_growth requires a capacity policy that collects statistics, see stats_capacity_policy");
+        stats_collector::setGrowthHook(std::move(hook));
+    }
+
+    /// @brief Sets a function called each time an overwriting buffer drops elements, with the amount of dropped elements.
+    /// @param hook Function taking (size_type dropped), or an empty function to remove the hook.
+    /// @pre CapacityPolicy collects statistics, see stats_capacity_policy. hook must not throw or modify the buffer, an exception terminates the program.
+    /// @note Only overwriting policies drop elements, e.g. stats_capacity_policy<overwrite_capacity_policy<>>. Bulk appends call the hook once per append.
+    void on_overflow(std::function<void(size_type)> hook) noexcept
+    {
+        static_assert(CapacityPolicy::collects_stats, "on_overflow requires a capacity policy that collects statistics, see stats_capacity_policy");
+        stats_collector::setOverflowHook(std::move(hook));
+    }
+
+    /// @brief Check if buffer is empty
+    /// @return True if buffer is empty
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR bool empty() const noexcept
+    {
+        return m_tailIndex == m_headIndex;
+    }
+
+    /// @brief Allocates memory and copies the existing buffer to the new memory location. Can be used to increase or decrease capacity.
+    /// @throw Throws std::bad_alloc if there is not enough memory for allocation. Throws std::bad_array_new_lenght if std::numeric_limits<std::size_t>::max() / sizeof(T) < newsize.
+    /// @param newCapacity Amount of memory to allocate. If newCapacity is less than or equal to m_capacity, function does nothing.
+    /// @param enableShrink True to enable reserve to reduce the capacity, to a minimum of size() +2.
+    /// @pre T must meet MoveInsertable.
+    /// @throw Can throw std::bad_alloc. 
+    /// @exception Elements are moved if T's move constructor is noexcept, otherwise copied. If a noexcept-less move constructor of a non-copyable T throws, behaviour is undefined. Otherwise Stong Exception Guarantee.
+    /// @note All references, pointers and iterators are invalidated. If memory is allocated, the memory layout is rotated so that first element matches the beginning of physical memory.
+    /// @details Linear complexity in relation to size of the buffer (O(n)).
+    void reserve(size_type newCapacity, bool enableShrink = false)
+    {
+        newCapacity = CapacityPolicy::fit(newCapacity);
+
+        if (enableShrink)
+        {
+            if (newCapacity < size() + allocBuffer || newCapacity >= base::m_capacity) return;
+            // Inline storage can't shrink any further.
+            if (base::isInline() && newCapacity <= base::inline_capacity) return;
+        }
+        else
+        {
+            if (newCapacity <= base::m_capacity) return;
+        }
+
+        reallocate(newCapacity);
+    }
+
+    /// @brief Inserts an element in the back of the buffer. 
+    /// @note If buffer would get full after the operation, function allocates more memory.
+    /// @throw Can throw std::bad_alloc.
+    /// @param val Element to insert.
+    /// @pre T must satisfy CopyInsertable.
+    /// @post All iterators are invalidated. If more memory is allocated, all pointers and references are invalidated.
+    /// @exception If the copy constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
+    /// @details Amortized constant complexity.
+    RING_BUFFER_CONSTEXPR void push_front(const value_type& val)
+    {
+        emplace_front(val);
+    }
+
+    /// @brief Inserts an element in the back of the buffer by move if move constructor is provided by value_type.
+    /// @note If buffer would get full after the operation, allocates more memory.
+    /// @throw Can throw std::bad_alloc.
+    /// @param val Rvalue reference to the element to insert.
+    /// @pre value_type needs to satisfy MoveInsertable.
+    /// @post All iterators are invalidated. If more memory is allocated, all pointers and references are invalidated.
+    /// @exception If the move constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
+    /// @details Amortized constant complexity.
+    RING_BUFFER_CONSTEXPR void push_front(value_type&& val)
+    {
+        emplace_front(std::move(val));
+    }
+
+    /// @brief Inserts an element in the back of the buffer.
+    /// @param val Value of T to be appended.
+    /// @note If buffer would get full after the operation, allocates more memory.
+    /// @throw Can throw std::bad_alloc.
+    /// @exception If the copy constructor of value_type throws, behaviour is undefined. Otherwise in case of exception this function has no effect (Strong Exception Guarantee).
+    /// @pre value_type must satisfy CopyInsertable.
+    /// @post If more memory is allocated all pointers, iterators and references are invalidated.
+    /// @details Amoprtized constant complexity.
+    RING_BUFFER_CONSTEXPR void push_back(const value_type& val)
+    {
+        emplace_back(val);
+    }
+
+    /// @brief Inserts an element in the back of the buffer by move if move constructor is provided for value_type.
+    /// @note  If buffer would get full after the operation more memory is allocated.
+    /// @param val Rvalue reference to the value to be appended.
+    /// @throw Can throw std::bad_alloc.
+    /// @exception If the move/copy constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
+    /// @pre value_type needs to satisfy MoveInsertable.
+    /// @post If more memory is allocated all pointers, iterators and references are invalidated.
+    /// @details Amortized constant complexity.
+    RING_BUFFER_CONSTEXPR void push_back(value_type&& val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    /// @brief Remove the first element in the buffer.
+    /// @pre Buffers size > 0, otherwise behaviour is undefined.
+    /// @post All iterators, pointers and references are invalidated.
+    /// @note If CapacityPolicy shrinks idle buffers, like hysteresis_capacity_policy, the pop may reallocate the buffer to a smaller memory area.
+    /// @details Constant complexity, linear in relation to buffer size if the buffer is shrunk.
+    RING_BUFFER_CONSTEXPR void pop_front() noexcept
+    {
+        alloc_traits::destroy(base::m_allocator, base::m_data + m_tailIndex);
+        increment(m_tailIndex);
+        stats_collector::countPops(1);
+        shrinkIfIdle(shrinks_when_idle());
+    }
+
+    /// @brief Erase an element from the logical back of the buffer.
+    /// @pre Buffers size > 0, otherwise behaviour is undefined.
+    /// @post All pointers and references are invalidated. Iterators persist except end() - 1 iterator is invalidated (it becomes new past-the-last iterator),
+    /// unless CapacityPolicy shrinks idle buffers and the pop reallocates the buffer, which invalidates all iterators.
+    /// @details Constant complexity, linear in relation to buffer size if the buffer is shrunk.
+    RING_BUFFER_CONSTEXPR void pop_back() noexcept
+    {
+        decrement(m_headIndex);
+        alloc_traits::destroy(base::m_allocator, base::m_data + m_headIndex);
+        stats_collector::countPops(1);
+        shrinkIfIdle(shrinks_when_idle());
+    }
+
+    /// @brief Appends the elements of range [first, last) to the back of the buffer.
+    /// @tparam InputIt Type of the source iterator.
+    /// @param first Iterator to the first element of the range.
+    /// @param last Iterator past the last element of the range.
+    /// @pre value_type must satisfy CopyInsertable. The range must not be part of *this.
+    /// @note For forward iterators the buffer grows at most once and the elements are copied per contiguous segment, with memcpy if value_type is trivially copyable.
+    /// @post If more memory is allocated all pointers, iterators and references are invalidated.
+    /// @throw Can throw std::bad_alloc, or something from value_type's copy constructor.
+    /// @exception If any exception is thrown, this function has no effect on the elements (Strong exception guarantee), but capacity might have grown.
+    /// With an overwriting CapacityPolicy the oldest elements are dropped to make room before the range is copied, so if value_type's copy constructor throws
+    /// they stay dropped while none of the range is added (Basic exception guarantee).
+    /// @details Linear complexity in relation to the size of the range.
+    template<typename InputIt, typename = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::value_type, value_type>::value>>
+    void push_back_n(InputIt first, InputIt last)
+    {
+        pushBackRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    /// @brief Appends count elements from a contiguous array to the back of the buffer.
+    /// @param source Pointer to the first element of the array.
+    /// @param count Amount of elements to append.
+    /// @pre value_type must satisfy CopyInsertable. The array must not be part of *this.
+    /// @note The buffer grows at most once and the elements are copied per contiguous segment, with memcpy if value_type is trivially copyable.
+    /// @throw Can throw std::bad_alloc, or something from value_type's copy constructor.
+    /// @exception If any exception is thrown, this function has no effect on the elements (Strong exception guarantee), but capacity might have grown.
+    /// Only the basic guarantee holds for an overwriting CapacityPolicy, see push_back_n().
+    /// @details Linear complexity in relation to count.
+    void append(const_pointer source, size_type count)
+    {
+        pushBackRange(source, source + count, std::random_access_iterator_tag());
+    }
+
+    /// @brief Removes count elements from the front of the buffer.
+    /// @param count Amount of elements to remove.
+    /// @pre count <= size(), otherwise behaviour is undefined.
+    /// @post All iterators, pointers and references to the removed elements are invalidated. If CapacityPolicy shrinks idle buffers the call counts as one pop
+    /// and may reallocate the buffer, which invalidates all iterators, pointers and references.
+    /// @details Constant complexity if value_type is trivially destructible, otherwise linear in relation to count. The tail index is moved once.
+    /// Linear in relation to buffer size if the buffer is shrunk.
+    void pop_front_n(size_type count) noexcept
+    {
+        destroySegments(0, count);
+        increment(m_tailIndex, count);
+        stats_collector::countPops(count);
+        shrinkIfIdle(shrinks_when_idle());
+    }
+
+    /// @brief Discards count elements from the front of the buffer, for example everything older than a given element.
+    /// @param count Amount of elements to discard.
+    /// @pre count <= size(), otherwise behaviour is undefined.
+    /// @post All iterators, pointers and references to the discarded elements are invalidated, or all of them if the buffer is shrunk like in pop_front_n().
+    /// @note The elements are destroyed per contiguous segment. If value_type is trivially destructible no destructors are called and the function only moves the tail index.
+    /// @details Constant complexity if value_type is trivially destructible, otherwise linear in relation to count.
+    void advance_front(size_type count) noexcept
+    {
+        pop_front_n(count);
+    }
+
+    /// @brief Discards count elements from the back of the buffer.
+    /// @param count Amount of elements to discard.
+    /// @pre count <= size(), otherwise behaviour is undefined.
+    /// @post All iterators, pointers and references to the discarded elements, and the end() iterator, are invalidated. If CapacityPolicy shrinks idle buffers
+    /// the call counts as one pop and may reallocate the buffer, which invalidates all iterators, pointers and references.
+    /// @note The elements are destroyed per contiguous segment. If value_type is trivially destructible no destructors are called and the function only moves the head index.
+    /// @details Constant complexity if value_type is trivially destructible, otherwise linear in relation to count. Linear in relation to buffer size if the buffer is shrunk.
+    void drop_back(size_type count) noexcept
+    {
+        decrement(m_headIndex, count);
+        destroySlots(m_headIndex, count);
+        stats_collector::countPops(count);
+        shrinkIfIdle(shrinks_when_idle());
+    }
+
+    /// @brief Moves count elements from the front of the buffer to out and removes them from the buffer.
+    /// @tparam OutputIt Type of the output iterator.
+    /// @param out Iterator to the beginning of the destination range. The destination must hold count constructed elements.
+    /// @param count Amount of elements to consume.
+    /// @return Iterator past the last element written.
+    /// @pre count <= size(), otherwise behaviour is undefined. value_type must satisfy MoveAssignable.
+    /// @note Elements are moved per contiguous segment, with memcpy if value_type is trivially copyable and out is a pointer.
+    /// @throw Might throw something from value_type's move assignment.
+    /// @exception If any exception is thrown, no elements are removed from the buffer but some might be in a moved-from state (Basic exception guarantee).
+    /// @post The elements are removed with pop_front_n(), which may shrink the buffer.
+    /// @details Linear complexity in relation to count.
+    template<typename OutputIt>
+    OutputIt consume(OutputIt out, size_type count)
+    {
+        const auto firstCount = std::min(count, firstSegmentSize());
+        out = moveSegment(base::m_data + m_tailIndex, firstCount, out, std::is_trivially_copyable<T>());
+        out = moveSegment(base::m_data, count - firstCount, out, std::is_trivially_copyable<T>());
+        pop_front_n(count);
+        return out;
+    }
+
+    /// @brief Hands count elements from the front of the buffer to f one contiguous segment at a time, then removes them.
+    /// @tparam Function Callable with a span, for example void(span).
+    /// @param count Amount of elements to consume.
+    /// @param f Function called with at most two spans, the oldest elements first. Empty segments are skipped.
+    /// @return f, like std::for_each.
+    /// @pre count <= size(), otherwise behaviour is undefined. f must not add or remove elements.
+    /// @note The elements are destroyed and the tail index is moved once for the whole batch, so a loop over the span in f can be unrolled and vectorized.
+    /// @exception If f throws, no elements are removed from the buffer.
+    /// @post The elements are removed with pop_front_n(), which may shrink the buffer.
+    /// @details Linear complexity in relation to count, plus the cost of f.
+    template<typename Function>
+    Function consume_front(size_type count, Function f)
+    {
+        const auto firstCount = std::min(count, firstSegmentSize());
+        if (firstCount)
+        {
+            f(span(base::m_data + m_tailIndex, firstCount));
+        }
+        if (count > firstCount)
+        {
+            f(span(base::m_data, count - firstCount));
+        }
+        pop_front_n(count);
+        return f;
+    }
+
+    /// @brief Hands count elements from the back of the buffer to f one contiguous segment at a time, then removes them.
+    /// @tparam Function Callable with a span, for example void(span).
+    /// @param count Amount of elements to consume.
+    /// @param f Function called with at most two spans, the segment holding the newest elements first. Empty segments are skipped.
+    /// @return f, like std::for_each.
+    /// @pre count <= size(), otherwise behaviour is undefined. f must not add or remove elements.
+    /// @note Within a span the elements are in buffer order, iterate it in reverse for strict LIFO order. The elements are destroyed and the head index is moved once for the whole batch.
+    /// @exception If f throws, no elements are removed from the buffer.
+    /// @post The elements are removed with drop_back(), which may shrink the buffer.
+    /// @details Linear complexity in relation to count, plus the cost of f.
+    template<typename Function>
+    Function consume_back(size_type count, Function f)
+    {
+        const auto firstSize = firstSegmentSize();
+        const auto secondSize = size() - firstSize;
+        const auto secondCount = std::min(count, secondSize);
+        if (secondCount)
+        {
+            f(span(base::m_data + (secondSize - secondCount), secondCount));
+        }
+        if (count > secondCount)
+        {
+            const auto firstCount = count - secondCount;
+            f(span(base::m_data + m_tailIndex + (firstSize - firstCount), firstCount));
+        }
+        drop_back(count);
+        return f;
+    }
+
+    /// @brief Writes the buffer to out as a small header followed by the elements from front to back.
+    /// @tparam Out Output with write(const char*, count) like std::ostream::write.
+    /// @param out Destination. Write errors are left to out to report, like with std::ostream.
+    /// @note Trivially copyable elements are written as raw bytes with one write per contiguous segment, others one at a time with ring_buffer_serializer<T>::write.
+    /// The data has the byte order and element layout of the machine that wrote it. Does not modify the buffer.
+    /// @throw Can throw something from out or ring_buffer_serializer<T>::write.
+    /// @details Linear complexity in relation to size of the buffer.
+    template<typename Out>
+    void serialize(Out& out) const
+    {
+        const _serial_header header = { _serial_header::magic, static_cast<std::uint32_t>(std::is_trivially_copyable<T>::value ? sizeof(T) : 0), size() };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        serializeElements(out, std::is_trivially_copyable<T>());
+    }
+
+    /// @brief Constructs a buffer from the data written by serialize().
+    /// @tparam In Input with read(char*, count) like std::istream::read, whose result converts to false once a read falls short.
+    /// @param in Source, read up to the end of the serialized buffer.
+    /// @param alloc Custom allocator.
+    /// @return Buffer holding the elements, with the capacity CapacityPolicy fits to them.
+    /// @note The storage is allocated once with its final capacity. Trivially copyable elements are read straight into it with a single read,
+    /// others are constructed from ring_buffer_serializer<T>::read one at a time without reallocating.
+    /// @throw Throws std::runtime_error if in holds no serialized buffer of value_type or ends too early, and std::length_error if the elements don't fit a fixed capacity.
+    /// Can throw std::bad_alloc, or something from ring_buffer_serializer<T>::read.
+    /// @exception When reading from memory with restore(), a size in the header larger than the remaining raw elements is rejected before anything is allocated.
+    /// @details Linear complexity in relation to the amount of elements.
+    template<typename In>
+    static ring_buffer deserialize(In& in, const allocator_type& alloc = allocator_type())
+    {
+        _serial_header header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header._magic != _serial_header::magic ||
+            header._elementSize != (std::is_trivially_copyable<T>::value ? sizeof(T) : 0) || header._size > std::numeric_limits<size_type>::max() / sizeof(T) - allocBuffer ||
+            (header._elementSize && header._size > _readableBytes(in) / header._elementSize))
+        {
+            throw std::runtime_error("ring_buffer: invalid serialized data");
+        }
+
+        const auto count = static_cast<size_type>(header._size);
+        ring_buffer result(base(alloc, CapacityPolicy::fit(count + allocBuffer)));
+        if (result.m_capacity <= count)
+        {
+            throw std::length_error("ring_buffer: serialized data exceeds the capacity");
+        }
+        result.deserializeElements(in, count, std::is_trivially_copyable<T>());
+        return result;
+    }
+
+    /// @brief Serializes the buffer into bytes, replacing their contents. Reusing the same vector avoids allocating for every snapshot.
+    /// @param bytes Destination, holds the output of serialize() afterwards.
+    /// @throw Can throw std::bad_alloc, or something from ring_buffer_serializer<T>::write.
+    /// @details Linear complexity in relation to size of the buffer.
+    void snapshot(std::vector<char>& bytes) const
+    {
+        bytes.clear();
+        bytes.reserve(sizeof(_serial_header) + (std::is_trivially_copyable<T>::value ? size() * sizeof(T) : 0));
+        _vector_writer writer{ bytes };
+        serialize(writer);
+    }
+
+    /// @brief Serializes the buffer into a new vector of bytes. See snapshot(std::vector<char>&).
+    std::vector<char> snapshot() const
+    {
+        std::vector<char> bytes;
+        snapshot(bytes);
+        return bytes;
+    }
+
+    /// @brief Constructs a buffer from bytes returned by snapshot().
+    /// @param data Pointer to the first byte.
+    /// @param count Amount of bytes.
+    /// @param alloc Custom allocator.
+    /// @throw See deserialize().
+    static ring_buffer restore(const char* data, size_type count, const allocator_type& alloc = allocator_type())
+    {
+        _memory_reader reader{ data, count, true };
+        return deserialize(reader, alloc);
+    }
+
+    /// @brief Constructs a buffer from bytes returned by snapshot(). See restore(const char*, size_type, const allocator_type&).
+    static ring_buffer restore(const std::vector<char>& bytes, const allocator_type& alloc = allocator_type())
+    {
+        return restore(bytes.data(), bytes.size(), alloc);
+    }
+
+    /// @brief Releases unused allocated memory. 
+    /// @pre T must satisfy MoveConstructible or CopyConstructible.
+    /// @post m_capacity == size() + allocBuffer, rounded up by CapacityPolicy. With inline storage, m_capacity is the inline capacity if the elements fit in it.
+    /// @note Reduces capacity by allocating a smaller memory area and moving the elements. Shrinking the buffer invalidates all pointers, iterators and references.
+    /// With inline storage, elements that fit are moved back inline and the allocated memory is released.
+    /// @throw Might throw std::bad_alloc if memory allocation fails.
+    /// @exception If T's move (or copy) constructor can and does throw, behaviour is undefined. If any other exception is thrown (bad_alloc) this function has no effect (Strong exception guarantee).
+    /// @details Linear complexity in relation to size of the buffer.
+    void shrink_to_fit()
+    {
+        reserve(size() + allocBuffer, true);
+    }
+
+//===========================================================
+//  std::queue adaptor functions
+//===========================================================
+
+    /// @brief Returns a reference to the first element in the buffer. Behaviour is undefined for empty buffer.
+    /// @return Reference to the first element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR reference front() noexcept
+    {
+        return base::m_data[m_tailIndex];
+    }
+
+    /// @brief Returns a reference to the first element in the buffer. Behaviour is undefined for empty buffer.
+    /// @return const_reference to the first element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_reference front() const noexcept
+    {
+        return base::m_data[m_tailIndex];
+    }
+
+    /// @brief Returns a reference to the last element in the buffer. Behaviour is undefined for empty buffer.
+    /// @return Reference to the last element in the buffer.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR reference back() noexcept
+    {
+        // Since head points to next-to-last element, it needs to be decremented once to get the correct element. 
+        // If the index is at the beginning border of the allocated memory area it needs to be wrapped around to the end. 
+        if (m_headIndex == 0)
+        {
+            return base::m_data[base::m_capacity - 1];
+        }
+        return base::m_data[m_headIndex-1];
+    }
+
+    /// @brief Returns a const-reference to the last element in the buffer. Behaviour is undefined for empty buffer.
+    /// @return const_reference to the last element in the buffer.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_reference back() const noexcept
+    {
+        // Since head points to next-to-last element, it needs to be decremented once to get the correct element. 
+        // If the index is at the beginning border of the allocated memory area it needs to be wrapped around to the end. 
+        if (m_headIndex == 0)
+        {
+            return base::m_data[base::m_capacity - 1];
+        }
+        return base::m_data[m_headIndex-1];
+    }
+
+    /// @brief Construct iterator at begin.
+    /// @return Iterator pointing to first element.
+    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
+    RING_BUFFER_CONSTEXPR iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    /// @brief Construct const_iterator at begin.
+    /// @return Const_iterator pointing to first element.
+    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
+    RING_BUFFER_CONSTEXPR const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    /// @brief Construct iterator at end.
+    /// @return Iterator pointing past last element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR iterator end() noexcept
+    {
+        return iterator(this, size());
+    }
+
+    /// @brief Construct const_iterator at end.
+    /// @return Const_iterator pointing past last element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_iterator end() const noexcept
+    {
+        return const_iterator(this, size());
+    }
+
+    /// @brief Construct const_iterator at begin.
+    /// @return Const_iterator pointing to first element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_iterator cbegin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    /// @brief Construct const_iterator pointing to past the last element.
+    /// @return Const_iterator pointing past last element.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR const_iterator cend() const noexcept
+    {
+        return const_iterator(this, size());
+    }
+
+    /// @brief Get a reverse iterator pointing to the first element in reverse order (last element in normal order).
+    /// @return reverse_iterator pointing to first element in reverse order.
+    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    /// @brief Get a const reverse iterator pointing to the first element in reverse order (last element in normal order).
+    /// @return const_reverse_iterator pointing to the first element in reverse order.
+    /// @details Constant complexity.
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /// @brief Get a const reverse iterator pointing to the first element in reverse order (last element in normal order).
+    /// @details Constant complexity.
+    /// @return const_reverse_iterator pointing to the first element in reverse order.
+    const_reverse_iterator crbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /// @brief Get a reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
+    /// @details Constant complexity.
+    /// @return reverse_iterator pointing to one past the last element in reverse order.
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    /// @brief Get a const reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
+    /// @details Constant complexity.
+    /// @return const_reverse_iterator pointing to one past the last element in reverse order.
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /// @brief Get a const reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
+    /// @details Constant complexity.
+    /// @return const_reverse_iterator pointing to one past the last element in reverse order.
+    const_reverse_iterator crend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+
+private:
+     
+    explicit ring_buffer(base&& rBufBase) : base(std::forward<base>(rBufBase)), m_headIndex(0), m_tailIndex(0)
+    {
+    }
+
+    /// @brief Writes the elements as raw bytes, one contiguous segment at a time.
+    template<typename Out>
+    void serializeElements(Out& out, std::true_type) const
+    {
+        const const_span segments[2] = { array_one(), array_two() };
+        for (const auto& segment : segments)
         {
-            return const_cast<pointer>(c_iterator::operator->());
+            if (!segment.empty())
+            {
+                out.write(reinterpret_cast<const char*>(segment.data()), static_cast<std::ptrdiff_t>(segment.size() * sizeof(T)));
+            }
         }
+    }
 
-        /// @brief Prefix increment.
-        /// @note Incrementing the iterator over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_iterator& operator++() noexcept
+    /// @brief Writes the elements one at a time through the customization point.
+    template<typename Out>
+    void serializeElements(Out& out, std::false_type) const
+    {
+        const const_span segments[2] = { array_one(), array_two() };
+        for (const auto& segment : segments)
         {
-            ++c_iterator::m_logicalIndex;
-            return (*this);
+            for (const auto& value : segment)
+            {
+                ring_buffer_serializer<T>::write(out, value);
+            }
         }
+    }
 
-        /// @brief Postfix increment
-        /// @param  int empty parameter to guide overload resolution.
-        /// @note Incrementing the iterator over the end() iterator leads to invalid iterator (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_iterator operator++(int)
+    /// @brief Reads count raw elements into the empty storage, which has room for them.
+    template<typename In>
+    void deserializeElements(In& in, size_type count, std::true_type)
+    {
+        if (count && !in.read(reinterpret_cast<char*>(base::m_data), static_cast<std::ptrdiff_t>(count * sizeof(T))))
         {
-            auto temp(*this);
-            ++c_iterator::m_logicalIndex;
-            return temp;
+            throw std::runtime_error("ring_buffer: serialized data ends early");
         }
+        m_headIndex = count;
+        recordPushes(count);
+    }
 
-        /// @brief Prefix decrement
-        /// @Details Constant complexity.
-        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
-        _rBuf_iterator& operator--() noexcept
+    /// @brief Constructs count elements from the customization point into the empty storage, which has room for them.
+    template<typename In>
+    void deserializeElements(In& in, size_type count, std::false_type)
+    {
+        for (size_type i = 0; i < count; i++)
         {
-            --c_iterator::m_logicalIndex;
-            return(*this);
+            emplace_back(ring_buffer_serializer<T>::read(in));
+        }
+        if (!in)
+        {
+            throw std::runtime_error("ring_buffer: serialized data ends early");
         }
+    }
 
-        /// @brief Postfix decrement
-        /// @param  int empty parameter to guide overload resolution.
-        /// @details Constant complexity.
-        /// @note Decrementing the iterator past begin() leads to invalid iterator (dereferencing is undefined behaviour).
-        _rBuf_iterator operator--(int)
+    /// @brief Destroys all elements one contiguous segment at a time. Does not move head or tail.
+    /// @details Constant complexity if destroying an element is a no-op, otherwise linear in relation to size of the buffer.
+    RING_BUFFER_CONSTEXPR void destroy_elements() noexcept
+    {
+        destroySegments(0, size());
+    }
+
+    /// @brief Address of the element at logicalIndex in physical memory. logicalIndex can be size() for the past-the-last position.
+    RING_BUFFER_CONSTEXPR pointer physicalAddress(size_type logicalIndex) const noexcept
+    {
+        return base::m_data + CapacityPolicy::advance(m_tailIndex, logicalIndex, base::m_capacity);
+    }
+
+    /// @brief Destroys count elements starting from logical index first, one contiguous segment at a time. Does not move head or tail.
+    RING_BUFFER_CONSTEXPR void destroySegments(size_type first, size_type count) noexcept
+    {
+        destroySlots(CapacityPolicy::advance(m_tailIndex, first, base::m_capacity), count);
+    }
+
+    /// @brief Copy constructs count elements from source to uninitialized memory at dest. Trivially copyable types from contiguous memory are copied with memcpy.
+    template<typename InputIt>
+    InputIt constructSegment(pointer dest, InputIt source, size_type count, std::false_type)
+    {
+        auto last = std::next(source, count);
+        std::uninitialized_copy(source, last, dest);
+        return last;
+    }
+
+    template<typename U>
+    U* constructSegment(pointer dest, U* source, size_type count, std::true_type) noexcept
+    {
+        if (count)
         {
-            auto temp(*this);
-            --c_iterator::m_logicalIndex;
-            return temp;
+            std::memcpy(dest, source, count * sizeof(T));
         }
+        return source + count;
+    }
 
-        /// @brief Moves iterator forward.
-        /// @param offset Amount of elements to move.
-        /// @note Moving the iterator beyond begin() or end() makes the iterator point to an invalid element (dereferencing is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_iterator& operator+=(difference_type offset) noexcept
+    /// @brief Moves count elements from source to out. Trivially copyable types to contiguous memory are copied with memcpy.
+    template<typename OutputIt, typename IsTrivial>
+    OutputIt moveSegment(pointer source, size_type count, OutputIt out, IsTrivial)
+    {
+        return std::move(source, source + count, out);
+    }
+
+    pointer moveSegment(pointer source, size_type count, pointer out, std::true_type) noexcept
+    {
+        if (count)
+        {
+            std::memcpy(out, source, count * sizeof(T));
+        }
+        return out + count;
+    }
+
+    /// @brief Appends a range of forward iterators. Grows at most once, then constructs the elements into the two free segments.
+    /// @note With an overwriting CapacityPolicy the oldest elements are dropped before copying, and only the last capacity() - 1 elements of a longer range are copied.
+    /// The dropped elements occupy the slots the range is copied to, so they can't be kept until the copies succeed.
+    template<typename ForwardIt>
+    void pushBackRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        const size_type total = std::distance(first, last);
+        size_type count = total;
+        if (count && base::m_capacity <= size() + count)
         {
-            if (offset < 0)
+            if (CapacityPolicy::overwrites && base::m_capacity >= allocBuffer)
             {
-                c_iterator::m_logicalIndex -= abs(offset);
+                const size_type maxSize = base::m_capacity - 1;
+                if (count > maxSize)
+                {
+                    std::advance(first, count - maxSize);
+                    count = maxSize;
+                }
+                const size_type drops = size() + count - maxSize;
+                destroySegments(0, drops);
+                increment(m_tailIndex, drops);
+                drop_counter::addDrops(drops + total - count);
+                stats_collector::countOverflows(drops + total - count);
             }
             else
             {
-                c_iterator::m_logicalIndex += offset;
+                reserve(nextCapacity(size() + count + allocBuffer));
             }
-            return (*this);
         }
 
-        /// @brief Create a temporary iterator that has been moved forward by specified amount.
-        /// @param offset Amount of elements to move the iterator.
-        /// @details Constant complexity.
-        _rBuf_iterator operator+(const difference_type offset) const
+        using is_memcpy = std::integral_constant<bool, std::is_trivially_copyable<T>::value && std::is_pointer<ForwardIt>::value
+            && std::is_same<std::remove_cv_t<std::remove_pointer_t<ForwardIt>>, T>::value>;
+
+        auto freeOne = free_array_one();
+        const auto firstCount = std::min(count, freeOne.size());
+        first = constructSegment(freeOne.data(), first, firstCount, is_memcpy());
+
+        try
         {
-            _rBuf_iterator temp(*this);
-            return (temp += offset);
+            constructSegment(base::m_data, first, count - firstCount, is_memcpy());
         }
-
-        /// @brief Friend operator+. Creates a copy of an iterator which has been moved by given amount.
-        /// @param offset Amount of elements to move the iterator. 
-        /// @param iter Reference to base iterator.
-        /// @note Enables (n + a) expression, where n is a constant and a is iterator type.
-        /// @details Constant complexity.
-        friend _rBuf_iterator operator+(const difference_type offset, const _rBuf_iterator& iter)
+        catch (...)
         {
-            auto temp = iter;
-            temp += offset;
-            return temp;
+            for (size_type i = 0; i < firstCount; ++i)
+            {
+                alloc_traits::destroy(base::m_allocator, freeOne.data() + i);
+            }
+            throw;
         }
 
-        /// @brief Decrement this iterator by offset.
-        /// @param offset The number of positions to move the iterator backward.
-        /// @return An iterator pointing to the element that is offset positions before the current element.
-        /// @details Constant complexity.
-        _rBuf_iterator& operator-=(const difference_type offset) noexcept
+        m_headIndex = CapacityPolicy::advance(m_headIndex, count, base::m_capacity);
+        recordPushes(total);
+    }
+
+    /// @brief Appends a range of single pass input iterators one element at a time.
+    template<typename InputIt>
+    void pushBackRange(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        for (; first != last; ++first)
         {
-            return (*this += -offset);
+            emplace_back(*first);
         }
+    }
 
-        /// @brief Get iterator decremented by offset.
-        /// @param offset Signed amount to decrement from the iterator index.
-        /// @return An iterator pointing to an element that points to *this - offset.
-        /// @note If offset is such that the index of the iterator is beyond end() or begin(), the return iterator is invalid (dereferencing it is undefined behaviour).
-        /// @details Constant complexity.
-        _rBuf_iterator operator-(const difference_type offset) const
+    /// @brief Amount of elements between the tail and the end of physical memory or the head, whichever comes first. With mirrored storage all elements are in the first segment.
+    size_type firstSegmentSize() const noexcept
+    {
+        if (base::is_mirrored)
         {
-            _rBuf_iterator temp(*this);
-            return (temp -= offset);
+            return size();
         }
+        return m_tailIndex <= m_headIndex ? m_headIndex - m_tailIndex : base::m_capacity - m_tailIndex;
+    }
 
-        /// @brief Decrement operator between two iterators.
-        /// @param other Other iterator.
-        /// @return Return the difference between the elements to what the iterators point to.
-        /// @details Constant complexity.
-        difference_type operator-(const _rBuf_iterator& other) const noexcept
+    /// @brief Amount of free slots between the head and the end of physical memory or the slot before the tail, whichever comes first. With mirrored storage all free slots are in the first segment.
+    size_type firstFreeSegmentSize() const noexcept
+    {
+        if (m_headIndex < m_tailIndex || base::is_mirrored)
         {
-            return (c_iterator::m_logicalIndex - other.c_iterator::m_logicalIndex);
+            return m_tailIndex - m_headIndex - 1;
         }
+        return m_tailIndex == 0 ? base::m_capacity - m_headIndex - 1 : base::m_capacity - m_headIndex;
+    }
 
-        /// @brief Index operator.
-        /// @param offset Signed offset from iterator index.
-        /// @return Return object pointer by the iterator with an offset.
-        /// @note If offset is such that the iterator is beyond end() or begin() this function has undefined behaviour.
-        /// @details Constant complexity.
-        reference operator[](const difference_type offset) const noexcept
+
+    /// @brief Relocates the elements of other to the beginning of this buffer's memory, constructing them with this buffer's allocator, and leaves other empty.
+    /// @pre This buffer holds no constructed elements and its capacity is greater than other.size().
+    /// @exception If an exception is thrown, nothing is constructed and other is unchanged unless value_type's move constructor throws.
+    void relocateFrom(ring_buffer& other)
+    {
+        const auto sz = other.size();
+        const auto firstCount = other.firstSegmentSize();
+
+        relocateSegment(other.m_data + other.m_tailIndex, firstCount, base::m_data, is_trivially_relocatable<T>());
+        try
         {
-            return const_cast<reference>(c_iterator::m_container->operator[](offset));
+            relocateSegment(other.m_data, sz - firstCount, base::m_data + firstCount, is_trivially_relocatable<T>());
         }
-
-        /// @brief Comparison operator < overload.
-        /// @param other iterator to compare.
-        /// @return true if others index is larger.
-        /// @details Constant complexity.
-        bool operator<(const _rBuf_iterator& other) const noexcept
+        catch (...)
         {
-            return (c_iterator::m_logicalIndex < other.c_iterator::m_logicalIndex);
+            destroyRange(base::m_data, firstCount);
+            throw;
         }
 
-        /// @brief Comparison operator > overload.
-        /// @param other iterator to compare against.
-        /// @return True if others index is smaller.
-        /// @details Constant complexity.
-        bool operator>(const _rBuf_iterator& other) const noexcept
+        other.releaseRelocated();
+        other.m_headIndex = 0;
+        other.m_tailIndex = 0;
+        m_tailIndex = 0;
+        m_headIndex = sz;
+    }
+
+    /// @brief Calculates the capacity to grow to. Grows according to CapacityPolicy, or to required if one step of growth is not enough.
+    /// @param required Minimum capacity needed.
+    /// @return New capacity that satisfies CapacityPolicy.
+    /// @throw Throws std::length_error if CapacityPolicy overwrites and required exceeds the pinned capacity.
+    /// @note An overwriting buffer without memory, for example a moved-from one, has no capacity pinned yet and allocates required like a growing buffer.
+    /// @details Constant complexity.
+    size_type nextCapacity(size_type required) const
+    {
+        if (CapacityPolicy::overwrites && base::m_capacity && required > base::m_capacity)
         {
-            return (c_iterator::m_logicalIndex > other.c_iterator::m_logicalIndex);
+            throw std::length_error("ring_buffer: operation exceeds the fixed capacity of an overwriting buffer");
         }
+        return CapacityPolicy::fit(std::max(CapacityPolicy::grow(base::m_capacity), required));
+    }
 
-        /// @brief Comparison <= overload.
-        /// @param other Other iterator to compare against.
-        /// @return True if other points to logically smaller or the same indexed element.
-        /// @details Constant complexity.
-        bool operator<=(const _rBuf_iterator& other) const noexcept
+    /// @brief Destroys count elements in contiguous memory starting from first.
+    RING_BUFFER_CONSTEXPR void destroyRange(pointer first, size_type count) noexcept
+    {
+        destroyRange(first, count, _trivial_destroy<Allocator>());
+    }
+
+    /// @brief Trivially destructible elements, destroyed through an allocator without a destroy of its own, need no destructor calls.
+    RING_BUFFER_CONSTEXPR void destroyRange(pointer, size_type, std::true_type) noexcept
+    {
+    }
+
+    RING_BUFFER_CONSTEXPR void destroyRange(pointer first, size_type count, std::false_type) noexcept
+    {
+        for (size_type i = 0; i < count; ++i)
         {
-            return (c_iterator::m_logicalIndex <= other.c_iterator::m_logicalIndex);
+            alloc_traits::destroy(base::m_allocator, first + i);
         }
+    }
 
-        /// @brief Comparison >= overload.
-        /// @param other Other iterator to compare against.
-        /// @return True if other points to logically larger or same indexed element.
-        /// @details Constant complexity.
-        bool operator>=(const _rBuf_iterator& other) const noexcept
+    /// @brief Relocates a contiguous segment of elements with memcpy. Used for trivially relocatable types.
+    void relocateSegment(pointer source, size_type count, pointer dest, std::true_type) noexcept
+    {
+        if (count)
         {
-            return (c_iterator::m_logicalIndex >= other.c_iterator::m_logicalIndex);
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(source), count * sizeof(T));
         }
+    }
 
-        /// @brief Custom assingment operator overload.
-        /// @param index Logical index of the element to set the iterator to.
-        /// @note Undefined behaviour for negative index.
-        /// @details Constant complexity.
-        _rBuf_iterator& operator=(const size_t index) noexcept
+    /// @brief Relocates a contiguous segment of elements by move construction, or by copy construction if the move constructor can throw (std::move_if_noexcept).
+    /// @exception If an exception is thrown, elements constructed to dest are destroyed before rethrowing.
+    void relocateSegment(pointer source, size_type count, pointer dest, std::false_type)
+    {
+        size_type constructed = 0;
+        try
         {
-            c_iterator::m_logicalIndex = index;
-            return (*this);
-        };
-
-        /// @brief Index getter.
-        /// @return Returns the index of the element this iterator is pointing to.
-        /// @details Constant complexity.
-        difference_type getIndex() noexcept
+            for (; constructed < count; ++constructed)
+            {
+                alloc_traits::construct(base::m_allocator, dest + constructed, std::move_if_noexcept(source[constructed]));
+            }
+        }
+        catch (...)
         {
-            return c_iterator::m_logicalIndex;
+            destroyRange(dest, constructed);
+            throw;
         }
-    };
-
-
-    using iterator = _rBuf_iterator<ring_buffer<T>>;
-    using const_iterator = _rBuf_const_iterator<ring_buffer<T>>;
-
-    using reverse_iterator = std::reverse_iterator<iterator>;
-    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-
-    /// @brief Default constructor.
-    /// @post this->empty() == true.
-    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation.
-    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
-    /// @details Constant complexity.
-    ring_buffer() : ring_buffer(allocator_type())
-    {
     }
 
-    /// @brief Constructs the container with a custom allocator.
-    /// @param alloc Custom allocator for the buffer.
-    /// @post this->empty() == true.
-    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
-    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
-    /// @details Constant complexity.
-    explicit ring_buffer(const allocator_type& alloc) : base(alloc, allocBuffer), m_headIndex(0), m_tailIndex(0)
+    /// @brief Relocates count elements starting from logical index first to uninitialized contiguous memory at dest, one contiguous segment at a time.
+    /// @note The source elements are left constructed (moved-from), call releaseRelocated() once all of them have been relocated.
+    /// @exception If an exception is thrown, nothing is constructed to dest. The source elements are unchanged unless value_type's move constructor throws.
+    void relocate(size_type first, size_type count, pointer dest)
     {
+        const auto start = CapacityPolicy::advance(m_tailIndex, first, base::m_capacity);
+        const auto firstCount = std::min(count, base::m_capacity - start);
+
+        relocateSegment(base::m_data + start, firstCount, dest, is_trivially_relocatable<T>());
+        try
+        {
+            relocateSegment(base::m_data, count - firstCount, dest + firstCount, is_trivially_relocatable<T>());
+        }
+        catch (...)
+        {
+            destroyRange(dest, firstCount);
+            throw;
+        }
     }
 
-    /// @brief Constructs the buffer to a given size with given values and optionally a custom allocator.
-    /// @param size Amount of elements to be initialized in the buffer.
-    /// @param val Reference to a value which the elements are initialized to.
-    /// @param alloc Custom allocator.
-    /// @pre T needs to satisfy CopyInsertable.
-    /// @post std::distance(begin(), end()) == size().
-    /// @note Allocates memory for count + allocBuffer elements.
-    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
-    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
-    /// @details Linear complexity in relation to amount of constructed elements (O(n)).
-    ring_buffer(size_type count, const_reference val, const allocator_type& alloc = allocator_type()) : base(alloc, count + allocBuffer), m_headIndex(count), m_tailIndex(0)
+    /// @brief Ends the lifetime of elements that have been relocated. Trivially relocatable elements were transferred with memcpy, so they are not destroyed.
+    void releaseRelocated() noexcept
     {
-        std::uninitialized_fill_n(base::m_data, count, val);
+        if (!is_trivially_relocatable<T>::value)
+        {
+            destroy_elements();
+        }
     }
-    
-    /// @brief Custom constructor. Initializes a buffer with count amount of default constructed value_type elements.
-    /// @param count amount of default constructed value_type elements.
-    /// @pre T must satisfy DefaultInsertable.
-    /// @throw Can throw std::bad_alloc if there is not enough memory available for allocation, or some exception from T's constructor.
-    /// @exception If any exception is thrown the buffer will be in a valid but unexpected state. (Basic exception guarantee).
-    /// @details Linear complexity in relation to count (O(n)).
-    explicit ring_buffer(size_type count, const allocator_type& alloc = allocator_type()) : base(alloc, count + allocBuffer), m_headIndex(count), m_tailIndex(0)
+
+    /// @brief Allocates newCapacity elements and relocates the buffer there, leaving count uninitialized slots at logical index pos.
+    /// @param newCapacity Capacity of the new memory area. Must be greater than size() + count.
+    /// @param pos Logical index of the first slot of the gap.
+    /// @param count Amount of slots in the gap.
+    /// @param construct Callable taking (pointer, amount) that constructs amount elements to the pointer, or throws leaving nothing constructed. Called once with count.
+    /// @post The elements are in logical order at the beginning of the new memory area, unless mirrored storage grew by remapping.
+    /// @exception If any exception is thrown, function has no effect (Strong exception guarantee), unless value_type's move constructor throws.
+    /// @details Linear complexity in relation to size of the buffer. Never copies elements that can be moved without throwing.
+    template<typename Construct>
+    void reallocateWithGap(size_type newCapacity, size_type pos, size_type count, Construct&& construct)
     {
-        size_t first = 0;
-        size_t current = 0;
+        using can_remap = std::integral_constant<bool, base::is_mirrored && is_trivially_relocatable<T>::value>;
+        if (pos == size() && newCapacity > base::m_capacity && growByRemap(newCapacity, count, construct, can_remap()))
+        {
+            return;
+        }
+
+        const auto sz = size();
+        pointer newData = base::allocateStorage(newCapacity);
 
         try
         {
-            for (size_t i = 0; i < count; i++)
+            // New elements are constructed first, as the arguments may refer to elements that are about to be relocated.
+            construct(newData + pos, count);
+
+            try
+            {
+                relocate(0, pos, newData);
+                try
+                {
+                    relocate(pos, sz - pos, newData + pos + count);
+                }
+                catch (...)
+                {
+                    destroyRange(newData, pos);
+                    throw;
+                }
+            }
+            catch (...)
             {
-                alloc_traits::construct(base::m_allocator, base::m_data + current);
-                current++;
+                destroyRange(newData + pos, count);
+                throw;
             }
         }
         catch (...)
         {
-            for (; first != current; first++)
+            base::deallocateStorage(newData, newCapacity);
+            throw;
+        }
+
+        const auto oldCapacity = base::m_capacity;
+        releaseRelocated();
+        base::replaceStorage(newData, newCapacity);
+        m_tailIndex = 0;
+        m_headIndex = sz + count;
+        recordReallocation(oldCapacity, sz * sizeof(T));
+    }
+
+    /// @brief Grows mirrored storage by mapping its memory again with more room, instead of relocating every element. Appends count elements with construct.
+    /// @details Only the wrapped part of the elements on the shorter side is moved, so that they are contiguous in the larger memory area.
+    /// @return False if the gap could overlap the elements during the move, the caller relocates the buffer instead.
+    template<typename Construct>
+    bool growByRemap(size_type newCapacity, size_type count, Construct& construct, std::true_type)
+    {
+        const auto oldCapacity = base::m_capacity;
+        const auto sz = size();
+        const bool wrapped = m_headIndex < m_tailIndex;
+        const auto headCount = wrapped ? m_headIndex : 0;
+        const auto tailCount = oldCapacity - m_tailIndex;
+
+        // Copy the head part after the old memory if it fits together with the gap, otherwise move the tail part to the end of the new memory.
+        // With count == 1 the gap always fits in the free slots of the old memory.
+        const bool copyHead = headCount + count <= newCapacity - oldCapacity;
+        if (wrapped && !copyHead && headCount + count > m_tailIndex)
+        {
+            return false;
+        }
+
+        pointer newData = base::growStorage(newCapacity);
+        if (newData == nullptr)
+        {
+            return false;
+        }
+
+        size_type newTail = m_tailIndex;
+        size_type gap = m_tailIndex + sz;
+        const auto movedBytes = wrapped ? (copyHead ? headCount : tailCount) * sizeof(T) : 0;
+        if (wrapped)
+        {
+            gap = copyHead ? oldCapacity + headCount : headCount;
+        }
+
+        // Moves the elements to their place in the new memory, where they are not covered by the gap.
+        auto arrange = [&]() noexcept
+        {
+            if (wrapped && copyHead)
             {
-                alloc_traits::destroy(base::m_allocator, base::m_data + first);
+                std::memcpy(static_cast<void*>(newData + oldCapacity), static_cast<const void*>(newData), headCount * sizeof(T));
             }
-            
-            m_headIndex = 0;
+            else if (wrapped)
+            {
+                newTail = newCapacity - tailCount;
+                std::memmove(static_cast<void*>(newData + newTail), static_cast<const void*>(newData + m_tailIndex), tailCount * sizeof(T));
+            }
+        };
 
+        // Memory of both mappings is shared, the old elements stay valid while construct reads its arguments.
+        try
+        {
+            construct(newData + gap, count);
+        }
+        catch (...)
+        {
+            arrange();
+            base::replaceStorage(newData, newCapacity);
+            m_tailIndex = newTail;
+            m_headIndex = CapacityPolicy::advance(newTail, sz, newCapacity);
+            recordReallocation(oldCapacity, movedBytes);
             throw;
         }
+
+        arrange();
+        base::replaceStorage(newData, newCapacity);
+        m_tailIndex = newTail;
+        m_headIndex = CapacityPolicy::advance(newTail, sz + count, newCapacity);
+        recordReallocation(oldCapacity, movedBytes);
+        return true;
     }
 
-    /// @brief Construct the buffer from range [begin,end).
-    /// @param beginIt Iterator to first element of range.
-    /// @param endIt Iterator pointing to past-the-last element of range.
-    /// @pre valye_type must satisfy CopyInsertable. InputIt must be deferencable to value_type, and incrementing rangeBegin (repeatedly) must reach rangeEnd. Otherwise behaviour is undefined.
-    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
-    /// @exception If any exception is thrown no memory is leaked and program remains in a valid state. (Basic exception guarantee).
-    /// @details Linear complexity in relation to the size of the range (O(n)).
-    /// @note Behavior is undefined if elements in range are not valid.
-    template<typename InputIt,typename = std::enable_if_t<std::is_convertible<typename std::iterator_traits<InputIt>::value_type,value_type>::value>>
-    ring_buffer(InputIt beginIt, InputIt endIt, const allocator_type& alloc = allocator_type())
-        : base(alloc, std::distance<InputIt>(beginIt,endIt) + allocBuffer), m_headIndex(std::distance<InputIt>(beginIt, endIt)), m_tailIndex(0)
+    /// @brief Storage that is not mirrored always relocates.
+    template<typename Construct>
+    bool growByRemap(size_type, size_type, Construct&, std::false_type) noexcept
     {
-        std::uninitialized_copy(beginIt, endIt, base::m_data);
+        return false;
     }
 
-    /// @brief Initializer list contructor.
-    /// @param init Initializer list to initialize the buffer from.
-    /// @pre T must satisfy CopyInsertable.
-    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
-    /// @exception If any exception is thrown no memory is leaked and program remains in a valid state. (Basic exception guarantee).
-    /// @details Linear complexity in relation to initializer list size (O(n)).
-    ring_buffer(std::initializer_list<T> init) : ring_buffer(init.begin(),init.end())
+    /// @brief Makes wrapped elements contiguous from the beginning of the current memory. The first segment is shifted back against the second one
+    /// through the free slots, then the two adjacent segments are rotated into logical order.
+    /// @pre The elements wrap around and is_nothrow_shiftable.
+    void linearizeInPlace() noexcept
     {
+        const auto sz = size();
+        const auto firstCount = base::m_capacity - m_tailIndex;
+        const auto secondCount = m_headIndex;
+
+        // Slots in [head, tail) are free, the first ones written are constructed, the rest are assigned over the already moved elements.
+        for (size_type i = 0; i < firstCount; ++i)
+        {
+            const auto dest = base::m_data + secondCount + i;
+            if (secondCount + i < m_tailIndex)
+            {
+                alloc_traits::construct(base::m_allocator, dest, std::move(base::m_data[m_tailIndex + i]));
+            }
+            else
+            {
+                *dest = std::move(base::m_data[m_tailIndex + i]);
+            }
+        }
+        const auto vacated = std::max(m_tailIndex, sz);
+        destroyRange(base::m_data + vacated, base::m_capacity - vacated);
+
+        std::rotate(base::m_data, base::m_data + secondCount, base::m_data + sz);
+        m_tailIndex = 0;
+        m_headIndex = sz;
     }
 
-    /// @brief Copy constructor.
-    /// @param rhs Reference to a RingBuffer to create a copy from.
-    /// @pre T must meet CopyInsertable.
-    /// @post this == ring_buffer(rhs).
-    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
-    /// @except If any exception is thrown, invariants are preserved.(Basic Exception Guarantee).
-    /// @details Linear complexity in relation to buffer size.
-    ring_buffer(const ring_buffer& rhs) 
-    : m_headIndex(rhs.m_headIndex), m_tailIndex(rhs.m_tailIndex), base(alloc_traits::select_on_container_copy_construction(rhs.m_allocator), rhs.capacity())
+    /// @brief Counts a move of the elements to new memory, called once the indices are valid for the new memory. Calls the growth hook if the capacity grew.
+    /// @param oldCapacity Capacity before the move.
+    /// @param bytes Amount of bytes of elements moved.
+    void recordReallocation(size_type oldCapacity, size_type bytes) noexcept
     {
-        std::uninitialized_copy(rhs.begin(), rhs.end(), base::m_data);
+        ++m_reallocations;
+        stats_collector::countRelocation(oldCapacity, base::m_capacity, bytes);
     }
 
-    /// @brief Copy constructor with custom allocator.
-    /// @param rhs Reference to a RingBuffer to create a copy from.
-    /// @param alloc Allocator for the new buffer.
-    /// @pre T must meet CopyInsertable.
-    /// @post this == ring_buffer(rhs) but with a different allocator.
-    /// @throw Can throw std::bad_alloc, or something from T's CopyConstructor if not NoThrowCopyConstructible.
-    /// @except If any exception is thrown, invariants are preserved.(Basic Exception Guarantee).
-    /// @details Linear complexity in relation to buffer size.
-    ring_buffer(const ring_buffer& rhs, const allocator_type& alloc) : base(alloc, rhs.m_capacity), m_headIndex(rhs.m_headIndex), m_tailIndex(rhs.m_tailIndex)
+    /// @brief Counts count added elements and the size they left the buffer at.
+    RING_BUFFER_CONSTEXPR void recordPushes(size_type count) noexcept
     {
-        std::uninitialized_copy(rhs.begin(), rhs.end(), base::m_data);
+        stats_collector::countPushes(count, size());
     }
 
-    /// @brief Move constructor.
-    /// @param other Rvalue reference to other buffer.
-    /// @details Constant complexity.
-    ring_buffer(ring_buffer&& other) noexcept : base(std::move(other)), m_headIndex(std::exchange(other.m_headIndex, 0)), m_tailIndex(std::exchange(other.m_tailIndex,0))
+    /// @brief Allocates newCapacity elements and relocates the buffer there.
+    /// @param newCapacity Capacity of the new memory area. Must be greater than size().
+    void reallocate(size_type newCapacity)
     {
+        reallocateWithGap(newCapacity, size(), 0, [](pointer, size_type) {});
     }
 
-    /// @brief Move constructor with different allocator.
-    /// @param other Rvalue reference to other buffer.
-    /// @param alloc Allocator for the new ring buffer.
-    /// @details Linear complexity in relation to buffer size.
-    ring_buffer(ring_buffer&& other, const allocator_type& alloc) : base(alloc, other.m_capacity), m_headIndex(other.m_headIndex), m_tailIndex(other.m_tailIndex)
-    {
-        size_t first = 0;
-        size_t current = 0;
+    using has_inline_storage = std::integral_constant<bool, base::inline_capacity != 0>;
+
+    using shrinks_when_idle = std::integral_constant<bool, CapacityPolicy::shrinks_when_idle>;
 
+    /// @brief Counts a pop that left the buffer below the low watermark of CapacityPolicy, and shrinks the buffer once there were enough of them in a row.
+    /// @note Shrinking only saves memory, a failed allocation or relocation leaves the buffer as it is.
+    void shrinkIfIdle(std::true_type) noexcept
+    {
+        if (!CapacityPolicy::is_idle(size(), base::m_capacity))
+        {
+            idle_counter::clearIdlePops();
+            return;
+        }
+        if (idle_counter::addIdlePop() < CapacityPolicy::idle_patience)
+        {
+            return;
+        }
+        idle_counter::clearIdlePops();
         try
         {
-            for (size_t i = 0; i < other.size(); i++)
-            {
-                alloc_traits::construct(base::m_allocator, base::m_data + current, std::move(other[i]));
-                current++;
-            }
+            reserve(CapacityPolicy::shrink_target(size()), true);
         }
         catch (...)
         {
-            for (; first != current; first++)
-            {
-                alloc_traits::destroy(base::m_allocator, base::m_data + first);
-            }
-            m_headIndex = 0;
-            m_tailIndex = 0;
-            throw;
         }
+    }
 
-        other.m_headIndex = 0;
-        other.m_tailIndex = 0;
+    RING_BUFFER_CONSTEXPR void shrinkIfIdle(std::false_type) noexcept
+    {
     }
 
-    /// Destructor.
-    ~ring_buffer()
+    /// @brief Relocates the elements of other's inline storage to the same physical positions in this buffer's memory. Indices must already be taken from other.
+    /// @pre Both buffers have the same capacity and this buffer holds no constructed elements.
+    void moveInline(ring_buffer& other, std::true_type) noexcept
     {
-        destroy_elements();
+        const auto firstCount = firstSegmentSize();
+        const auto secondCount = size() - firstCount;
+
+        relocateSegment(other.m_data + m_tailIndex, firstCount, base::m_data + m_tailIndex, is_trivially_relocatable<T>());
+        relocateSegment(other.m_data, secondCount, base::m_data, is_trivially_relocatable<T>());
+
+        if (!is_trivially_relocatable<T>::value)
+        {
+            destroyRange(other.m_data + m_tailIndex, firstCount);
+            destroyRange(other.m_data, secondCount);
+        }
     }
 
-    /// @brief Inserts an element to the buffer.
-    /// @param pos Iterator where the the element should be inserted. 
-    /// @param value Value to insert.
-    /// @return iterator pointing to the inserted value.
-    /// @pre T must meet CopyInsertable. 
-    /// @throw Might throw std::bad_alloc, or something from T's copy constructor if not NoThrow.
-    /// @exception  If any exception is thrown, the function does nothing (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    iterator insert(const_iterator pos, const value_type& value)
+    /// @brief Heap storage is never inline.
+    void moveInline(ring_buffer&, std::false_type) noexcept
     {
-        return insertBase(pos, 1, value);
     }
 
-    /// @brief Inserts an element to the buffer.
-    /// @param pos Iterator where the the element should be inserted
-    /// @param value Value to insert.
-    /// @return Iterator that pos to the inserted element.
-    /// @pre T must meet MoveInsertable.
-    /// @throw Might throw std::bad_alloc, or something from T's move/copy constructor.
-    /// @exception If any exception is thrown, the function does nothing (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    iterator insert(const_iterator pos, value_type&& value)
+    /// @brief Replaces the allocator with alloc if the allocator propagates. Allocators that don't propagate need not be assignable, e.g. std::pmr::polymorphic_allocator.
+    void propagateAllocator(const allocator_type& alloc, std::true_type)
     {
-        return insertBase(pos, 1, std::move(value));
+        base::m_allocator = alloc;
     }
 
-    /// @brief Inserts an element to the buffer.
-    /// @param pos Iterator where the the element should be inserted
-    /// @param count Amount of T elements to be inserted.
-    /// @param value Value to insert.
-    /// @pre T must meet the requirements of CopyInsertable.
-    /// @return Iterator that pos to the inserted element.
-    /// @throw Might throw std::bad_alloc, or something from T's copy constructor if not NoThrow.
-    /// @exception  If any exception is thrown, the function does nothing (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    iterator insert(const_iterator pos, const size_type count, const value_type& value)
+    /// @brief The allocator does not propagate, keeps the current one.
+    void propagateAllocator(const allocator_type&, std::false_type) noexcept
     {
-        if(count == 0) return iterator(this, pos.getIndex());
-        return insertBase(pos, count, value);
     }
 
-    /// @brief Inserts a range of elements into the buffer to a specific position.
-    /// @tparam InputIt Type of iterator for the range.
-    /// @param pos A valid dereferenceable iterator to the position where range will be inserted to.
-    /// @param sourceBegin Iterator to first element of the range.
-    /// @param sourceEnd Iterator past the last element of the range.
-    /// @return Returns an iterator to an element in the buffer which is copy of the first element in the range.
-    /// @pre T must meet requirements of CopyInsertable. Iterators must point to elements that are implicitly convertible to value_type and sourceEnd must be reachable from sourceBegin. Otherwise behavior is undefined.
-    /// @throw Can throw std::bad_alloc or something from value_types constructor and iterator operations. 
-    /// @exception If any exceptiong is thrown, the function does nothing (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    template <typename InputIt>
-    iterator insert(const_iterator pos, InputIt sourceBegin, InputIt sourceEnd)
+    /// @brief Swaps the allocators if they propagate on swap.
+    void swapAllocator(ring_buffer& other, std::true_type) noexcept
     {
-        if(std::distance(sourceBegin, sourceEnd) == 0) return iterator(this, pos.getIndex() );
-        return insertRangeBase(pos, sourceBegin, sourceEnd);
+        using std::swap;
+        swap(base::m_allocator, other.m_allocator);
     }
 
-    /// @brief Inserts initializer list into buffer to a specific position.
-    /// @param pos Iterator where the list will be inserted.
-    /// @param list Initiliazer list to insert.
-    /// @pre pos must be a valid dereferenceable iterator within the container. Otherwise behavior is undefined.
-    /// @return Returns Iterator to the first element inserted, or the element pointed by pos if the initializer list was empty.
-    /// @throw Can throw std::bad_alloc and something from value_types constructor.
-    /// @exception If any exceptiong is thrown, the function does nothing (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    iterator insert(const_iterator pos, std::initializer_list<T> list)
-    {   
-        if (list.size() == 0) return iterator(this, pos.getIndex());
-        return insertRangeBase(pos, list.begin(), list.end());
+    /// @brief The allocators don't propagate on swap, keeps both.
+    void swapAllocator(ring_buffer&, std::false_type) noexcept
+    {
     }
 
-    /// @brief Construct an element in place from arguments.
-    /// @param pos Iterator before which the new element will be constructed.
-    /// @param args Argument pack containing arguments to construct value_type element.
-    /// @return Returns an iterator pointing to the element constructed from args.
-    /// @pre T must meet EmplaceConstructible, MoveAssignalbe and MoveInsertable.
-    /// @post Iterators, pointers and references are invalidated after the emplace point. If more memory is allocated, pointers and references to all elements are invalidated.
-    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element. Additionally, rotate can throw bad_alloc and if T does not provide a noexcept move semantics.
-    /// @exception If T's CopyConstructor is NoThrow then in case of any exception invariants are preserved. (Basic exception guarantee). If T's construction throws the behavior is undefined.
-    /// @details Amortized linear complexity in relation to distance from pos to end().
-    template<class... Args>
-    iterator emplace(const_iterator pos, Args&&... args)
+    /// @brief Takes the memory and elements of other, leaving it empty.
+    /// @pre This buffer holds no constructed elements.
+    void takeStorage(ring_buffer& other) noexcept
     {
-        validateCapacity(1);
+        m_headIndex = std::exchange(other.m_headIndex, 0);
+        m_tailIndex = std::exchange(other.m_tailIndex, 0);
+
+        if (other.isInline())
+        {
+            base::releaseStorage();
+            moveInline(other, has_inline_storage());
+        }
+        else
+        {
+            base::replaceStorage(other.m_data, other.m_capacity);
+            other.detachStorage();
+        }
+    }
 
-        iterator it(this, pos.getIndex());
+    /// @brief Reserves more memory if needed for an increase in size. If more memory is needed, grows the capacity according to CapacityPolicy, or to fit the increase if that is not enough.
+    /// @param increase Expected increase in size of the buffer, based on which memory is allocated.
+    /// @details Linear complexity in relation to buffer size if more memory needs to be allocated, otherwise constant complexity.
+    /// @exception May throw std::bad_alloc. If any exception is thrown this function does nothing. Strong exception guarantee.
+    /// @note This function should be called before increasing the size of the buffer.
+    void validateCapacity(size_t increase)
+    {
+        if (base::m_capacity > size() + increase + allocBuffer) return;
 
-        //Construct temporary
-        _alloc_temp<Allocator> tempObj (base::m_allocator, std::forward<Args>(args)...);
+        reserve(nextCapacity(size() + increase + allocBuffer + 1));
+    }
 
-        //Provide basic guarantee. TODO provide strong guarantee to head and tail and optimize to move toward closer end.
-        auto last = end();
-        alloc_traits::construct(base::m_allocator, &*last, std::move(*(last - 1)));
-        increment(m_headIndex);
-        std::move_backward(it, last - 1 , last);
+    /// @brief Base function for inserting count elements constructed from args.
+    /// @param index Logical index where the first new element will exist.
+    /// @param count Amount of elements to insert.
+    /// @param args Arguments to construct the first element from. The rest are copies of it.
+    /// @pre T Must satisfy EmplaceConstructible and MoveInsertable, and CopyInsertable if count > 1.
+    /// @return Returns iterator pointing to the first element inserted.
+    /// @throw Might throw std::bad_alloc from allocating memory, or something from T's constructors.
+    /// @exception  If any exception is thrown, function has no effect (Strong exception guarantee).
+    /// @details Linear complexity in relation to inserted elements and the moved side of the buffer.
+    template<typename... Args>
+    iterator emplaceBase(size_type index, size_type count, Args&&... args)
+    {
+        if (base::m_capacity < size() + count + allocBuffer || !is_nothrow_shiftable::value)
+        {
+            //Reallocate and relocate whole buffer. Strong guarantee.
+            const auto newCapacity = base::m_capacity < size() + count + allocBuffer ? nextCapacity(size() + count + allocBuffer) : base::m_capacity;
+            const bool slowInsert = newCapacity == base::m_capacity;
+            reallocateWithGap(newCapacity, index, count, [&](pointer gap, size_type)
+            {
+                alloc_traits::construct(base::m_allocator, gap, std::forward<Args>(args)...);
+                fillCopies(gap + 1, count - 1, *gap, gap, 1);
+            });
+            if (slowInsert)
+            {
+                stats_collector::countSlowInsert();
+            }
+            recordPushes(count);
+            return iterator(this, index);
+        }
 
-        *it = std::move(tempObj._getValue());
+        // Args may refer to elements that are about to be moved.
+        _alloc_temp<Allocator> tempObj(base::m_allocator, std::forward<Args>(args)...);
 
-        return it;
+        if (count == 1)
+        {
+            insertGap(index, 1, [&](pointer gap, size_type amount)
+            {
+                if (amount)
+                {
+                    alloc_traits::construct(base::m_allocator, gap, std::move(tempObj._getValue()));
+                }
+            });
+        }
+        else
+        {
+            insertGap(index, count, [&](pointer gap, size_type amount)
+            {
+                fillCopies(gap, amount, tempObj._getValue(), nullptr, 0);
+            });
+        }
+        recordPushes(count);
+        return iterator(this, index);
     }
 
-    /// @brief Constructs an element in place to front from argumets.
-    /// @param args Argument pack containing arguments to construct value_type element.
-    /// @pre value_type is EmplaceConstructible from args.
-    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element.
-    /// @exception If any exception is thrown, function has no effect. (Strong exception guarantee).
-    /// @details  Amortized constant complexity.
-    template<class... Args>
-    void emplace_front(Args&&... args)
+    /// @brief Copy constructs count copies of value to uninitialized memory at dest.
+    /// @exception If a constructor throws, the elements constructed by this call and extra elements at [extra, extra + extraCount) are destroyed before rethrowing.
+    void fillCopies(pointer dest, size_type count, const value_type& value, pointer extra, size_type extraCount)
     {
-        if (base::m_capacity < size() + allocBuffer)
+        size_type constructed = 0;
+        try
         {
-            auto sz = size();
-
-            base temp(base::m_allocator, base::m_capacity * 3 / 2);
-            std::uninitialized_copy(begin(), end(), temp.m_data);
-            alloc_traits::construct(base::m_allocator, temp.m_data + temp.m_capacity - 1, std::forward<Args>(args)...);
+            for (; constructed < count; ++constructed)
+            {
+                alloc_traits::construct(base::m_allocator, dest + constructed, value);
+            }
+        }
+        catch (...)
+        {
+            destroyRange(dest, constructed);
+            destroyRange(extra, extraCount);
+            throw;
+        }
+    }
 
-            destroy_elements();
+    /// @brief Base function for inserting elements from a range of [rangeBegin, rangeEnd).
+    /// @tparam OutputIt type of the source ranges output iterator.
+    /// @param pos Iterator pointing to the element where after insert new element will exist.
+    /// @param rangeBegin Iterator pointing to the first element of the range.
+    /// @param rangeEnd Iterator pointing past the last element to be inserted.
+    /// @return Returns iterator pointing to the first element inserted.
+    /// @pre value_type must meet CopyInsertable. InputIt must be deferencable to value_type, and incrementing rangeBegin possibly multiple times should reach rangeEnd. Otherwise behaviour is undefined.
+    /// @post Each iterator in [rangeBegin, rangeEnd) is dereferenced once.
+    /// @throw Might throw std::bad_alloc from allocating memory and rotate(), or something from T's move/copy constructor.
+    /// @exception  If any exception is thrown, function has no effect (Strong exception guarantee).
+    /// @details Linear Complexity in relation to buffer size and amount of inserted elements.
+    template<typename OutputIt>
+    iterator insertRangeBase(const_iterator pos, OutputIt rangeBegin, OutputIt rangeEnd)
+    {
+        const size_type amount = std::distance<OutputIt>(rangeBegin, rangeEnd);
+        const auto index = pos.getIndex();
 
-            base::swap(*this, temp);
-            m_headIndex = sz;
-            m_tailIndex = base::m_capacity - 1;
+        using is_memcpy = std::integral_constant<bool, std::is_trivially_copyable<T>::value && std::is_pointer<OutputIt>::value
+            && std::is_same<std::remove_cv_t<std::remove_pointer_t<OutputIt>>, T>::value>;
 
-            return;
-        }
+        // Segments are filled in order, so the source is walked once.
+        auto construct = [&](pointer gap, size_type count)
+        {
+            rangeBegin = constructSegment(gap, rangeBegin, count, is_memcpy());
+        };
 
-        // Decrement temporary index in case constructor throws to retain invariants (elements of the buffer are always initialized).
-        auto newIndex = m_tailIndex;
-        decrement(newIndex);
-        alloc_traits::construct(base::m_allocator, base::m_data + newIndex, std::forward<Args>(args)...);
-        m_tailIndex = newIndex;
+        if (base::m_capacity < size() + amount + allocBuffer || !is_nothrow_shiftable::value)
+        {
+            const auto newCapacity = base::m_capacity < size() + amount + allocBuffer ? nextCapacity(size() + amount + allocBuffer) : base::m_capacity;
+            const bool slowInsert = newCapacity == base::m_capacity;
+            reallocateWithGap(newCapacity, index, amount, construct);
+            if (slowInsert)
+            {
+                stats_collector::countSlowInsert();
+            }
+        }
+        else
+        {
+            insertGap(index, amount, construct);
+        }
+        recordPushes(amount);
+        return iterator(this, index);
     }
 
-    /// @brief Constructs an element in place to front from argumets.
-    /// @param args Argument pack containing arguments to construct value_type element.
-    /// @pre value_type is EmplaceConstructible from args.
-    /// @throw Can throw std::bad_alloc if memory is allocated. Can also throw from T's constructor when constructing the element.
-    /// @exception If any exception is thrown, function has no effect. (Strong exception guarantee).
-    /// @details Amortized constant complexity.
-    template<class... Args>
-    void emplace_back(Args&&... args)
+    /// @brief True if elements can be shifted inside the buffer without exceptions, which in place insertion relies on to roll back.
+    using is_nothrow_shiftable = std::integral_constant<bool, is_trivially_relocatable<T>::value
+        || (std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value)>;
+
+    /// @brief Opens a gap of count uninitialized slots at logical index and fills it, moving the elements on the shorter side of index out of the way.
+    /// @param construct Callable taking (pointer, amount) that constructs amount elements to the pointer, or throws leaving nothing constructed.
+    /// Called once per contiguous segment of the gap, in order. The second call has amount 0 if the gap does not wrap around.
+    /// @pre m_capacity >= size() + count + 1 and is_nothrow_shiftable.
+    /// @exception If construct throws, the gap is closed again and the buffer is unchanged (Strong exception guarantee).
+    /// @details Linear complexity in relation to count and the amount of elements on the shorter side.
+    template<typename Construct>
+    void insertGap(size_type index, size_type count, Construct&& construct)
     {
-        if (base::m_capacity < size() + allocBuffer)
+        const auto sz = size();
+        const bool moveFront = index < sz - index;
+
+        if (moveFront)
+        {
+            const auto oldTail = m_tailIndex;
+            m_tailIndex = CapacityPolicy::retreat(m_tailIndex, count, base::m_capacity);
+            shiftElements(oldTail, index, count, false);
+        }
+        else
         {
-            auto sz = size();
-            base temp(base::m_allocator, base::m_capacity * 3 / 2);
-            std::uninitialized_copy(begin(), end(), temp.m_data);
+            shiftElements(CapacityPolicy::advance(m_tailIndex, index, base::m_capacity), sz - index, count, true);
+            m_headIndex = CapacityPolicy::advance(m_headIndex, count, base::m_capacity);
+        }
 
+        const auto gapStart = CapacityPolicy::advance(m_tailIndex, index, base::m_capacity);
+        const auto firstCount = std::min(count, base::m_capacity - gapStart);
+
+        try
+        {
+            construct(base::m_data + gapStart, firstCount);
             try
             {
-                alloc_traits::construct(base::m_allocator, temp.m_data + sz, std::forward<Args>(args)...);
+                construct(base::m_data, count - firstCount);
             }
             catch (...)
             {
-                for (size_t i = 0; i < sz; ++i)
-                {
-                    alloc_traits::destroy(base::m_allocator, temp.m_data + i);
-                }
+                destroyRange(base::m_data + gapStart, firstCount);
                 throw;
             }
-
-            destroy_elements();
-
-            base::swap(*this, temp);
-            m_tailIndex = 0;
-            m_headIndex = sz;
-            increment(m_headIndex);
-
-            return;
         }
-
-        alloc_traits::construct(base::m_allocator, base::m_data + m_headIndex, std::forward<Args>(args)...);
-        increment(m_headIndex);
+        catch (...)
+        {
+            if (moveFront)
+            {
+                shiftElements(m_tailIndex, index, count, true);
+                m_tailIndex = CapacityPolicy::advance(m_tailIndex, count, base::m_capacity);
+            }
+            else
+            {
+                m_headIndex = CapacityPolicy::retreat(m_headIndex, count, base::m_capacity);
+                shiftElements(CapacityPolicy::advance(gapStart, count, base::m_capacity), sz - index, count, false);
+            }
+            throw;
+        }
     }
 
-    /// @brief Erase an element at a given position.
-    /// @param pos Pointer to the element to be erased.
-    /// @pre value_type must be nothrow-MoveConstructible. pos must be a valid dereferenceable iterator within the container. Otherwise behavior is undefined.
-    /// @return Returns an iterator that was immediately following the ereased element. If the erased element was last in the buffer, returns a pointer to end().
-    /// @exception If value_type is nothrow_move_constructible and nothrow_move_assignable function is noexcept. Otherwise provides no exception guarantee at all.
-    /// @details Linear Complexity in relation to distance of end buffer from the target element.
-    iterator erase(const_iterator pos)
+    /// @brief Moves count elements starting from physical index first by distance slots toward the head (forward) or toward the tail.
+    /// @pre The destination slots that are not part of the source are uninitialized. count + distance < m_capacity.
+    /// @post The source slots that are not part of the destination are uninitialized.
+    /// @note Trivially relocatable elements are moved with memmove per contiguous segment. Other elements are move constructed to uninitialized slots,
+    /// move assigned over the source and the remaining source elements are destroyed.
+    void shiftElements(size_type first, size_type count, size_type distance, bool forward) noexcept
     {
-        return eraseBase(pos, pos + 1);
+        if (count == 0 || distance == 0) return;
+        shiftElements(first, count, distance, forward, is_trivially_relocatable<T>());
     }
 
-    /// @brief Erase the specified elements from the container according to the range [first,last). Might destroy or move assign to the elements depending if last == end(). If last == end(), elements in [first,last) are destroyed.
-    /// @param first iterator to the first element to erase.
-    /// @param last iterator past the last element to erase.
-    /// @pre First and last must be valid iterators to *this.
-    /// @return Returns an iterator to the element that was immediately following the last erased elements. If last == end(), then new end() is returned.
-    /// @throw Possibly throws from value_types move/copy assignment operator if last != end().
-    /// @exception If value_type is nothrow_move_constructible and nothrow_move_assignable function is noexcept. Otherwisde provides no exception guarantee at all.
-    /// @details Linear Complexity in relation to size of the range, and then linear in remaining elements after the erased range.
-    iterator erase(const_iterator first, const_iterator last)
+    void shiftElements(size_type first, size_type count, size_type distance, bool forward, std::true_type) noexcept
     {
-        return eraseBase(first, last);
+        moveSegments(first, count, distance, forward, std::true_type());
     }
 
-    /// @brief Destroys all elements in a buffer. Does not modify capacity.
-    /// @post All existing references, pointers and iterators are to be considered invalid.
-    /// @details Linear complexity in relation to size of the buffer.
-    void clear() noexcept
+    void shiftElements(size_type first, size_type count, size_type distance, bool forward, std::false_type) noexcept
     {
-        destroy_elements();
+        const auto capacity = base::m_capacity;
+        // Amount of source slots that are not overwritten by the destination.
+        const auto uncovered = std::min(count, distance);
 
-        m_headIndex = 0;
-        m_tailIndex = 0;
+        if (forward)
+        {
+            for (size_type i = count; i-- > 0;)
+            {
+                auto source = base::m_data + CapacityPolicy::advance(first, i, capacity);
+                auto dest = base::m_data + CapacityPolicy::advance(first, i + distance, capacity);
+                if (i + distance >= count)
+                {
+                    alloc_traits::construct(base::m_allocator, dest, std::move(*source));
+                }
+                else
+                {
+                    *dest = std::move(*source);
+                }
+            }
+            destroySlots(first, uncovered);
+        }
+        else
+        {
+            const auto destFirst = CapacityPolicy::retreat(first, distance, capacity);
+            for (size_type i = 0; i < count; ++i)
+            {
+                auto source = base::m_data + CapacityPolicy::advance(first, i, capacity);
+                auto dest = base::m_data + CapacityPolicy::advance(destFirst, i, capacity);
+                if (i < distance)
+                {
+                    alloc_traits::construct(base::m_allocator, dest, std::move(*source));
+                }
+                else
+                {
+                    *dest = std::move(*source);
+                }
+            }
+            destroySlots(CapacityPolicy::advance(first, count - uncovered, capacity), uncovered);
+        }
     }
 
-    /// @brief Replaces the elements in the buffer with copy of [sourceBegin, sourceEnd)
-    /// @param sourceBegin Iterator to beginning of the range.
-    /// @param sourceEnd Past the end iterator of the range.
-    /// @pre value_type is CopyInsertable and elements of [sourceBegin, sourceEnd) are not in *this. InputIt must be dereferenceable to value_type, and incrementing sourceBegin (repeatedly) must reach sourceEnd. Otherwise behaviour is undefined.
-    /// @post All existing references, pointers and iterators are to be considered invalid.
-    /// @throw Can throw std::bad_alloc or something from value_types constructor if not nothrow. 
-    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated, in case of any exception the function does nothing (Strong Exception Guarantee) 
-    /// @details Linear Complexity. Calls destructor for each element in buffer and CopyConstructor for the assigned range.
-    template <typename InputIt>
-    void assign(InputIt sourceBegin, InputIt sourceEnd)
+    /// @brief Moves count elements starting from physical index first by distance slots toward the head (forward) or toward the tail, one contiguous segment at a time.
+    /// @tparam IsMemmove True to move the bytes with memmove, for trivially copyable elements or relocating trivially relocatable ones. Otherwise elements are move assigned,
+    /// so all destination slots must hold constructed elements.
+    /// @pre count + distance < m_capacity.
+    template<typename IsMemmove>
+    void moveSegments(size_type first, size_type count, size_type distance, bool forward, IsMemmove) noexcept(std::is_nothrow_move_assignable<T>::value || IsMemmove::value)
     {
-        size_type amount = std::distance(sourceBegin, sourceEnd);
-        if (base::m_capacity < amount + allocBuffer)
+        const auto capacity = base::m_capacity;
+        if (forward)
         {
-            base temp{base::m_allocator, amount * 3 / 2 };
-            std::uninitialized_copy(sourceBegin, sourceEnd, temp.m_data);
-            base::swap(*this, temp);
-            m_headIndex = amount;
-            m_tailIndex = 0;
-
-            return;
+            // Process from the back so that the source is read before it is overwritten.
+            auto sourceEnd = CapacityPolicy::advance(first, count, capacity);
+            auto destEnd = CapacityPolicy::advance(sourceEnd, distance, capacity);
+            while (count)
+            {
+                sourceEnd = sourceEnd ? sourceEnd : capacity;
+                destEnd = destEnd ? destEnd : capacity;
+                const auto amount = std::min(count, std::min(sourceEnd, destEnd));
+                sourceEnd -= amount;
+                destEnd -= amount;
+                moveChunk(base::m_data + sourceEnd, amount, base::m_data + destEnd, true, IsMemmove());
+                count -= amount;
+            }
+        }
+        else
+        {
+            auto source = first;
+            auto dest = CapacityPolicy::retreat(first, distance, capacity);
+            while (count)
+            {
+                const auto amount = std::min(count, std::min(capacity - source, capacity - dest));
+                moveChunk(base::m_data + source, amount, base::m_data + dest, false, IsMemmove());
+                source = CapacityPolicy::advance(source, amount, capacity);
+                dest = CapacityPolicy::advance(dest, amount, capacity);
+                count -= amount;
+            }
         }
+    }
 
-        clear();
-        std::uninitialized_copy(sourceBegin, sourceEnd, base::m_data);
-        m_headIndex = amount;
+    /// @brief Moves count contiguous elements from source to possibly overlapping dest.
+    static void moveChunk(pointer source, size_type count, pointer dest, bool, std::true_type) noexcept
+    {
+        std::memmove(static_cast<void*>(dest), source, count * sizeof(T));
     }
 
-    /// @brief Replaces the elements in the buffer with copy of the initializer list.
-    /// @param list Source of elements to assign.
-    /// @pre value_type is CopyInsertable.
-    /// @post All existing references, pointers and iterators are to be considered invalid.
-    /// @throw Can throw std::bad_alloc or something from value_types constructor if not nothrow. 
-    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated, in case of any exception the function does nothing (Strong Exception Guarantee) 
-    /// @details Linear Complexity. Calls destructor for each element in buffer and CopyConstructor for each element in the list.
-    void assign(std::initializer_list<T> list)
+    static void moveChunk(pointer source, size_type count, pointer dest, bool backward, std::false_type)
     {
-        assign(list.begin(), list.end());
+        if (backward)
+        {
+            std::move_backward(source, source + count, dest + count);
+        }
+        else
+        {
+            std::move(source, source + count, dest);
+        }
     }
 
-    /// @brief Replaces the elements in the buffer with given value.
-    /// @param amount Size of the buffer after the assignment.
-    /// @param value Value of all elements after the assignment.
-    /// @pre value_type is CopyInsertable.
-    /// @post All existing references, pointers and iterators are to be considered invalid.
-    /// @throw Can throw std::bad_alloc or from value_types constructor.
-    /// @exception If any exception is throw, no memory is leaked but buffer will be in valid but unexpected state (Basic Exception Guarantee). If more memory is allocated and exception is thrown, function has no effect (Strong exception guarantee)
-    /// @details Linear Complexity. Calls destructor for each element in buffer and amount times values constructor.
-    void assign(const size_type amount, const value_type& value)
+    /// @brief Splits a segment into chunks of at least count elements that end on cache line boundaries.
+    template<typename Span>
+    static void appendChunks(std::vector<Span>& out, Span segment, size_type count)
     {
+        auto first = segment.data();
+        auto remaining = segment.size();
+        while (remaining)
+        {
+            auto take = std::min(std::max<size_type>(count, 1), remaining);
 
-        if (base::m_capacity < amount + allocBuffer)
+            // Addresses of the elements repeat their alignment at least every cacheLineSize elements. If the segment ends first, the chunk takes the rest of it.
+            for (size_type i = take; i < take + cacheLineSize; i++)
+            {
+                if (i == remaining || reinterpret_cast<std::uintptr_t>(first + i) % cacheLineSize == 0)
+                {
+                    take = i;
+                    break;
+                }
+            }
+            out.emplace_back(first, take);
+            first += take;
+            remaining -= take;
+        }
+    }
+
+    /// @brief Logical index of the first element equal to value, or size() if there is none.
+    size_type findIndex(const value_type& value) const
+    {
+        const auto first = array_one();
+        const auto second = array_two();
+        const auto inFirst = findInSegment(first.data(), first.size(), value, std::integral_constant<bool, sizeof(T) == 1 && is_bitwise_comparable<T>::value>());
+        if (inFirst != first.size())
         {
-            base temp{base::m_allocator, amount * 3/2};
-            std::uninitialized_fill_n(temp.m_data, amount, value);
-            base::swap(*this, temp);
-            m_headIndex = amount;
-            
-            return;
+            return inFirst;
         }
-        
-        clear();
-        std::uninitialized_fill_n(base::m_data, amount, value);
-        m_headIndex = amount;
+        return first.size() + findInSegment(second.data(), second.size(), value, std::integral_constant<bool, sizeof(T) == 1 && is_bitwise_comparable<T>::value>());
     }
 
-    /// @brief Copy assignment operator.
-    /// @param other Ringbuffer to be copy assigned.
-    /// @return Returns reference to the assignment target container.
-    /// @post *this == other. All iterators, pointers and references of the target container should be considered invalid. Does not guarantee that target containers capacity equals the original.
-    /// @throw Can throw std::bad_alloc or something from value_types constructor.
-    /// @exception If any exception is thrown, invariants are retained and no memory is leaked (Basic Exception Guarantee).
-    /// @details Linear complexity in relation to buffer size. 
-    ring_buffer& operator=(const ring_buffer& other)
+    /// @brief Single byte elements are searched with memchr.
+    static size_type findInSegment(const T* data, size_type count, const value_type& value, std::true_type) noexcept
     {
+        unsigned char byte;
+        std::memcpy(&byte, std::addressof(value), 1);
+        const auto found = count ? std::memchr(data, byte, count) : nullptr;
+        return found ? static_cast<size_type>(static_cast<const T*>(found) - data) : count;
+    }
 
-        if (this == &other) return *this;
+    static size_type findInSegment(const T* data, size_type count, const value_type& value, std::false_type)
+    {
+        return static_cast<size_type>(std::find(data, data + count, value) - data);
+    }
 
-        if (alloc_traits::propagate_on_container_copy_assignment::value && (base::m_allocator != other.m_allocator))
-        {
-            auto temp = ring_buffer(other);
+    /// @brief Destroys count elements starting from physical index first, one contiguous segment at a time.
+    RING_BUFFER_CONSTEXPR void destroySlots(size_type first, size_type count) noexcept
+    {
+        const auto firstCount = std::min(count, base::m_capacity - first);
+        destroyRange(base::m_data + first, firstCount);
+        destroyRange(base::m_data, count - firstCount);
+    }
 
-            base::swap(*this, temp);
-            std::swap(m_tailIndex, temp.m_tailIndex);
-            std::swap(m_headIndex, temp.m_headIndex);
-        }
-        else
-        {
-            validateCapacity(other.size() - base::m_capacity);
+    /// @brief Base function for erasing elements from the buffer.
+    /// @param first Iterator pointing to the first element of the range to erase.
+    /// @param last Iterator pointing to past the last element to erase.
+    /// @return Returns an iterator pointing to the element immediately after the erased elements.
+    /// @pre First and last must be valid iterators to *this.
+    /// @note Moves the side with fewer elements: the elements before first toward the head, or the elements after last toward the tail. Then the tail or head index is moved once.
+    /// @exception If value_types move assignment is NoThrow, function is noexcept. If move assignment throws, behavior is undefined.
+    iterator eraseBase(const_iterator first, const_iterator last)
+    {
+        const size_type index = first.getIndex();
+        const size_type count = std::distance(first, last);
 
-            auto targetSize = size();
-            auto sourceSize = other.size();
+        if (count > 0)
+        {
+            const auto sz = size();
+            const auto after = sz - index - count;
 
-            if (targetSize <= sourceSize)
+            if (index < after)
             {
-                std::copy(other.begin(), other.begin() + targetSize, begin());
-                for (size_type i = size(); i < sourceSize; i++)
-                {
-                    push_back(other[i]);
-                }
+                moveSegments(m_tailIndex, index, count, true, std::is_trivially_copyable<T>());
+                destroySlots(m_tailIndex, count);
+                m_tailIndex = CapacityPolicy::advance(m_tailIndex, count, base::m_capacity);
             }
             else
             {
-                std::copy(other.begin(), other.end(), begin());
-                for (size_type i = sourceSize; i < targetSize; i++)
-                {
-                    pop_back();
-                }
+                moveSegments(CapacityPolicy::advance(m_tailIndex, index + count, base::m_capacity), after, count, false, std::is_trivially_copyable<T>());
+                m_headIndex = CapacityPolicy::retreat(m_headIndex, count, base::m_capacity);
+                destroySlots(m_headIndex, count);
             }
+            stats_collector::countPops(count);
         }
+        return iterator(this, index);
+    }
 
-        return *this;
+    /// @brief Increment an index. The ringbuffer internally increments the head and tail index when adding elements.
+    /// @param index The index to increment.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR void increment(size_t& index) noexcept
+    {
+        // Wrap index around at end of physical memory area.
+        index = CapacityPolicy::advance(index, 1, base::m_capacity);
     }
 
-    /// @brief Move assignment operator.
-    /// @param other Rvalue ref to other buffer.
-    /// @pre value_type is MoveConstructible.
-    /// @post *this has values other had before the assignment.
-    /// @return Reference to the buffer to move from.
-    /// @exception If value_type is not MoveConstructible, and if value_type provides a throwing CopyConstructor this function has undefined behaviour.
+    /// @brief Increments an index multiple times. The ringbuffer internally increments the head and tail index when adding elements.
+    /// @param index Index to increment.
+    /// @param times Amount of increments.
+    /// @pre times < m_capacity.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR void increment(size_t& index, size_t times) noexcept
+    {
+        index = CapacityPolicy::advance(index, times, base::m_capacity);
+    }
+
+    /// @brief Decrements an index. The ringbuffer internally decrements the head and tail index when removing elements.
+    /// @param index The index to decrement.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR void decrement(size_t& index) noexcept
+    {
+        index = CapacityPolicy::retreat(index, 1, base::m_capacity);
+    }
+    
+    /// @brief Decrements an index multiple times. The ringbuffer internally decrements the head and tail index when removing elements.
+    /// @param index Index to decrement.
+    /// @param times Amount of decrements.
+    /// @pre times < m_capacity.
+    /// @details Constant complexity.
+    RING_BUFFER_CONSTEXPR void decrement(size_t& index, size_t times) noexcept
+    {
+        index = CapacityPolicy::retreat(index, times, base::m_capacity);
+    }
+
+    size_type m_headIndex; /*!< Index of the head. Index pointing to past the last element.*/
+    size_type m_tailIndex; /*!< Index of the tail. Index to the first element in the buffer.*/
+    size_type m_reallocations = 0; /*!< Amount of times the elements have been moved to a new memory area.*/
+
+};
+
+/// @brief Ring buffer that keeps its capacity at a power of two, so that indexing uses a bitmask instead of a division.
+/// @tparam T Type of the elements.
+/// @tparam Allocator Allocator used for (de)allocation and (de)construction. Defaults to std::allocator<T>
+template<typename T, typename Allocator = std::allocator<T>>
+using pow2_ring_buffer = ring_buffer<T, Allocator, pow2_capacity_policy>;
+
+/// @brief Ring buffer with a fixed capacity that overwrites its oldest elements when full.
+template<typename T, typename Allocator = std::allocator<T>>
+using overwrite_ring_buffer = ring_buffer<T, Allocator, overwrite_capacity_policy<>>;
+
+/// @brief Ring buffer that stores up to N elements inside the object and allocates memory only beyond that.
+template<typename T, size_t N, typename Allocator = std::allocator<T>>
+using small_ring_buffer = ring_buffer<T, Allocator, small_capacity_policy<N + 1>>;
+
+/// @brief Ring buffer with room for N - 1 elements inside the object, that never allocates. Usable in constant expressions with C++20:
+/// construction, destruction, push, emplace and pop at both ends, clear, element access and iteration are constexpr.
+template<typename T, size_t N, typename Allocator = std::allocator<T>>
+using static_ring_buffer = ring_buffer<T, Allocator, static_capacity_policy<N>>;
+
+/// @brief Ring buffer that collects ring_buffer_statistics.
+template<typename T, typename Allocator = std::allocator<T>>
+using stats_ring_buffer = ring_buffer<T, Allocator, stats_capacity_policy<>>;
+
+/// @brief Ring buffer for bursty workloads. It shrinks to half full after 1024 pops in a row leave it below a quarter of its capacity, and keeps the retired memory as a spare,
+/// so the next burst regrows with a single relocation and without calling the allocator.
+template<typename T, typename Allocator = std::allocator<T>>
+using elastic_ring_buffer = ring_buffer<T, Allocator, hysteresis_capacity_policy<25, 50, 1024, spare_capacity_policy<>>>;
+
+
+/// @brief Lock-free single-producer/single-consumer ring buffer with a fixed capacity.
+/// @tparam T Type of the elements.
+/// @tparam Allocator Allocator used for (de)allocation and (de)construction. Defaults to std::allocator<T>
+/// @note One thread may call the producer functions (try_push, try_emplace, push_n, write_arrays, commit_write) and one other thread the consumer functions
+/// (try_pop, pop_n, read_arrays, commit_read) concurrently. Head and tail indices live on separate cache lines and are synchronized with acquire/release ordering.
+template<typename T, typename Allocator = std::allocator<T>>
+class spsc_ring_buffer : private ring_buffer_base<T, Allocator>
+{
+public:
+
+    using base = ring_buffer_base<T, Allocator>;
+
+    using size_type = typename base::size_type;
+    using allocator_type = typename base::allocator_type;
+    using alloc_traits = typename base::alloc_traits;
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using span = ring_buffer_span<T>;
+    using const_span = ring_buffer_span<const T>;
+
+    /// @brief Constructs an empty buffer that can hold capacity elements.
+    /// @param capacity Maximum amount of elements in the buffer. Never changes.
+    /// @param alloc Custom allocator.
+    /// @throw Can throw std::bad_alloc.
     /// @details Constant complexity.
-    ring_buffer& operator=(ring_buffer&& other) noexcept
+    explicit spsc_ring_buffer(size_type capacity, const allocator_type& alloc = allocator_type())
+        : base(alloc, capacity + 1), m_headIndex(0), m_cachedTail(0), m_tailIndex(0), m_cachedHead(0)
+    {
+    }
+
+    spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+    /// @brief Destructor. Destroys the remaining elements.
+    /// @pre No thread is accessing the buffer.
+    ~spsc_ring_buffer()
     {
-        if (!alloc_traits::propagate_on_container_move_assignment::value && base::m_allocator != other.m_allocator)
+        size_type tail = m_tailIndex.load(std::memory_order_relaxed);
+        const size_type head = m_headIndex.load(std::memory_order_relaxed);
+        for (; tail != head; tail = next(tail))
         {
-            clear();
-
-            _uninitialized_move(other.begin(), other.end(), base::m_data);
+            alloc_traits::destroy(base::m_allocator, base::m_data + tail);
         }
-        else
+    }
+
+    /// @brief Producer. Constructs an element in place to the back of the buffer if there is room.
+    /// @param args Arguments to construct value_type from.
+    /// @return True if the element was added, false if the buffer was full.
+    /// @throw Can throw something from value_type's constructor, in which case the buffer is unchanged.
+    /// @details Constant complexity. Wait-free.
+    template<class... Args>
+    bool try_emplace(Args&&... args)
+    {
+        const size_type head = m_headIndex.load(std::memory_order_relaxed);
+        const size_type nextHead = next(head);
+
+        if (nextHead == m_cachedTail)
         {
-            ring_buffer temp(std::move(other));
-            temp.swap(*this);
+            m_cachedTail = m_tailIndex.load(std::memory_order_acquire);
+            if (nextHead == m_cachedTail)
+            {
+                return false;
+            }
         }
 
-        return *this;
+        alloc_traits::construct(base::m_allocator, base::m_data + head, std::forward<Args>(args)...);
+        m_headIndex.store(nextHead, std::memory_order_release);
+        return true;
     }
 
-    /// @brief Initializer list assign operator. 
-    /// @param init Initializer list to assign to the buffer.
-    /// @return Returns a reference to the buffer.
-    /// @pre T is CopyInsertable.
-    /// @post All existing iterators are invalidated. 
-    /// @note Internally calls assign(), which destroys all elements before CopyInserting from initializer list.
-    /// @details Linear complexity in relation to amount of existing elements and size of initializer list.
-    ring_buffer& operator=(std::initializer_list<T> init)
+    /// @brief Producer. Copies an element to the back of the buffer if there is room.
+    /// @return True if the element was added, false if the buffer was full.
+    bool try_push(const value_type& value)
     {
-        assign(init);
-        return *this;
+        return try_emplace(value);
     }
 
-    /// @brief Index operator.
-    /// @param logicalIndex Index of the element. If LogicalIndex >= size(), this function has undefined behaviour.
-    /// @details Constant complexity.
-    /// @note The operator acts as interface that hides the physical memory layout from the user. Logical index neeeds to be added to internal tail index to get actual element address. 
-    /// @return Returns a reference to the element.
-    reference operator[](const size_type logicalIndex) noexcept
+    /// @brief Producer. Moves an element to the back of the buffer if there is room.
+    /// @return True if the element was added, false if the buffer was full. If false, value is not moved from.
+    bool try_push(value_type&& value)
     {
-        return base::m_data[(m_tailIndex + logicalIndex) % base::m_capacity];
+        return try_emplace(std::move(value));
     }
 
-    /// @brief Index operator.
-    /// @param logicalIndex Index of the element used to access n:th element of the buffer.
-    /// @details Constant complexity
-    /// @note The operator acts as interface that hides the physical memory layout from the user. Logical index neeeds to be added to internal tail index to get actual element address.
-    /// @return Returns a const reference the the element ad logicalIndex.
-    const_reference operator[](const size_type logicalIndex) const noexcept
+    /// @brief Consumer. Moves the first element to value and removes it from the buffer.
+    /// @param value Reference to assign the element to.
+    /// @return True if an element was popped, false if the buffer was empty.
+    /// @throw Can throw something from value_type's move assignment, in which case the element stays in the buffer.
+    /// @details Constant complexity. Wait-free.
+    bool try_pop(value_type& value)
     {
-        return base::m_data[(m_tailIndex + logicalIndex) % base::m_capacity];
-    }
+        const size_type tail = m_tailIndex.load(std::memory_order_relaxed);
 
-    /// @brief Get a specific element of the buffer with bounds checking.
-    /// @param logicalIndex Index of the element.
-    /// @return Returns a reference the the element at index.
-    /// @throw Throws std::out_of_range if index is larger or equal to buffers size.
-    /// @exception If any exceptions is thrown this function has no effect (Strong exception guarantee).
-    /// @details Constant complexity.
-    reference at(size_type logicalIndex)
-    {
-        if(logicalIndex >= size())
+        if (tail == m_cachedHead)
         {
-            throw std::out_of_range("Index is out of range");
+            m_cachedHead = m_headIndex.load(std::memory_order_acquire);
+            if (tail == m_cachedHead)
+            {
+                return false;
+            }
         }
 
-        auto index = m_tailIndex + logicalIndex;
+        value = std::move(base::m_data[tail]);
+        alloc_traits::destroy(base::m_allocator, base::m_data + tail);
+        m_tailIndex.store(next(tail), std::memory_order_release);
+        return true;
+    }
 
-        if(base::m_capacity <= index)
-        {
-            index -= base::m_capacity;
-        }
-        return base::m_data[index];
+    /// @brief Producer. Copies up to count elements from source to the back of the buffer.
+    /// @param source Pointer to the first element to copy.
+    /// @param count Amount of elements available in source.
+    /// @return Amount of elements copied, less than count if the buffer got full.
+    /// @pre value_type must be trivially copyable.
+    /// @details Linear complexity in relation to the amount of copied elements. Elements are copied with at most two memcpy calls.
+    size_type push_n(const_pointer source, size_type count) noexcept
+    {
+        auto arrays = write_arrays();
+        const auto firstCount = std::min(count, arrays.first.size());
+        const auto secondCount = std::min(count - firstCount, arrays.second.size());
+
+        copySegment(arrays.first.data(), source, firstCount);
+        copySegment(arrays.second.data(), source + firstCount, secondCount);
+
+        commit_write(firstCount + secondCount);
+        return firstCount + secondCount;
     }
 
-    /// @brief Get a specific element of the buffer.
-    /// @param logicalIndex Index of the element.
-    /// @return Returns a const reference the the element at index.
-    /// @throw Throws std::out_of_range if index is larger or equal to buffers size.
-    /// @exception If any exceptions is thrown this function has no effect (Strong exception guarantee).
+    /// @brief Consumer. Copies up to count elements from the front of the buffer to out and removes them.
+    /// @param out Pointer to memory where the elements are copied.
+    /// @param count Maximum amount of elements to pop.
+    /// @return Amount of elements popped, less than count if the buffer got empty.
+    /// @pre value_type must be trivially copyable.
+    /// @details Linear complexity in relation to the amount of popped elements. Elements are copied with at most two memcpy calls.
+    size_type pop_n(pointer out, size_type count) noexcept
+    {
+        auto arrays = read_arrays();
+        const auto firstCount = std::min(count, arrays.first.size());
+        const auto secondCount = std::min(count - firstCount, arrays.second.size());
+
+        copySegment(out, arrays.first.data(), firstCount);
+        copySegment(out + firstCount, arrays.second.data(), secondCount);
+
+        commit_read(firstCount + secondCount);
+        return firstCount + secondCount;
+    }
+
+    /// @brief Producer. Gets the free memory as at most two contiguous segments, which the producer may write to directly.
+    /// @return Pair of views to uninitialized memory, in the order the slots are taken into use.
+    /// @pre value_type must be trivially copyable.
+    /// @note Written slots are published to the consumer with commit_write().
     /// @details Constant complexity.
-    const_reference at(size_type logicalIndex) const
+    std::pair<span, span> write_arrays() noexcept
     {
-        if(logicalIndex >= size())
+        static_assert(std::is_trivially_copyable<T>::value, "write_arrays requires a trivially copyable value_type");
+
+        const size_type head = m_headIndex.load(std::memory_order_relaxed);
+        m_cachedTail = m_tailIndex.load(std::memory_order_acquire);
+        const size_type tail = m_cachedTail;
+
+        // One slot before tail is always kept free to distinguish a full buffer from an empty one.
+        if (head < tail)
         {
-            throw std::out_of_range("Index is out of range.");
+            return { span(base::m_data + head, tail - head - 1), span() };
         }
-
-        auto index(m_tailIndex + logicalIndex);
-        if(base::m_capacity <= index)
+        if (tail == 0)
         {
-            index -= base::m_capacity;
+            return { span(base::m_data + head, base::m_capacity - head - 1), span() };
         }
-        return base::m_data[index];
+        return { span(base::m_data + head, base::m_capacity - head), span(base::m_data, tail - 1) };
     }
 
-    /// @brief Member swap implementation. Swaps RingBuffers member to member.
-    /// @param other Reference to a ring_buffer to swap with.
+    /// @brief Producer. Publishes count slots written through write_arrays() to the consumer.
+    /// @param count Amount of written slots. Must not exceed the size of the arrays returned by the last write_arrays().
     /// @details Constant complexity.
-    /// @note Requires allocator_type to return true_type from propagate_on_container_swap, otherwise memory operations 
-    void swap(ring_buffer& other) noexcept
+    void commit_write(size_type count) noexcept
     {
-        using std::swap;
-        if (alloc_traits::propagate_on_container_swap::value)
-        {
-            swap(base::m_allocator, other.m_allocator);
-        }
-
-        swap(base::m_data, other.m_data);
-        swap(base::m_capacity, other.m_capacity);
-        swap(m_headIndex, other.m_headIndex);
-        swap(m_tailIndex, other.m_tailIndex);
+        const size_type head = m_headIndex.load(std::memory_order_relaxed);
+        m_headIndex.store(advance(head, count), std::memory_order_release);
     }
 
-    /// @brief Friend swap.
-    /// @param a Swap candidate.
-    /// @param b Swap candidate.
+    /// @brief Consumer. Gets the elements as at most two contiguous segments in order.
+    /// @return Pair of views to the elements that are available to the consumer.
+    /// @note Read elements are released to the producer with commit_read().
     /// @details Constant complexity.
-    friend void swap(ring_buffer& a, ring_buffer& b) noexcept
+    std::pair<const_span, const_span> read_arrays() noexcept
     {
-        a.swap(b);
+        const size_type tail = m_tailIndex.load(std::memory_order_relaxed);
+        m_cachedHead = m_headIndex.load(std::memory_order_acquire);
+        const size_type head = m_cachedHead;
+
+        if (tail <= head)
+        {
+            return { const_span(base::m_data + tail, head - tail), const_span() };
+        }
+        return { const_span(base::m_data + tail, base::m_capacity - tail), const_span(base::m_data, head) };
     }
 
-	/// @brief Sorts ringbuffer so that logical tail matches the first element in physical memory.
-    /// @return Returns a pointer to the first element.
-    /// @pre T must meet MoveInsertable, or CopyInsertable.
-    /// @post &this[0] == m_data.
-    /// @throw Can throw std::bad_alloc.
-    /// @exception If T's Move (or copy in case T does not provide Move Semantics) constructor throws, behaviour is undefined. Otherwise if exceptions are thrown (std::bad_alloc) this function has no effect (Strong exception guarantee).
-    /// @note Invalidates all existing pointers and references.
-    /// @details Linear complexity in relation to buffer size.
-    pointer data()
+    /// @brief Consumer. Destroys count elements from the front and releases their slots to the producer.
+    /// @param count Amount of elements to release. Must not exceed the size of the arrays returned by the last read_arrays().
+    /// @details Linear complexity in relation to count for destructing the elements, tail index is published once.
+    void commit_read(size_type count) noexcept
     {
-        if(!size())
+        size_type tail = m_tailIndex.load(std::memory_order_relaxed);
+        const size_type newTail = advance(tail, count);
+        for (size_type i = 0; i < count; ++i, tail = next(tail))
         {
-            m_headIndex = 0;
-            m_tailIndex = 0;
-            return base::m_data;
+            alloc_traits::destroy(base::m_allocator, base::m_data + tail);
         }
-
-        base temp = {base::m_allocator, base::m_capacity};
-        _uninitialized_move(begin(), end(), temp.m_data);
-        base::swap(*this, temp);
-
-        m_headIndex = size();
-        m_tailIndex = 0;
-
-        return base::m_data;
+        m_tailIndex.store(newTail, std::memory_order_release);
     }
 
-    /// @brief Gets the size of the container.
-    /// @return Size of buffer.
+    /// @brief Gets the amount of elements in the buffer.
+    /// @note The value is only a snapshot if the other thread is modifying the buffer concurrently.
     /// @details Constant complexity.
     size_type size() const noexcept
     {
-        if(m_headIndex < m_tailIndex)
-        {
-            return m_headIndex + base::m_capacity - m_tailIndex;
-        }
-
-        return m_headIndex - m_tailIndex;
+        const size_type head = m_headIndex.load(std::memory_order_acquire);
+        const size_type tail = m_tailIndex.load(std::memory_order_acquire);
+        return head < tail ? head + base::m_capacity - tail : head - tail;
     }
 
-    /// @brief Gets the theoretical maximum size of the container.
-    /// @return Maximum size of the buffer.
-    /// @details Constant complexity.
-    size_type max_size() const noexcept
+    /// @brief Check if the buffer is empty.
+    /// @note The value is only a snapshot if the other thread is modifying the buffer concurrently.
+    bool empty() const noexcept
     {
-        constexpr auto maxSize = std::numeric_limits<std::size_t>::max();
-        return maxSize / sizeof(T);
+        return m_headIndex.load(std::memory_order_acquire) == m_tailIndex.load(std::memory_order_acquire);
     }
 
-    /// @brief Capacity getter.
-    /// @return m_capacity Returns how many elements have been allocated for the buffers use. 
+    /// @brief Maximum amount of elements the buffer can hold.
     /// @details Constant complexity.
     size_type capacity() const noexcept
     {
-        return base::m_capacity;
+        return base::m_capacity - 1;
     }
 
     /// @brief Allocator getter.
-    /// @return Return the allocator used by the container.
-    /// @details Constant complexity.
     allocator_type get_allocator() const noexcept
     {
         return base::m_allocator;
     }
 
-    /// @brief Check if buffer is empty
-    /// @return True if buffer is empty
-    /// @details Constant complexity.
-    bool empty() const noexcept
-    {
-        return m_tailIndex == m_headIndex;
-    }
+private:
 
-    /// @brief Allocates memory and copies the existing buffer to the new memory location. Can be used to increase or decrease capacity.
-    /// @throw Throws std::bad_alloc if there is not enough memory for allocation. Throws std::bad_array_new_lenght if std::numeric_limits<std::size_t>::max() / sizeof(T) < newsize.
-    /// @param newCapacity Amount of memory to allocate. If newCapacity is less than or equal to m_capacity, function does nothing.
-    /// @param enableShrink True to enable reserve to reduce the capacity, to a minimum of size() +2.
-    /// @pre T must meet MoveInsertable.
-    /// @throw Can throw std::bad_alloc. 
-    /// @exception If T's move (or copy if T has no move) constructor throws, behaviour is undefined. Otherwise Stong Exception Guarantee.
-    /// @note All references, pointers and iterators are invalidated. If memory is allocated, the memory layout is rotated so that first element matches the beginning of physical memory.
-    /// @details Linear complexity in relation to size of the buffer (O(n)).
-    void reserve(size_type newCapacity, bool enableShrink = false)
+    size_type next(size_type index) const noexcept
     {
-        if (enableShrink)
-        {
-            if (newCapacity < size() + allocBuffer) return;
-        }
-        else
-        {
-            if (newCapacity <= base::m_capacity) return;
-        }
-
-        base temp = {base::m_allocator, newCapacity};
-
-        if (std::is_nothrow_move_constructible<value_type>::value)
-        {
-            size_type first = 0;
-            size_type current = 0;
-
-            try
-            {
-                for (size_t i = 0; i < size(); i++)
-                {
-                    alloc_traits::construct(base::m_allocator, temp.m_data + current, std::move(this->operator[](i)));
-                    current++;
-                }
-            }
-            catch (...)
-            {
-                for (; first != current; first++)
-                {
-                    alloc_traits::destroy(base::m_allocator, base::m_data + first);
-                }
-                m_headIndex = 0;
-                m_tailIndex = 0;
-                throw;
-            }
-        }
-        else
-        {
-            std::uninitialized_copy(begin(), end(), temp.m_data);
-        }
-        
-        m_headIndex = this->size();
-        m_tailIndex = 0;
-
-        base::swap(*this, temp);
+        return ++index == base::m_capacity ? 0 : index;
     }
 
-    /// @brief Inserts an element in the back of the buffer. 
-    /// @note If buffer would get full after the operation, function allocates more memory.
-    /// @throw Can throw std::bad_alloc.
-    /// @param val Element to insert.
-    /// @pre T must satisfy CopyInsertable.
-    /// @post All iterators are invalidated. If more memory is allocated, all pointers and references are invalidated.
-    /// @exception If the copy constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
-    /// @details Amortized constant complexity.
-    void push_front(const value_type& val)
+    size_type advance(size_type index, size_type count) const noexcept
     {
-        emplace_front(val);
+        return default_capacity_policy::advance(index, count, base::m_capacity);
     }
 
-    /// @brief Inserts an element in the back of the buffer by move if move constructor is provided by value_type.
-    /// @note If buffer would get full after the operation, allocates more memory.
-    /// @throw Can throw std::bad_alloc.
-    /// @param val Rvalue reference to the element to insert.
-    /// @pre value_type needs to satisfy MoveInsertable.
-    /// @post All iterators are invalidated. If more memory is allocated, all pointers and references are invalidated.
-    /// @exception If the move constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
-    /// @details Amortized constant complexity.
-    void push_front(value_type&& val)
+    static void copySegment(pointer dest, const_pointer source, size_type count) noexcept
     {
-        emplace_front(std::move(val));
+        static_assert(std::is_trivially_copyable<T>::value, "bulk operations require a trivially copyable value_type");
+        if (count)
+        {
+            std::memcpy(dest, source, count * sizeof(T));
+        }
     }
 
-    /// @brief Inserts an element in the back of the buffer.
-    /// @param val Value of T to be appended.
-    /// @note If buffer would get full after the operation, allocates more memory.
-    /// @throw Can throw std::bad_alloc.
-    /// @exception If the copy constructor of value_type throws, behaviour is undefined. Otherwise in case of exception this function has no effect (Strong Exception Guarantee).
-    /// @pre value_type must satisfy CopyInsertable.
-    /// @post If more memory is allocated all pointers, iterators and references are invalidated.
-    /// @details Amoprtized constant complexity.
-    void push_back(const value_type& val)
-    {
-        emplace_back(val);
-    }
+    // Producer cache line: head is written by the producer, cached tail avoids reading the consumer's cache line on every push.
+    alignas(cacheLineSize) std::atomic<size_type> m_headIndex; /*!< Index past the last element. Written by the producer.*/
+    size_type m_cachedTail; /*!< Producer's last seen value of m_tailIndex.*/
 
-    /// @brief Inserts an element in the back of the buffer by move if move constructor is provided for value_type.
-    /// @note  If buffer would get full after the operation more memory is allocated.
-    /// @param val Rvalue reference to the value to be appended.
-    /// @throw Can throw std::bad_alloc.
-    /// @exception If the move/copy constructor of value_type throws, behaviour is undefined. Otherwise in case of any exception this function has no effect (Strong Exception Guarantee).
-    /// @pre value_type needs to satisfy MoveInsertable.
-    /// @post If more memory is allocated all pointers, iterators and references are invalidated.
-    /// @details Amortized constant complexity.
-    void push_back(value_type&& val)
-    {
-        emplace_back(std::move(val));
-    }
+    // Consumer cache line. The alignment also rounds the size of the class up to whole cache lines, which keeps members that follow this object off of it.
+    alignas(cacheLineSize) std::atomic<size_type> m_tailIndex; /*!< Index of the first element. Written by the consumer.*/
+    size_type m_cachedHead; /*!< Consumer's last seen value of m_headIndex.*/
+};
 
-    /// @brief Remove the first element in the buffer.
-    /// @pre Buffers size > 0, otherwise behaviour is undefined.
-    /// @post All iterators, pointers and references are invalidated.
-    /// @details Constant complexity.
-    void pop_front() noexcept
-    {
-        alloc_traits::destroy(base::m_allocator, base::m_data + m_tailIndex);
-        increment(m_tailIndex);
-    }
+/// @brief Slot of mpmc_ring_buffer. The sequence number tells which lap of the ring the slot is in and whether it holds an element.
+template<typename T>
+struct mpmc_slot
+{
+    std::atomic<size_t> m_sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
 
-    /// @brief Erase an element from the logical back of the buffer.
-    /// @pre Buffers size > 0, otherwise behaviour is undefined.
-    /// @post All pointers and references are invalidated. Iterators persist except end() - 1 iterator is invalidated (it becomes new past-the-last iterator).
-    /// @details Constant complexity.
-    void pop_back() noexcept
-    {
-        decrement(m_headIndex);
-        alloc_traits::destroy(base::m_allocator, base::m_data + m_headIndex);
+    explicit mpmc_slot(size_t sequence) noexcept : m_sequence(sequence) {}
 
-    }
+    T* value() noexcept { return reinterpret_cast<T*>(&m_storage); }
+};
 
-    /// @brief Releases unused allocated memory. 
-    /// @pre T must satisfy MoveConstructible or CopyConstructible.
-    /// @post m_capacity == size() + allocBuffer.
-    /// @note Reduces capacity by allocating a smaller memory area and moving the elements. Shrinking the buffer invalidates all pointers, iterators and references.
-    /// @throw Might throw std::bad_alloc if memory allocation fails.
-    /// @exception If T's move (or copy) constructor can and does throw, behaviour is undefined. If any other exception is thrown (bad_alloc) this function has no effect (Strong exception guarantee).
-    /// @details Linear complexity in relation to size of the buffer.
-    void shrink_to_fit()
-    {
-        reserve(size() + allocBuffer, true);
-    }
+/// @brief Bounded lock-free multi-producer/multi-consumer ring buffer (Vyukov queue).
+/// @tparam T Type of the elements.
+/// @tparam Allocator Allocator used for (de)allocation and (de)construction. Defaults to std::allocator<T>
+/// @note Any number of threads may push and pop concurrently. Each slot carries a sequence number, so producers and consumers only contend on
+/// their own index with a single compare-and-swap and then on the slot they claimed. Capacity is fixed and rounded up to a power of two.
+template<typename T, typename Allocator = std::allocator<T>>
+class mpmc_ring_buffer : private ring_buffer_base<mpmc_slot<T>, typename std::allocator_traits<Allocator>::template rebind_alloc<mpmc_slot<T>>>
+{
+public:
 
-//===========================================================
-//  std::queue adaptor functions
-//===========================================================
+    using slot_type = mpmc_slot<T>;
+    using base = ring_buffer_base<slot_type, typename std::allocator_traits<Allocator>::template rebind_alloc<slot_type>>;
 
-    /// @brief Returns a reference to the first element in the buffer. Behaviour is undefined for empty buffer.
-    /// @return Reference to the first element.
-    /// @details Constant complexity.
-    reference front() noexcept
-    {
-        return base::m_data[m_tailIndex];
-    }
+    using size_type = typename base::size_type;
+    using allocator_type = Allocator;
+    using alloc_traits = std::allocator_traits<allocator_type>;
+    using slot_traits = typename base::alloc_traits;
 
-    /// @brief Returns a reference to the first element in the buffer. Behaviour is undefined for empty buffer.
-    /// @return const_reference to the first element.
-    /// @details Constant complexity.
-    const_reference front() const noexcept
-    {
-        return base::m_data[m_tailIndex];
-    }
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
 
-    /// @brief Returns a reference to the last element in the buffer. Behaviour is undefined for empty buffer.
-    /// @return Reference to the last element in the buffer.
-    /// @details Constant complexity.
-    reference back() noexcept
+    /// @brief Constructs an empty buffer that can hold at least capacity elements.
+    /// @param capacity Minimum amount of elements in the buffer. Rounded up to a power of two, at least 2.
+    /// @param alloc Custom allocator.
+    /// @throw Can throw std::bad_alloc.
+    /// @details Linear complexity in relation to capacity for initializing the slot sequence numbers.
+    explicit mpmc_ring_buffer(size_type capacity, const allocator_type& alloc = allocator_type())
+        : base(typename base::allocator_type(alloc), pow2_capacity_policy::fit(std::max<size_type>(capacity, 2))), m_valueAllocator(alloc),
+          m_mask(base::m_capacity - 1), m_enqueueIndex(0), m_dequeueIndex(0)
     {
-        // Since head points to next-to-last element, it needs to be decremented once to get the correct element. 
-        // If the index is at the beginning border of the allocated memory area it needs to be wrapped around to the end. 
-        if (m_headIndex == 0)
+        for (size_type i = 0; i < base::m_capacity; ++i)
         {
-            return base::m_data[base::m_capacity - 1];
+            slot_traits::construct(base::m_allocator, base::m_data + i, i);
         }
-        return base::m_data[m_headIndex-1];
     }
 
-    /// @brief Returns a const-reference to the last element in the buffer. Behaviour is undefined for empty buffer.
-    /// @return const_reference to the last element in the buffer.
-    /// @details Constant complexity.
-    const_reference back() const noexcept
+    mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+    mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+    /// @brief Destructor. Destroys the remaining elements.
+    /// @pre No thread is accessing the buffer.
+    ~mpmc_ring_buffer()
     {
-        // Since head points to next-to-last element, it needs to be decremented once to get the correct element. 
-        // If the index is at the beginning border of the allocated memory area it needs to be wrapped around to the end. 
-        if (m_headIndex == 0)
+        const size_type last = m_enqueueIndex.load(std::memory_order_relaxed);
+        for (size_type pos = m_dequeueIndex.load(std::memory_order_relaxed); pos != last; ++pos)
         {
-            return base::m_data[base::m_capacity - 1];
+            alloc_traits::destroy(m_valueAllocator, base::m_data[pos & m_mask].value());
+        }
+        for (size_type i = 0; i < base::m_capacity; ++i)
+        {
+            slot_traits::destroy(base::m_allocator, base::m_data + i);
         }
-        return base::m_data[m_headIndex-1];
     }
 
-    /// @brief Construct iterator at begin.
-    /// @return Iterator pointing to first element.
-    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
-    iterator begin() noexcept
+    /// @brief Constructs an element in place to the back of the buffer if there is room.
+    /// @param args Arguments to construct value_type from.
+    /// @return True if the element was added, false if the buffer was full.
+    /// @throw Can throw something from value_type's constructor, in which case the buffer is unchanged.
+    /// @exception If value_type is not nothrow constructible from args, a temporary is constructed before claiming a slot and then moved in.
+    /// The move constructor must not throw in that case, a claimed slot can't be given back.
+    /// @details Constant complexity. Lock-free.
+    template<class... Args>
+    bool try_emplace(Args&&... args)
     {
-        return iterator(this, 0);
+        return emplaceBase(std::is_nothrow_constructible<value_type, Args&&...>{}, std::forward<Args>(args)...);
     }
 
-    /// @brief Construct const_iterator at begin.
-    /// @return Const_iterator pointing to first element.
-    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
-    const_iterator begin() const noexcept
+    /// @brief Copies an element to the back of the buffer if there is room.
+    /// @return True if the element was added, false if the buffer was full.
+    bool try_push(const value_type& value)
     {
-        return const_iterator(this, 0);
+        return try_emplace(value);
     }
 
-    /// @brief Construct iterator at end.
-    /// @return Iterator pointing past last element.
-    /// @details Constant complexity.
-    iterator end() noexcept
+    /// @brief Moves an element to the back of the buffer if there is room.
+    /// @return True if the element was added, false if the buffer was full. If false, value is not moved from.
+    /// @exception value is moved straight into the claimed slot, so value_type's move constructor must not throw, a claimed slot can't be given back.
+    bool try_push(value_type&& value)
     {
-        return iterator(this, size());
+        return emplaceBase(std::true_type{}, std::move(value));
     }
 
-    /// @brief Construct const_iterator at end.
-    /// @return Const_iterator pointing past last element.
-    /// @details Constant complexity.
-    const_iterator end() const noexcept
+    /// @brief Moves an element to the back of the buffer, waiting until there is room.
+    /// @details Spins and then yields the thread while the buffer is full. Only the slot claim is retried, value is moved once a slot is claimed.
+    void push(value_type value)
     {
-        return const_iterator(this, size());
+        waitFor([&]() { return emplaceBase(std::true_type{}, std::move(value)); });
     }
 
-    /// @brief Construct const_iterator at begin.
-    /// @return Const_iterator pointing to first element.
-    /// @details Constant complexity.
-    const_iterator cbegin() const noexcept
+    /// @brief Moves an element to the back of the buffer, waiting at most timeout for room.
+    /// @param value Element to push. Not moved from if the push times out.
+    /// @param timeout Maximum time to wait.
+    /// @return True if the element was added, false if the buffer stayed full for the whole timeout.
+    /// @exception See try_push(value_type&&).
+    template<class Rep, class Period>
+    bool try_push_for(value_type&& value, const std::chrono::duration<Rep, Period>& timeout)
     {
-        return const_iterator(this, 0);
+        return waitUntil([&]() { return emplaceBase(std::true_type{}, std::move(value)); }, std::chrono::steady_clock::now() + timeout);
     }
 
-    /// @brief Construct const_iterator pointing to past the last element.
-    /// @return Const_iterator pointing past last element.
-    /// @details Constant complexity.
-    const_iterator cend() const noexcept
+    /// @brief Copies an element to the back of the buffer, waiting at most timeout for room.
+    /// @return True if the element was added, false if the buffer stayed full for the whole timeout.
+    template<class Rep, class Period>
+    bool try_push_for(const value_type& value, const std::chrono::duration<Rep, Period>& timeout)
     {
-        return const_iterator(this, size());
+        return waitUntil([&]() { return try_emplace(value); }, std::chrono::steady_clock::now() + timeout);
     }
 
-    /// @brief Get a reverse iterator pointing to the first element in reverse order (last element in normal order).
-    /// @return reverse_iterator pointing to first element in reverse order.
-    /// @details Constant complexity. Iterator is invalid if the buffer is empty (dereferencing points to uninitialized memory.).
-    reverse_iterator rbegin()
+    /// @brief Moves the first element to value and removes it from the buffer.
+    /// @param value Reference to assign the element to.
+    /// @return True if an element was popped, false if the buffer was empty.
+    /// @exception value_type's move assignment should not throw, the element is destroyed and its slot released regardless.
+    /// @details Constant complexity. Lock-free.
+    bool try_pop(value_type& value)
     {
-        return reverse_iterator(end());
+        size_type pos = m_dequeueIndex.load(std::memory_order_relaxed);
+        slot_type* slot;
+        for (;;)
+        {
+            slot = base::m_data + (pos & m_mask);
+            const size_type sequence = slot->m_sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0)
+            {
+                if (m_dequeueIndex.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeueIndex.load(std::memory_order_relaxed);
+            }
+        }
+
+        struct release_slot
+        {
+            slot_type* slot;
+            size_type sequence;
+            ~release_slot() { slot->m_sequence.store(sequence, std::memory_order_release); }
+        } release{ slot, pos + m_mask + 1 };
+
+        value = std::move(*slot->value());
+        alloc_traits::destroy(m_valueAllocator, slot->value());
+        return true;
     }
 
-    /// @brief Get a const reverse iterator pointing to the first element in reverse order (last element in normal order).
-    /// @return const_reverse_iterator pointing to the first element in reverse order.
-    /// @details Constant complexity.
-    const_reverse_iterator rbegin() const
+    /// @brief Removes the first element, waiting until there is one.
+    /// @param value Reference to assign the element to.
+    /// @details Spins and then yields the thread while the buffer is empty.
+    void pop(value_type& value)
     {
-        return const_reverse_iterator(end());
+        waitFor([&]() { return try_pop(value); });
     }
 
-    /// @brief Get a const reverse iterator pointing to the first element in reverse order (last element in normal order).
-    /// @details Constant complexity.
-    /// @return const_reverse_iterator pointing to the first element in reverse order.
-    const_reverse_iterator crbegin() const
+    /// @brief Removes the first element, waiting at most timeout for one.
+    /// @param value Reference to assign the element to.
+    /// @param timeout Maximum time to wait.
+    /// @return True if an element was popped, false if the buffer stayed empty for the whole timeout.
+    template<class Rep, class Period>
+    bool try_pop_for(value_type& value, const std::chrono::duration<Rep, Period>& timeout)
     {
-        return const_reverse_iterator(end());
+        return waitUntil([&]() { return try_pop(value); }, std::chrono::steady_clock::now() + timeout);
     }
 
-    /// @brief Get a reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
-    /// @details Constant complexity.
-    /// @return reverse_iterator pointing to one past the last element in reverse order.
-    reverse_iterator rend()
+    /// @brief Gets the approximate amount of elements in the buffer.
+    /// @note The value is only a snapshot while other threads are modifying the buffer, and can briefly count claimed but unfinished pushes and pops.
+    size_type size() const noexcept
     {
-        return reverse_iterator(begin());
+        const size_type tail = m_dequeueIndex.load(std::memory_order_acquire);
+        const size_type head = m_enqueueIndex.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(head - tail);
+        return diff > 0 ? std::min(static_cast<size_type>(diff), base::m_capacity) : 0;
     }
 
-    /// @brief Get a const reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
-    /// @details Constant complexity.
-    /// @return const_reverse_iterator pointing to one past the last element in reverse order.
-    const_reverse_iterator rend() const
+    /// @brief Check if the buffer is approximately empty. See size().
+    bool empty() const noexcept
     {
-        return const_reverse_iterator(begin());
+        return size() == 0;
     }
 
-    /// @brief Get a const reverse iterator pointing to one past the last element in reverse order (one before the first element in normal order).
-    /// @details Constant complexity.
-    /// @return const_reverse_iterator pointing to one past the last element in reverse order.
-    const_reverse_iterator crend() const
+    /// @brief Maximum amount of elements the buffer can hold.
+    size_type capacity() const noexcept
     {
-        return const_reverse_iterator(begin());
+        return base::m_capacity;
     }
 
+    /// @brief Allocator getter.
+    allocator_type get_allocator() const noexcept
+    {
+        return m_valueAllocator;
+    }
 
 private:
-     
-    explicit ring_buffer(base&& rBufBase) : base(std::forward<base>(rBufBase)), m_headIndex(0), m_tailIndex(0)
+
+    template<class... Args>
+    bool emplaceBase(std::true_type, Args&&... args)
     {
+        size_type pos;
+        slot_type* slot = claimEnqueue(pos);
+        if (!slot)
+        {
+            return false;
+        }
+        alloc_traits::construct(m_valueAllocator, slot->value(), std::forward<Args>(args)...);
+        slot->m_sequence.store(pos + 1, std::memory_order_release);
+        return true;
     }
 
-    void destroy_elements() noexcept
+    // Constructs the element before claiming a slot, so a throwing constructor leaves the buffer unchanged. The pushes taking an rvalue
+    // retry the nothrow claim with the caller's value instead, a temporary here would steal it on every attempt that finds the buffer full.
+    template<class... Args>
+    bool emplaceBase(std::false_type, Args&&... args)
     {
-        for_each(begin(), end(), [this](T& elem) { alloc_traits::destroy(base::m_allocator, &elem); });
+        value_type temp(std::forward<Args>(args)...);
+        return emplaceBase(std::true_type{}, std::move(temp));
     }
 
-
-    ///@note MUST HAVE NOTHROW MOVE CONSTRUCTION!!! Otherwise in case of exception leaves container in unspecified state.
-    template<typename InputIt, typename NoThrowForwardIt>
-    NoThrowForwardIt _uninitialized_move(InputIt first, InputIt last, NoThrowForwardIt dest_first)
+    // Claims the slot at the enqueue index for the calling thread. Returns nullptr if the buffer is full.
+    slot_type* claimEnqueue(size_type& pos) noexcept
     {
-        NoThrowForwardIt current = dest_first;
-
-        try
+        pos = m_enqueueIndex.load(std::memory_order_relaxed);
+        for (;;)
         {
-            for (size_t i = 0; first != last; ++first, (void)++current)
+            slot_type* slot = base::m_data + (pos & m_mask);
+            const size_type sequence = slot->m_sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0)
+            {
+                if (m_enqueueIndex.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    return slot;
+                }
+            }
+            else if (diff < 0)
             {
-                alloc_traits::construct(base::m_allocator, current, std::move(*first));
+                return nullptr;
             }
-            
-        }
-        catch (...)
-        {
-            for (; dest_first != current; dest_first)
+            else
             {
-                alloc_traits::destroy(base::m_allocator, dest_first);
+                pos = m_enqueueIndex.load(std::memory_order_relaxed);
             }
-
-            throw;
         }
-        return current;
     }
 
-    /// @brief Reserves more memory if needed for an increase in size. If more memory is needed, allocates (capacity * 1.5) or if that is not enough (capacity * 1.5 + increase).
-    /// @param increase Expected increase in size of the buffer, based on which memory is allocated.
-    /// @details Linear complexity in relation to buffer size if more memory needs to be allocated, otherwise constant complexity.
-    /// @exception May throw std::bad_alloc. If any exception is thrown this function does nothing. Strong exception guarantee.
-    /// @note This function should be called before increasing the size of the buffer.
-    void validateCapacity(size_t increase)
+    template<class Function>
+    static void waitFor(Function&& attempt)
     {
-        if (base::m_capacity > size() + increase + allocBuffer) return;
-
-        reserve(base::m_capacity / 2 + base::m_capacity + allocBuffer);
+        for (unsigned spins = 0; !attempt(); ++spins)
+        {
+            backoff(spins);
+        }
     }
 
-    /// @brief Base function for inserting elements by value and amount.
-    /// @tparama U value type of the inserted element.
-    /// @param pos Iterator pointing to the element where after insert new element will exist.
-    /// @param count Amount of elements to insert.
-    /// @param value Universal reference of value to insert.
-    /// @pre T Must satisfy CopyInsertable or MoveInsertable.
-    /// @return Returns iterator pointing to the first element inserted.
-    /// @throw Might throw std::bad_alloc from allocating memory, or something from T's move/copy constructor.
-    /// @exception  If any exception is thrown, function has no effect (Strong exception guarantee).
-    /// @details Linear complexity in relation to buffer size and inserted elements. O(n).
-    template<typename U>
-    iterator insertBase(const_iterator pos, const size_type count, U&& value)
+    template<class Function>
+    static bool waitUntil(Function&& attempt, std::chrono::steady_clock::time_point deadline)
     {
-        if (pos == end())
+        for (unsigned spins = 0; !attempt(); ++spins)
         {
-            emplace_back(std::forward<U>(value));
-            return iterator(this, pos.getIndex());
-        }
-        else if (pos == begin())
-        {
-            emplace_front(std::forward<U>(value));
-            return iterator(this, pos.getIndex());
-        }
-
-        if (base::m_capacity < size() + count + allocBuffer)
-        {   
-            //Reallocate and move whole buffer. Strong guarantee
-            base tempCore(base::m_allocator, base::m_capacity * 3 / 2 );
-            ring_buffer temp(std::move(tempCore));
-
-            // Copy elements up to pos
-            std::uninitialized_copy(cbegin(), pos, temp.m_data);
-            temp.m_headIndex = std::distance(cbegin(), pos);
-
-            // Insert the element(s)
-            for (size_type i = 0; i < count; i++)
+            if (std::chrono::steady_clock::now() >= deadline)
             {
-                alloc_traits::construct(temp.m_allocator, temp.m_data + temp.m_headIndex, std::forward<U>(value));
-                ++temp.m_headIndex;
+                return false;
             }
-
-            // Copy elements after pos
-            std::uninitialized_copy(pos, cend(), temp.m_data + temp.m_headIndex);
-            temp.m_headIndex += std::distance(pos, cend());
-
-            // Swap whole buffer.
-            swap(temp);
-            return iterator(this, pos.getIndex());
-        }
-        else
-        {
-        // Not at end, provide basic guarantee.
-            iterator it(this, pos.getIndex());
-
-            //Construct temporary
-            _alloc_temp<Allocator> tempObj(base::m_allocator, std::forward<U>(value));
-
-            //Provide basic guarantee. TODO optimize to move toward closer end.
-            auto last = end();
-            alloc_traits::construct(base::m_allocator, &*last, std::move(*(last - 1)));
-            increment(m_headIndex);
-            std::move_backward(it, last - 1, last);
-
-            *it = std::move(tempObj._getValue());
-
-            return it;
+            backoff(spins);
         }
+        return true;
     }
 
-    /// @brief Base function for inserting elements from a range of [rangeBegin, rangeEnd).
-    /// @tparam OutputIt type of the source ranges output iterator.
-    /// @param pos Iterator pointing to the element where after insert new element will exist.
-    /// @param rangeBegin Iterator pointing to the first element of the range.
-    /// @param rangeEnd Iterator pointing past the last element to be inserted.
-    /// @return Returns iterator pointing to the first element inserted.
-    /// @pre value_type must meet CopyInsertable. InputIt must be deferencable to value_type, and incrementing rangeBegin possibly multiple times should reach rangeEnd. Otherwise behaviour is undefined.
-    /// @post Each iterator in [rangeBegin, rangeEnd) is dereferenced once.
-    /// @throw Might throw std::bad_alloc from allocating memory and rotate(), or something from T's move/copy constructor.
-    /// @exception  If any exception is thrown, invariants are retained. (Basic Exception guarantee).
-    /// @details Linear Complexity in relation to amount of inserted elements (O(n*2) from element construction and rotation).
-    template<typename OutputIt>
-    iterator insertRangeBase(const_iterator pos, OutputIt rangeBegin, OutputIt rangeEnd)
+    // Busy waits for a short while before giving the time slice away.
+    static void backoff(unsigned spins) noexcept
     {
-        const auto amount = std::distance<OutputIt>(rangeBegin, rangeEnd);
+        if (spins >= 64)
+        {
+            std::this_thread::yield();
+        }
+    }
 
-        base tempCore(base::m_allocator, base::m_capacity < size() + amount + allocBuffer ? base::m_capacity * 3 / 2 : base::m_capacity);
-        ring_buffer temp(std::move(tempCore));
+    allocator_type m_valueAllocator;  /*!< Allocator used to construct/destruct the elements inside the slots.*/
+    size_type m_mask;  /*!< Capacity - 1, maps positions to slots.*/
 
-        std::uninitialized_copy(cbegin(), pos, temp.m_data);
-        temp.m_headIndex = std::distance(cbegin(), pos);
+    // Each index has a cache line of its own. The alignment also rounds the size of the class up to whole lines, keeping members that follow this object off of them.
+    alignas(cacheLineSize) std::atomic<size_type> m_enqueueIndex; /*!< Position of the next push. Shared by producers.*/
+    alignas(cacheLineSize) std::atomic<size_type> m_dequeueIndex; /*!< Position of the next pop. Shared by consumers.*/
+};
 
+//===========================
+// Non-member functions
+//===========================
 
-        for (; rangeBegin != rangeEnd; ++rangeBegin)
+namespace
+{
+    // Index of the first mismatch of two contiguous ranges of count elements, or count if they are equal. Bitwise comparable ranges are skipped with memcmp.
+    template<typename T>
+    size_t _mismatchChunk(const T* lhs, const T* rhs, size_t count, std::true_type) noexcept
+    {
+        if (count == 0 || std::memcmp(lhs, rhs, count * sizeof(T)) == 0)
         {
-            alloc_traits::construct(temp.m_allocator, temp.m_data + temp.m_headIndex, *rangeBegin);
-            ++temp.m_headIndex;
+            return count;
         }
-
-        // Copy elements after pos
-        std::uninitialized_copy(pos, cend(), temp.m_data + temp.m_headIndex);
-        temp.m_headIndex += std::distance(pos, cend());
-
-        // Swap whole buffer.
-        swap(temp);
-
-        return iterator(this, pos.getIndex());
+        return static_cast<size_t>(std::mismatch(lhs, lhs + count, rhs).first - lhs);
     }
 
-    /// @brief Base function for erasing elements from the buffer.
-    /// @param first Iterator pointing to the first element of the range to erase.
-    /// @param last Iterator pointing to past the last element to erase.
-    /// @return Returns an iterator pointing to the element immediately after the erased elements.
-    /// @pre First and last must be valid iterators to *this.
-    /// @exception If value_types swap is NoThrow, function is noexcept. If swap throws, behavior is undefined.
-    iterator eraseBase(const_iterator first, const_iterator last)
+    template<typename T>
+    size_t _mismatchChunk(const T* lhs, const T* rhs, size_t count, std::false_type)
     {
-        iterator returnIt(this, first.getIndex());
-
-        const auto diff = std::distance(first, last);
+        return static_cast<size_t>(std::mismatch(lhs, lhs + count, rhs).first - lhs);
+    }
 
-        if (diff > 0)
+    // Walks the first min(lhs.size(), rhs.size()) elements of two buffers in lockstep. Both buffers are split at their wrap points, so f is called
+    // with at most three pairs of contiguous chunks: f(lhsChunk, rhsChunk, count) returns how many elements it handled, fewer than count stops the walk.
+    // Returns the logical index where the walk stopped.
+    template<typename LhsBuffer, typename RhsBuffer, typename Function>
+    size_t _forEachChunkPair(const LhsBuffer& lhs, const RhsBuffer& rhs, Function&& f)
+    {
+        const typename LhsBuffer::const_span lhsSegments[2] = { lhs.array_one(), lhs.array_two() };
+        const typename RhsBuffer::const_span rhsSegments[2] = { rhs.array_one(), rhs.array_two() };
+        const auto total = std::min(lhs.size(), rhs.size());
+
+        size_t index = 0;
+        size_t lhsSegment = 0, lhsOffset = 0;
+        size_t rhsSegment = 0, rhsOffset = 0;
+        while (index < total)
         {
-            auto tempIt(returnIt);
-
-            // Swap to be erased elements to the end...
-            for (; tempIt + diff < end(); tempIt++)
+            // Skip exhausted segments, the second one is empty if the buffer doesn't wrap.
+            if (lhsOffset == lhsSegments[lhsSegment].size())
             {
-                std::swap(*(tempIt + diff), *tempIt);
+                ++lhsSegment;
+                lhsOffset = 0;
+                continue;
             }
-
-            // ... and destroy them.
-            for (; tempIt < end(); tempIt++)
+            if (rhsOffset == rhsSegments[rhsSegment].size())
             {
-                alloc_traits::destroy(base::m_allocator, &*(tempIt));
+                ++rhsSegment;
+                rhsOffset = 0;
+                continue;
             }
 
-            decrement(m_headIndex, diff);
+            const auto count = std::min({ total - index, lhsSegments[lhsSegment].size() - lhsOffset, rhsSegments[rhsSegment].size() - rhsOffset });
+            const size_t handled = f(lhsSegments[lhsSegment].data() + lhsOffset, rhsSegments[rhsSegment].data() + rhsOffset, count);
+            index += handled;
+            if (handled != count)
+            {
+                break;
+            }
+            lhsOffset += count;
+            rhsOffset += count;
         }
-        return returnIt;
+        return index;
     }
 
-    /// @brief Increment an index. The ringbuffer internally increments the head and tail index when adding elements.
-    /// @param index The index to increment.
-    /// @details Constant complexity.
-    void increment(size_t& index) noexcept
+    // Logical index of the first mismatch of two buffers, or the smaller size if one is a prefix of the other.
+    template<typename Buffer>
+    size_t _mismatchIndex(const Buffer& lhs, const Buffer& rhs)
     {
-        ++index;
-        // Wrap index around at end of physical memory area.
-        if(index >= base::m_capacity)
-        {
-            index = 0;
-        }
+        using T = typename Buffer::value_type;
+        return _forEachChunkPair(lhs, rhs, [](const T* lhsChunk, const T* rhsChunk, size_t count) {
+            return _mismatchChunk(lhsChunk, rhsChunk, count, is_bitwise_comparable<T>());
+        });
     }
 
-    /// @brief Increments an index multiple times. The ringbuffer internally increments the head and tail index when adding elements.
-    /// @param index Index to increment.
-    /// @param times Amount of increments.
-    /// @details Linear complexity in relation to size of times argument.
-    void increment(size_t& index, size_t times) noexcept
+    // Lexicographical less-than of two buffers. Bitwise comparable elements are equivalent exactly when they are equal,
+    // so the first mismatch found with memcmp decides.
+    template<typename Buffer>
+    bool _lexicographicalLess(const Buffer& lhs, const Buffer& rhs, std::true_type)
     {
-        while(times > 0)
+        const auto index = _mismatchIndex(lhs, rhs);
+        if (index == std::min(lhs.size(), rhs.size()))
         {
-            increment(index);
-            times--;
+            return lhs.size() < rhs.size();
         }
+        return lhs[index] < rhs[index];
     }
 
-    /// @brief Decrements an index. The ringbuffer internally decrements the head and tail index when removing elements.
-    /// @param index The index to decrement.
-    /// @details Constant complexity.
-    void decrement(size_t& index) noexcept
-    {
-        if(index == 0)
-        {
-            index = base::m_capacity - 1;
-        }
-        else
-        {
-            --index;
-        }
-    }
-    
-    /// @brief Decrements an index multiple times. The ringbuffer internally decrements the head and tail index when removing elements.
-    /// @param index Index to decrement.
-    /// @param times Amount of decrements.
-    void decrement(size_t& index, size_t times) noexcept
+    // Other elements are compared with operator< only, like std::lexicographical_compare, since operator== may disagree with it (NaN).
+    template<typename Buffer>
+    bool _lexicographicalLess(const Buffer& lhs, const Buffer& rhs, std::false_type)
     {
-        while(times > 0)
-        {
-            decrement(index);
-            times--;
-        }
+        using T = typename Buffer::value_type;
+        bool less = false;
+        const auto index = _forEachChunkPair(lhs, rhs, [&less](const T* lhsChunk, const T* rhsChunk, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (lhsChunk[i] < rhsChunk[i])
+                {
+                    less = true;
+                    return i;
+                }
+                if (rhsChunk[i] < lhsChunk[i])
+                {
+                    return i;
+                }
+            }
+            return count;
+        });
+        return index == std::min(lhs.size(), rhs.size()) ? lhs.size() < rhs.size() : less;
     }
-
-    size_type m_headIndex; /*!< Index of the head. Index pointing to past the last element.*/
-    size_type m_tailIndex; /*!< Index of the tail. Index to the first element in the buffer.*/
-
-};
-
-
-//===========================
-// Non-member functions
-//===========================
+}
 
 /// @brief Equality comparator. Compares buffers element-to-element.
 /// @tparam T Value type
 /// @tparam Alloc Optional custom allocator. Defaults to std::allocator<T>.
+/// @tparam Policy Capacity policy of the buffers.
 /// @param lhs Left hand side operand
 /// @param rhs right hand side operand
 /// @return returns true if the buffers elements compare equal.
-template<typename T , typename Alloc>
-inline bool operator==(const ring_buffer<T,Alloc>& lhs, const ring_buffer<T,Alloc>& rhs)
+/// @note Both buffers are split at their wrap points and compared one contiguous chunk at a time, with memcmp if value_type is bitwise comparable.
+template<typename T , typename Alloc, typename Policy>
+inline bool operator==(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
 {
-    if(lhs.size() != rhs.size())
-    {
-        return false;
-    }
-
-    for(size_t i = 0; i < lhs.size(); i++)
-    {
-        if(lhs[i] != rhs[i])
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return lhs.size() == rhs.size() && _mismatchIndex(lhs, rhs) == lhs.size();
 }
 
 /// @brief Not-equal comparator. Compares buffers element-to-element.
 /// @tparam T Value type
 /// @tparam Alloc Optional custom allocator. Defaults to std::allocator<T>.
+/// @tparam Policy Capacity policy of the buffers.
 /// @param lhs Left hand side operand.
 /// @param rhs Right hand side operand.
 /// @return returns True if any of the elements are not equal.
-template<typename T,typename Alloc>
-inline bool operator!=(const ring_buffer<T,Alloc>& lhs, const ring_buffer<T,Alloc>& rhs)
+template<typename T,typename Alloc, typename Policy>
+inline bool operator!=(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
 {
     return !(lhs == rhs);
 }
 
+/// @brief Less-than comparator. Compares buffers lexicographically.
+/// @tparam T Value type
+/// @tparam Alloc Optional custom allocator. Defaults to std::allocator<T>.
+/// @tparam Policy Capacity policy of the buffers.
+/// @param lhs Left hand side operand.
+/// @param rhs Right hand side operand.
+/// @return returns True if lhs is lexicographically less than rhs.
+/// @note Same result as std::lexicographical_compare. If value_type is bitwise comparable the first mismatch is found with memcmp like operator==,
+/// otherwise the elements are compared with operator< one contiguous chunk at a time.
+template<typename T,typename Alloc, typename Policy>
+inline bool operator<(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
+{
+    return _lexicographicalLess(lhs, rhs, is_bitwise_comparable<T>());
+}
+
+/// @brief Greater-than comparator. Compares buffers lexicographically.
+/// @return returns True if lhs is lexicographically greater than rhs.
+template<typename T,typename Alloc, typename Policy>
+inline bool operator>(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
+{
+    return rhs < lhs;
+}
+
+/// @brief Less-than-or-equal comparator. Compares buffers lexicographically.
+/// @return returns True if lhs is lexicographically less than or equal to rhs.
+template<typename T,typename Alloc, typename Policy>
+inline bool operator<=(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+/// @brief Greater-than-or-equal comparator. Compares buffers lexicographically.
+/// @return returns True if lhs is lexicographically greater than or equal to rhs.
+template<typename T,typename Alloc, typename Policy>
+inline bool operator>=(const ring_buffer<T,Alloc,Policy>& lhs, const ring_buffer<T,Alloc,Policy>& rhs)
+{
+    return !(lhs < rhs);
+}
+
 #endif /*DYNAMIC_RINGBUFFER_HPP*/
@@ -0,0 +1,617 @@
+#ifndef DYNAMIC_RINGBUFFER_ALGORITHMS_HPP
+#define DYNAMIC_RINGBUFFER_ALGORITHMS_HPP
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Execution policy for the parallel overloads of the algorithms. The buffer is split into about equal logical ranges, one per thread.
+/// @note The calling thread processes the first range, the others are run with std::async. Exceptions thrown on any thread are rethrown to the caller.
+struct ring_buffer_parallel
+{
+    size_t threads = 0;  /*!< Maximum amount of threads, including the calling thread. 0 uses std::thread::hardware_concurrency().*/
+    size_t grain = 1 << 16;  /*!< Minimum amount of elements per thread. Buffers smaller than two grains are processed on the calling thread.*/
+};
+
+/// @brief Executor that runs every task on a thread of its own. The threads are joined when the executor is destroyed or join() is called.
+/// @note Any callable that takes a nullary task and runs it, now or later on some thread, can be used as the executor of parallel_for_each, e.g. the submit function of a thread pool.
+class ring_buffer_thread_executor
+{
+public:
+    ring_buffer_thread_executor() = default;
+    ring_buffer_thread_executor(const ring_buffer_thread_executor&) = delete;
+    ring_buffer_thread_executor& operator=(const ring_buffer_thread_executor&) = delete;
+
+    ~ring_buffer_thread_executor()
+    {
+        join();
+    }
+
+    /// @brief Starts a thread running task.
+    /// @throw Can throw std::system_error if the thread can't be started.
+    template<typename Task>
+    void operator()(Task&& task)
+    {
+        m_threads.emplace_back(std::forward<Task>(task));
+    }
+
+    /// @brief Waits for all started threads to finish.
+    void join()
+    {
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        m_threads.clear();
+    }
+
+private:
+    std::vector<std::thread> m_threads;
+};
+
+namespace
+{
+    // Amount of independent accumulators of the arithmetic kernels. Fills a 256-bit vector register and breaks the dependency chain of the additions.
+    template<typename T>
+    constexpr size_t _lanes() noexcept
+    {
+        return 32 / sizeof(T) > 4 ? 32 / sizeof(T) : 4;
+    }
+
+    template<typename T, typename U>
+    using _is_arithmetic_pair = std::integral_constant<bool, std::is_arithmetic<T>::value && std::is_arithmetic<U>::value>;
+
+    // Sum of count elements. The arithmetic kernel keeps one partial sum per lane, which the compiler maps to vector registers.
+    template<typename T, typename U>
+    U _sumChunk(const T* data, size_t count, U init, std::true_type) noexcept
+    {
+        constexpr size_t lanes = _lanes<U>();
+        U partial[lanes] = {};
+        size_t i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                partial[lane] += static_cast<U>(data[i + lane]);
+            }
+        }
+        for (; i < count; i++)
+        {
+            init += static_cast<U>(data[i]);
+        }
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            init += partial[lane];
+        }
+        return init;
+    }
+
+    template<typename T, typename U>
+    U _sumChunk(const T* data, size_t count, U init, std::false_type)
+    {
+        return std::accumulate(data, data + count, std::move(init));
+    }
+
+    // Sum of the products of count pairs of elements.
+    template<typename T, typename U>
+    U _dotChunk(const T* lhs, const T* rhs, size_t count, U init, std::true_type) noexcept
+    {
+        constexpr size_t lanes = _lanes<U>();
+        U partial[lanes] = {};
+        size_t i = 0;
+        for (; i + lanes <= count; i += lanes)
+        {
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                partial[lane] += static_cast<U>(lhs[i + lane]) * static_cast<U>(rhs[i + lane]);
+            }
+        }
+        for (; i < count; i++)
+        {
+            init += static_cast<U>(lhs[i]) * static_cast<U>(rhs[i]);
+        }
+        for (size_t lane = 0; lane < lanes; lane++)
+        {
+            init += partial[lane];
+        }
+        return init;
+    }
+
+    template<typename T, typename U>
+    U _dotChunk(const T* lhs, const T* rhs, size_t count, U init, std::false_type)
+    {
+        return std::inner_product(lhs, lhs + count, rhs, std::move(init));
+    }
+
+    // Folds count elements into low and high. The arithmetic kernel keeps one minimum and maximum per lane, written as selects that map to min/max instructions.
+    template<typename T>
+    void _minMaxChunk(const T* data, size_t count, T& low, T& high, std::true_type) noexcept
+    {
+        constexpr size_t lanes = _lanes<T>();
+        size_t i = 0;
+        if (count >= lanes)
+        {
+            T lows[lanes];
+            T highs[lanes];
+            std::copy(data, data + lanes, lows);
+            std::copy(data, data + lanes, highs);
+            for (i = lanes; i + lanes <= count; i += lanes)
+            {
+                for (size_t lane = 0; lane < lanes; lane++)
+                {
+                    lows[lane] = data[i + lane] < lows[lane] ? data[i + lane] : lows[lane];
+                    highs[lane] = highs[lane] < data[i + lane] ? data[i + lane] : highs[lane];
+                }
+            }
+            for (size_t lane = 0; lane < lanes; lane++)
+            {
+                low = lows[lane] < low ? lows[lane] : low;
+                high = high < highs[lane] ? highs[lane] : high;
+            }
+        }
+        for (; i < count; i++)
+        {
+            low = data[i] < low ? data[i] : low;
+            high = high < data[i] ? data[i] : high;
+        }
+    }
+
+    template<typename T>
+    void _minMaxChunk(const T* data, size_t count, T& low, T& high, std::false_type)
+    {
+        if (count)
+        {
+            const auto found = std::minmax_element(data, data + count);
+            if (*found.first < low)
+            {
+                low = *found.first;
+            }
+            if (!(*found.second < high))
+            {
+                high = *found.second;
+            }
+        }
+    }
+
+    // Calls f(data, count) for the parts of the two segments that hold the logical range [first, last).
+    template<typename Span, typename Function>
+    void _forSegmentsIn(const Span (&segments)[2], size_t first, size_t last, Function&& f)
+    {
+        const auto firstSize = segments[0].size();
+        if (first < firstSize)
+        {
+            f(segments[0].data() + first, std::min(last, firstSize) - first);
+        }
+        if (last > firstSize)
+        {
+            const auto begin = first > firstSize ? first - firstSize : 0;
+            f(segments[1].data() + begin, last - firstSize - begin);
+        }
+    }
+
+    // Pair of contiguous chunks of two buffers, as found by _forEachChunkPair.
+    template<typename T>
+    struct _chunk_pair
+    {
+        const T* lhs;
+        const T* rhs;
+        size_t count;
+    };
+
+    // Splits two buffers at both of their wrap points into at most three chunk pairs.
+    template<typename LhsBuffer, typename RhsBuffer>
+    size_t _collectChunkPairs(const LhsBuffer& lhs, const RhsBuffer& rhs, _chunk_pair<typename LhsBuffer::value_type> (&chunks)[3])
+    {
+        using T = typename LhsBuffer::value_type;
+        size_t chunkCount = 0;
+        _forEachChunkPair(lhs, rhs, [&](const T* lhsChunk, const T* rhsChunk, size_t count) {
+            chunks[chunkCount++] = { lhsChunk, rhsChunk, count };
+            return count;
+        });
+        return chunkCount;
+    }
+
+    // Calls f(lhs, rhs, count) for the parts of the chunk pairs that hold the logical range [first, last).
+    template<typename T, typename Function>
+    void _forChunkPairsIn(const _chunk_pair<T>* chunks, size_t chunkCount, size_t first, size_t last, Function&& f)
+    {
+        size_t offset = 0;
+        for (size_t i = 0; i < chunkCount && offset < last; offset += chunks[i++].count)
+        {
+            const auto begin = std::max(first, offset);
+            const auto end = std::min(last, offset + chunks[i].count);
+            if (begin < end)
+            {
+                f(chunks[i].lhs + (begin - offset), chunks[i].rhs + (begin - offset), end - begin);
+            }
+        }
+    }
+
+    // Chunks owned by one worker of parallel_for_each. The owner and thieves alike take chunks from the front, so a single counter is enough.
+    // The alignment also pads the size to whole cache lines, which keeps the counters of different workers in an array off each other's cache lines.
+    struct alignas(cacheLineSize) _steal_range
+    {
+        std::atomic<size_t> next;
+        size_t end;
+    };
+    static_assert(sizeof(_steal_range) % cacheLineSize == 0, "_steal_range must fill whole cache lines");
+
+    // Cache line aligned array of _steal_range. new[] honours alignments beyond std::max_align_t only since C++17, so the memory is aligned by hand.
+    class _steal_ranges
+    {
+    public:
+        // Replaces the ranges with count value initialized ones.
+        void reset(size_t count)
+        {
+            size_t space = count * sizeof(_steal_range) + cacheLineSize;
+            m_storage.reset(new char[space]);
+            void* memory = m_storage.get();
+            m_ranges = static_cast<_steal_range*>(std::align(cacheLineSize, count * sizeof(_steal_range), memory, space));
+            for (size_t i = 0; i < count; i++)
+            {
+                ::new (static_cast<void*>(m_ranges + i)) _steal_range();
+            }
+        }
+
+        _steal_range& operator[](size_t index) noexcept { return m_ranges[index]; }
+
+    private:
+        std::unique_ptr<char[]> m_storage;
+        _steal_range* m_ranges = nullptr;  // _steal_range is trivially destructible, the storage is released without destroying them.
+    };
+
+    // State shared by the caller and the tasks of parallel_for_each. Tasks hold it by shared_ptr, as they may start after the call has returned.
+    template<typename Span, typename Function>
+    struct _for_each_state
+    {
+        std::vector<Span> chunks;
+        _steal_ranges ranges;
+        size_t workers;
+        Function* f;
+        std::atomic<size_t> remaining;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    // Processes the chunks of worker self, then steals from the other workers in turn. A worker that starts after all chunks are taken returns at once.
+    template<typename State>
+    void _forEachWorker(State& state, size_t self)
+    {
+        for (size_t k = 0; k < state.workers; k++)
+        {
+            auto& range = state.ranges[(self + k) % state.workers];
+            for (auto index = range.next.fetch_add(1, std::memory_order_relaxed); index < range.end; index = range.next.fetch_add(1, std::memory_order_relaxed))
+            {
+                // After a failure the remaining chunks are only counted, not processed.
+                if (!state.failed.load(std::memory_order_relaxed))
+                {
+                    try
+                    {
+                        for (auto& value : state.chunks[index])
+                        {
+                            (*state.f)(value);
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        if (!state.error)
+                        {
+                            state.error = std::current_exception();
+                        }
+                        state.failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+
+                if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.done.notify_all();
+                }
+            }
+        }
+    }
+
+    // Splits the logical range [0, total) into one range per thread and returns task(first, last) of each range in logical order.
+    template<typename Task>
+    auto _runParallel(const ring_buffer_parallel& policy, size_t total, Task task) -> std::vector<decltype(task(size_t(), size_t()))>
+    {
+        using Result = decltype(task(size_t(), size_t()));
+        const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t maxThreads = policy.threads ? policy.threads : hardware;
+        const size_t threads = std::max<size_t>(1, std::min(maxThreads, total / std::max<size_t>(policy.grain, 1)));
+
+        std::vector<std::future<Result>> futures;
+        futures.reserve(threads - 1);
+        for (size_t k = 1; k < threads; k++)
+        {
+            futures.push_back(std::async(std::launch::async, task, total / threads * k, k + 1 == threads ? total : total / threads * (k + 1)));
+        }
+
+        // The futures of std::async wait for their threads when destroyed, also if the calling thread throws.
+        std::vector<Result> results;
+        results.reserve(threads);
+        results.push_back(task(0, threads == 1 ? total : total / threads));
+        for (auto& future : futures)
+        {
+            results.push_back(future.get());
+        }
+        return results;
+    }
+}
+
+/// @brief Sums the elements of the buffer, one contiguous segment at a time.
+/// @param buffer Buffer to sum.
+/// @param init Initial value, also the type of the result.
+/// @return init plus the sum of the elements.
+/// @note For arithmetic types the kernel keeps several partial sums side by side so that the compiler can vectorize it. Floating point results may therefore
+/// differ from std::accumulate by rounding, as with std::reduce. Other types are summed in order with operator+.
+/// @details Linear complexity in relation to size of the buffer.
+template<typename T, typename Allocator, typename CapacityPolicy, typename U>
+U reduce(const ring_buffer<T, Allocator, CapacityPolicy>& buffer, U init)
+{
+    const auto first = buffer.array_one();
+    const auto second = buffer.array_two();
+    init = _sumChunk(first.data(), first.size(), std::move(init), _is_arithmetic_pair<T, U>());
+    return _sumChunk(second.data(), second.size(), std::move(init), _is_arithmetic_pair<T, U>());
+}
+
+/// @brief Folds the elements of the buffer in order with op, one contiguous segment at a time.
+/// @param buffer Buffer to fold.
+/// @param init Initial value, also the type of the result.
+/// @param op Binary operation called as op(accumulated, element).
+/// @return The result of folding all elements into init, as with std::accumulate.
+/// @details Linear complexity in relation to size of the buffer.
+template<typename T, typename Allocator, typename CapacityPolicy, typename U, typename BinaryOp>
+U reduce(const ring_buffer<T, Allocator, CapacityPolicy>& buffer, U init, BinaryOp op)
+{
+    const auto first = buffer.array_one();
+    const auto second = buffer.array_two();
+    init = std::accumulate(first.begin(), first.end(), std::move(init), op);
+    return std::accumulate(second.begin(), second.end(), std::move(init), op);
+}
+
+/// @brief Sums the elements of the buffer on several threads.
+/// @param policy Amount of threads and the minimum amount of elements per thread.
+/// @param buffer Buffer to sum. Must not be modified until the function returns.
+/// @param init Initial value, also the type of the result. U() must be the identity of the sum.
+/// @return init plus the sum of the elements.
+/// @details Linear complexity in relation to size of the buffer, divided by the amount of threads.
+template<typename T, typename Allocator, typename CapacityPolicy, typename U>
+U reduce(const ring_buffer_parallel& policy, const ring_buffer<T, Allocator, CapacityPolicy>& buffer, U init)
+{
+    using span = typename ring_buffer<T, Allocator, CapacityPolicy>::const_span;
+    const span segments[2] = { buffer.array_one(), buffer.array_two() };
+    const auto partials = _runParallel(policy, buffer.size(), [&segments](size_t first, size_t last) {
+        U sum = U();
+        _forSegmentsIn(segments, first, last, [&sum](const T* data, size_t count) { sum = _sumChunk(data, count, std::move(sum), _is_arithmetic_pair<T, U>()); });
+        return sum;
+    });
+    for (const auto& partial : partials)
+    {
+        init = std::move(init) + partial;
+    }
+    return init;
+}
+
+/// @brief Finds the smallest and the largest element of the buffer, one contiguous segment at a time.
+/// @param buffer Buffer to search.
+/// @return Pair of copies of the smallest and the largest element.
+/// @pre The buffer must not be empty, otherwise behaviour is undefined. value_type must be LessThanComparable.
+/// @note For arithmetic types the kernel keeps a minimum and a maximum per lane so that the compiler can vectorize it. The result is unspecified if floating point elements hold NaN.
+/// @details Linear complexity in relation to size of the buffer.
+template<typename T, typename Allocator, typename CapacityPolicy>
+std::pair<T, T> min_max(const ring_buffer<T, Allocator, CapacityPolicy>& buffer)
+{
+    const auto first = buffer.array_one();
+    const auto second = buffer.array_two();
+    std::pair<T, T> result(buffer.front(), buffer.front());
+    _minMaxChunk(first.data(), first.size(), result.first, result.second, std::is_arithmetic<T>());
+    _minMaxChunk(second.data(), second.size(), result.first, result.second, std::is_arithmetic<T>());
+    return result;
+}
+
+/// @brief Finds the smallest and the largest element of the buffer on several threads.
+/// @param policy Amount of threads and the minimum amount of elements per thread.
+/// @param buffer Buffer to search. Must not be modified until the function returns.
+/// @return Pair of copies of the smallest and the largest element.
+/// @pre The buffer must not be empty, otherwise behaviour is undefined. value_type must be LessThanComparable.
+/// @details Linear complexity in relation to size of the buffer, divided by the amount of threads.
+template<typename T, typename Allocator, typename CapacityPolicy>
+std::pair<T, T> min_max(const ring_buffer_parallel& policy, const ring_buffer<T, Allocator, CapacityPolicy>& buffer)
+{
+    using span = typename ring_buffer<T, Allocator, CapacityPolicy>::const_span;
+    const span segments[2] = { buffer.array_one(), buffer.array_two() };
+    const auto partials = _runParallel(policy, buffer.size(), [&segments, &buffer](size_t first, size_t last) {
+        std::pair<T, T> result(buffer[first], buffer[first]);
+        _forSegmentsIn(segments, first, last, [&result](const T* data, size_t count) { _minMaxChunk(data, count, result.first, result.second, std::is_arithmetic<T>()); });
+        return result;
+    });
+
+    auto result = partials.front();
+    for (const auto& partial : partials)
+    {
+        result.first = partial.first < result.first ? partial.first : result.first;
+        result.second = result.second < partial.second ? partial.second : result.second;
+    }
+    return result;
+}
+
+/// @brief Replaces every element of the buffer with the result of f, one contiguous segment at a time.
+/// @param buffer Buffer to transform.
+/// @param f Unary operation called as f(element), its result is assigned to the element.
+/// @note The loop over each segment goes through a pointer, which the compiler can vectorize if f is inlined.
+/// @exception If f throws, the elements before the failing element have been transformed (Basic exception guarantee).
+/// @details Linear complexity in relation to size of the buffer.
+template<typename T, typename Allocator, typename CapacityPolicy, typename UnaryOp>
+void transform_inplace(ring_buffer<T, Allocator, CapacityPolicy>& buffer, UnaryOp f)
+{
+    for (auto segment : { buffer.array_one(), buffer.array_two() })
+    {
+        for (auto& value : segment)
+        {
+            value = f(value);
+        }
+    }
+}
+
+/// @brief Replaces every element of the buffer with the result of f on several threads.
+/// @param policy Amount of threads and the minimum amount of elements per thread.
+/// @param buffer Buffer to transform. Must not be accessed otherwise until the function returns.
+/// @param f Unary operation called as f(element) from several threads at the same time, its result is assigned to the element.
+/// @exception If f throws on any thread, the exception is rethrown once all threads have finished. Other elements may or may not have been transformed.
+/// @details Linear complexity in relation to size of the buffer, divided by the amount of threads.
+template<typename T, typename Allocator, typename CapacityPolicy, typename UnaryOp>
+void transform_inplace(const ring_buffer_parallel& policy, ring_buffer<T, Allocator, CapacityPolicy>& buffer, UnaryOp f)
+{
+    using span = typename ring_buffer<T, Allocator, CapacityPolicy>::span;
+    const span segments[2] = { buffer.array_one(), buffer.array_two() };
+    _runParallel(policy, buffer.size(), [&segments, &f](size_t first, size_t last) {
+        _forSegmentsIn(segments, first, last, [&f](T* data, size_t count) {
+            for (size_t i = 0; i < count; i++)
+            {
+                data[i] = f(data[i]);
+            }
+        });
+        return last - first;
+    });
+}
+
+/// @brief Computes the inner product of two buffers. Both buffers are split at their wrap points, so the products are summed over at most three contiguous chunks.
+/// @param lhs First buffer.
+/// @param rhs Second buffer.
+/// @param init Initial value, also the type of the result.
+/// @return init plus the sum of lhs[i] * rhs[i] for the first min(lhs.size(), rhs.size()) elements.
+/// @note For arithmetic types the kernel keeps several partial sums side by side so that the compiler can vectorize it. Floating point results may therefore
+/// differ from std::inner_product by rounding.
+/// @details Linear complexity in relation to size of the smaller buffer.
+template<typename T, typename LhsAllocator, typename LhsPolicy, typename RhsAllocator, typename RhsPolicy, typename U>
+U dot(const ring_buffer<T, LhsAllocator, LhsPolicy>& lhs, const ring_buffer<T, RhsAllocator, RhsPolicy>& rhs, U init)
+{
+    _forEachChunkPair(lhs, rhs, [&init](const T* lhsChunk, const T* rhsChunk, size_t count) {
+        init = _dotChunk(lhsChunk, rhsChunk, count, std::move(init), _is_arithmetic_pair<T, U>());
+        return count;
+    });
+    return init;
+}
+
+/// @brief Computes the inner product of two buffers on several threads.
+/// @param policy Amount of threads and the minimum amount of elements per thread.
+/// @param lhs First buffer. Must not be modified until the function returns.
+/// @param rhs Second buffer. Must not be modified until the function returns.
+/// @param init Initial value, also the type of the result. U() must be the identity of the sum.
+/// @return init plus the sum of lhs[i] * rhs[i] for the first min(lhs.size(), rhs.size()) elements.
+/// @details Linear complexity in relation to size of the smaller buffer, divided by the amount of threads.
+template<typename T, typename LhsAllocator, typename LhsPolicy, typename RhsAllocator, typename RhsPolicy, typename U>
+U dot(const ring_buffer_parallel& policy, const ring_buffer<T, LhsAllocator, LhsPolicy>& lhs, const ring_buffer<T, RhsAllocator, RhsPolicy>& rhs, U init)
+{
+    _chunk_pair<T> chunks[3];
+    const auto chunkCount = _collectChunkPairs(lhs, rhs, chunks);
+    const auto partials = _runParallel(policy, std::min(lhs.size(), rhs.size()), [&chunks, chunkCount](size_t first, size_t last) {
+        U sum = U();
+        _forChunkPairsIn(chunks, chunkCount, first, last, [&sum](const T* lhsChunk, const T* rhsChunk, size_t count) {
+            sum = _dotChunk(lhsChunk, rhsChunk, count, std::move(sum), _is_arithmetic_pair<T, U>());
+        });
+        return sum;
+    });
+    for (const auto& partial : partials)
+    {
+        init = std::move(init) + partial;
+    }
+    return init;
+}
+
+/// @brief Calls f on every element of the buffer from several threads. The buffer is split into cache line aligned chunks with partition(),
+/// dealt out evenly to the workers, and workers that run out of chunks steal from the others.
+/// @param policy Amount of workers, including the calling thread, and the minimum amount of elements per worker.
+/// @param buffer Buffer whose elements to process. Must not be accessed otherwise until the function returns.
+/// @param f Function called as f(element) from several threads at the same time.
+/// @param executor Callable that runs a nullary task, now or later on some thread. Called once per worker except the calling thread, which works too.
+/// @note Returns once every chunk has been processed, without waiting for tasks that haven't started; they find no work and return. If the executor
+/// throws, the calling thread processes the remaining chunks itself.
+/// @exception If f throws, the first exception is rethrown once all started chunks have finished. Remaining chunks are skipped.
+/// @details Linear complexity in relation to size of the buffer, divided by the amount of workers.
+template<typename T, typename Allocator, typename CapacityPolicy, typename Function, typename Executor>
+void parallel_for_each(const ring_buffer_parallel& policy, ring_buffer<T, Allocator, CapacityPolicy>& buffer, Function f, Executor&& executor)
+{
+    using span = typename ring_buffer<T, Allocator, CapacityPolicy>::span;
+    const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t maxWorkers = policy.threads ? policy.threads : hardware;
+    const size_t workers = std::min(maxWorkers, buffer.size() / std::max<size_t>(policy.grain, 1));
+    if (workers <= 1)
+    {
+        for (auto segment : { buffer.array_one(), buffer.array_two() })
+        {
+            for (auto& value : segment)
+            {
+                f(value);
+            }
+        }
+        return;
+    }
+
+    // A few chunks per worker leave something to steal when the work is uneven.
+    auto state = std::make_shared<_for_each_state<span, Function>>();
+    state->chunks = buffer.partition(workers * 4);
+    state->ranges.reset(workers);
+    state->workers = workers;
+    state->f = &f;
+    state->remaining.store(state->chunks.size(), std::memory_order_relaxed);
+    state->failed.store(false, std::memory_order_relaxed);
+    for (size_t w = 0; w < workers; w++)
+    {
+        state->ranges[w].next.store(state->chunks.size() * w / workers, std::memory_order_relaxed);
+        state->ranges[w].end = state->chunks.size() * (w + 1) / workers;
+    }
+
+    for (size_t w = 1; w < workers; w++)
+    {
+        try
+        {
+            executor([state, w]() { _forEachWorker(*state, w); });
+        }
+        catch (...)
+        {
+            break;
+        }
+    }
+    _forEachWorker(*state, 0);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state]() { return state->remaining.load(std::memory_order_acquire) == 0; });
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
+
+/// @brief Calls f on every element of the buffer from several threads with the default ring_buffer_parallel policy. See the overload taking a policy.
+template<typename T, typename Allocator, typename CapacityPolicy, typename Function, typename Executor>
+void parallel_for_each(ring_buffer<T, Allocator, CapacityPolicy>& buffer, Function f, Executor&& executor)
+{
+    parallel_for_each(ring_buffer_parallel(), buffer, std::move(f), std::forward<Executor>(executor));
+}
+
+/// @brief Calls f on every element of the buffer, starting a thread for each worker. See the overload taking an executor.
+template<typename T, typename Allocator, typename CapacityPolicy, typename Function>
+void parallel_for_each(const ring_buffer_parallel& policy, ring_buffer<T, Allocator, CapacityPolicy>& buffer, Function f)
+{
+    ring_buffer_thread_executor executor;
+    parallel_for_each(policy, buffer, std::move(f), executor);
+}
+
+#endif
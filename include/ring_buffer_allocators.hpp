@@ -0,0 +1,512 @@
+#ifndef DYNAMIC_RINGBUFFER_ALLOCATORS_HPP
+#define DYNAMIC_RINGBUFFER_ALLOCATORS_HPP
+
+#include "ring_buffer.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RING_BUFFER_HAS_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+#endif
+
+#if defined(__linux__) && !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#if defined(__has_include) && __cplusplus >= 201703L
+#if __has_include(<memory_resource>)
+#define RING_BUFFER_HAS_PMR 1
+#include <memory_resource>
+#endif
+#endif
+
+/// @brief Size of a 2MB huge page.
+constexpr size_t huge_page_size = size_t(1) << 21;
+
+/// @brief Size of a 1GB huge page.
+constexpr size_t giant_page_size = size_t(1) << 30;
+
+#if defined(RING_BUFFER_HAS_MMAP)
+
+/// @brief Allocator that maps memory directly from the operating system in multiples of PageSize, backed by huge pages when possible, and optionally bound to a NUMA node.
+/// @tparam T Type of the elements.
+/// @tparam PageSize Size of the pages in bytes. huge_page_size or giant_page_size on Linux, any multiple of the system page size is accepted.
+/// @note On Linux the memory is first mapped with MAP_HUGETLB, which needs huge pages reserved by the system administrator (vm.nr_hugepages). If none are available,
+/// PageSize aligned memory is mapped normally and transparent huge pages are requested with madvise. Other systems get PageSize aligned regular pages.
+/// Every allocation is rounded up to a multiple of PageSize, use page_capacity_policy so that the rounding is used by the buffer instead of wasted.
+/// The allocator propagates on copy assignment, move assignment and swap, so buffers keep their memory bound to the node it was allocated from.
+template<typename T, size_t PageSize = huge_page_size>
+class huge_page_allocator
+{
+public:
+    static_assert(PageSize != 0 && (PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template<typename U>
+    struct rebind
+    {
+        using other = huge_page_allocator<U, PageSize>;
+    };
+
+    /// @brief Node value for memory that is not bound to any NUMA node.
+    static constexpr int any_node = -1;
+
+    /// @brief Default constructor. The memory is not bound to any NUMA node.
+    huge_page_allocator() noexcept = default;
+
+    /// @brief Constructor.
+    /// @param numaNode NUMA node to bind the memory to, any_node to use the default policy of the thread. Binding is only supported on Linux for nodes below 64.
+    explicit huge_page_allocator(int numaNode) noexcept : m_numaNode(numaNode)
+    {
+    }
+
+    /// @brief Converting constructor, used for rebinding.
+    template<typename U>
+    huge_page_allocator(const huge_page_allocator<U, PageSize>& other) noexcept : m_numaNode(other.numa_node())
+    {
+    }
+
+    /// @brief NUMA node the memory is bound to.
+    /// @return The node given to the constructor.
+    int numa_node() const noexcept
+    {
+        return m_numaNode;
+    }
+
+    /// @brief Maps memory for count elements.
+    /// @param count Amount of elements.
+    /// @return Pointer to PageSize aligned memory.
+    /// @throw Throws std::bad_alloc if the memory can't be mapped.
+    /// @details The memory is rounded up to a multiple of PageSize, see page_capacity_policy.
+    T* allocate(size_type count)
+    {
+        if (count > (std::numeric_limits<size_type>::max() - PageSize) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+
+        const auto bytes = mappedSize(count);
+        void* memory = mapHuge(bytes);
+        if (memory == nullptr)
+        {
+            memory = mapAligned(bytes);
+        }
+        bind(memory, bytes);
+        return static_cast<T*>(memory);
+    }
+
+    /// @brief Unmaps memory returned by allocate().
+    /// @param ptr Pointer returned by allocate().
+    /// @param count The count given to allocate().
+    void deallocate(T* ptr, size_type count) noexcept
+    {
+        if (ptr)
+        {
+            ::munmap(static_cast<void*>(ptr), mappedSize(count));
+        }
+    }
+
+    template<typename U>
+    bool operator==(const huge_page_allocator<U, PageSize>& other) const noexcept
+    {
+        return m_numaNode == other.numa_node();
+    }
+
+    template<typename U>
+    bool operator!=(const huge_page_allocator<U, PageSize>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    /// @brief Amount of bytes mapped for count elements.
+    static size_type mappedSize(size_type count) noexcept
+    {
+        return (count * sizeof(T) + PageSize - 1) & ~(PageSize - 1);
+    }
+
+    /// @brief Maps bytes from the reserved huge pages of the system.
+    /// @return The memory or nullptr if no huge pages of PageSize are available.
+    static void* mapHuge(size_type bytes) noexcept
+    {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+        if (PageSize == huge_page_size || PageSize == giant_page_size)
+        {
+            const int sizeFlag = PageSize == giant_page_size ? (30 << MAP_HUGE_SHIFT) : (21 << MAP_HUGE_SHIFT);
+            void* memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | sizeFlag, -1, 0);
+            return memory == MAP_FAILED ? nullptr : memory;
+        }
+#endif
+        (void)bytes;
+        return nullptr;
+    }
+
+    /// @brief Maps PageSize aligned regular memory and asks for transparent huge pages. Over-maps by one page and trims the unaligned ends.
+    /// @throw Throws std::bad_alloc if the memory can't be mapped.
+    static void* mapAligned(size_type bytes)
+    {
+        const auto systemPage = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        const auto extra = PageSize > systemPage ? PageSize : 0;
+
+        void* memory = ::mmap(nullptr, bytes + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+
+        if (extra)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(memory);
+            const auto aligned = (address + PageSize - 1) & ~std::uintptr_t(PageSize - 1);
+            const auto head = aligned - address;
+            if (head)
+            {
+                ::munmap(memory, head);
+            }
+            if (extra - head)
+            {
+                ::munmap(reinterpret_cast<void*>(aligned + bytes), extra - head);
+            }
+            memory = reinterpret_cast<void*>(aligned);
+        }
+
+#if defined(MADV_HUGEPAGE)
+        ::madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+        return memory;
+    }
+
+    /// @brief Binds the pages of fresh memory to m_numaNode before they are touched. Binding is best effort, memory that can't be bound is still usable.
+    void bind(void* memory, size_type bytes) const noexcept
+    {
+#if defined(__linux__) && defined(SYS_mbind)
+        constexpr int bindPolicy = 2; // MPOL_BIND from <numaif.h>, which is part of libnuma.
+        constexpr int maskBits = sizeof(unsigned long) * CHAR_BIT;
+        if (m_numaNode >= 0 && m_numaNode < maskBits)
+        {
+            const unsigned long mask = 1UL << m_numaNode;
+            // The kernel reads maxnode - 1 bits of the mask.
+            ::syscall(SYS_mbind, memory, bytes, bindPolicy, &mask, maskBits + 1, 0);
+        }
+#else
+        (void)memory;
+        (void)bytes;
+#endif
+    }
+
+    int m_numaNode = any_node; /*!< NUMA node the memory is bound to, or any_node.*/
+};
+
+template<typename T, size_t PageSize>
+constexpr int huge_page_allocator<T, PageSize>::any_node;
+
+#endif
+
+/// @brief Page capacity policy. Rounds the capacity up so that the elements fill whole pages, which makes the rounding of huge_page_allocator usable elements instead of waste.
+/// @tparam ElementSize Size of the elements in bytes, sizeof(T).
+/// @tparam PageSize Size of the pages in bytes.
+/// @tparam Policy Policy used for growth and wrapping the indices. Defaults to default_capacity_policy.
+/// @note Policy::fit is applied after the page rounding. With pow2_capacity_policy the capacity stays a whole number of pages only if ElementSize is a power of two.
+template<size_t ElementSize, size_t PageSize = huge_page_size, typename Policy = default_capacity_policy>
+struct page_capacity_policy : Policy
+{
+    static_assert(ElementSize != 0, "element size can't be zero");
+
+    /// @brief Rounds a requested capacity up to the amount of elements that fit in whole pages.
+    /// @param capacity Requested capacity.
+    /// @return Capacity to allocate.
+    static constexpr size_t fit(size_t capacity) noexcept(noexcept(Policy::fit(capacity)))
+    {
+        return Policy::fit((capacity * ElementSize + PageSize - 1) / PageSize * PageSize / ElementSize);
+    }
+};
+
+#if defined(RING_BUFFER_HAS_MMAP)
+
+/// @brief Ring buffer backed by huge pages, with capacity rounded to whole pages.
+template<typename T, size_t PageSize = huge_page_size>
+using huge_page_ring_buffer = ring_buffer<T, huge_page_allocator<T, PageSize>, page_capacity_policy<sizeof(T), PageSize>>;
+
+#endif
+
+/// @brief Memory arena for short-lived buffers. Hands out blocks by power of two size class from large chunks, recycles freed blocks of the same class
+/// and releases everything at once with reset() or when destroyed.
+/// @note A buffer that grows frees blocks of the classes it grows through, which the next buffers created from the arena reuse without going to the system allocator.
+/// The arena is not thread safe, use one arena per thread or per request. It must outlive the buffers allocating from it.
+class ring_buffer_arena
+{
+public:
+    /// @brief Constructor.
+    /// @param chunkSize Size of the chunks requested from the system allocator. Blocks larger than a chunk get a chunk of their own.
+    explicit ring_buffer_arena(size_t chunkSize = 64 * 1024) noexcept : m_chunkSize(chunkSize > minBlockSize ? chunkSize : size_t(minBlockSize))
+    {
+    }
+
+    ring_buffer_arena(const ring_buffer_arena&) = delete;
+    ring_buffer_arena& operator=(const ring_buffer_arena&) = delete;
+
+    ~ring_buffer_arena()
+    {
+        reset();
+    }
+
+    /// @brief Allocates a block of at least bytes bytes. Reuses a freed block of the same size class if there is one.
+    /// @param bytes Size of the block.
+    /// @param alignment Alignment of the block, a power of two. Blocks aligned beyond alignof(std::max_align_t) are not recycled, their memory is released by reset().
+    /// @return Pointer to the block.
+    /// @throw Throws std::bad_alloc if the system allocator fails or the size is too large.
+    /// @details Constant complexity.
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+    {
+        const auto sizeClass = classOf(bytes);
+        const bool recyclable = alignment <= blockAlignment;
+        if (recyclable && m_free[sizeClass] != nullptr)
+        {
+            ++m_recycled;
+            return std::exchange(m_free[sizeClass], *static_cast<void**>(m_free[sizeClass]));
+        }
+
+        const auto blockSize = minBlockSize << sizeClass;
+        const auto padding = recyclable ? 0 : alignment;
+        if (blockSize > m_chunkSize)
+        {
+            return alignUp(newChunk(blockSize + padding), recyclable ? size_t(blockAlignment) : alignment);
+        }
+
+        if (m_cursor == nullptr || static_cast<size_t>(m_end - m_cursor) < blockSize + padding)
+        {
+            m_cursor = static_cast<char*>(newChunk(m_chunkSize + padding));
+            m_end = m_cursor + m_chunkSize + padding;
+        }
+        auto block = static_cast<char*>(alignUp(m_cursor, recyclable ? size_t(blockAlignment) : alignment));
+        m_cursor = block + blockSize;
+        return block;
+    }
+
+    /// @brief Returns a block to the free list of its size class.
+    /// @param ptr Pointer returned by allocate(), or nullptr.
+    /// @param bytes The size given to allocate().
+    /// @param alignment The alignment given to allocate().
+    /// @details Constant complexity.
+    void deallocate(void* ptr, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (ptr && alignment <= blockAlignment)
+        {
+            const auto sizeClass = classOf(bytes);
+            *static_cast<void**>(ptr) = m_free[sizeClass];
+            m_free[sizeClass] = ptr;
+        }
+    }
+
+    /// @brief Releases all chunks to the system allocator. All blocks allocated from the arena become invalid.
+    /// @details Linear complexity in relation to the amount of chunks.
+    void reset() noexcept
+    {
+        while (m_chunks)
+        {
+            ::operator delete(std::exchange(m_chunks, *static_cast<void**>(m_chunks)));
+        }
+        std::fill(m_free, m_free + classCount, nullptr);
+        m_cursor = nullptr;
+        m_end = nullptr;
+    }
+
+    /// @brief Amount of chunks requested from the system allocator since construction.
+    size_t upstream_allocations() const noexcept
+    {
+        return m_upstreamAllocations;
+    }
+
+    /// @brief Amount of allocations served from the free lists since construction.
+    size_t recycled() const noexcept
+    {
+        return m_recycled;
+    }
+
+private:
+    static constexpr size_t minBlockSize = 64;  /*!< Size of the smallest size class. Classes double from here.*/
+    static constexpr size_t blockAlignment = alignof(std::max_align_t);  /*!< Alignment of all blocks.*/
+    static constexpr size_t classCount = std::numeric_limits<size_t>::digits - 6;  /*!< Amount of size classes, up to the largest size_t.*/
+
+    /// @brief Size class of a block, the smallest class holding bytes.
+    /// @throw Throws std::bad_alloc if no class is large enough.
+    static size_t classOf(size_t bytes)
+    {
+        size_t sizeClass = 0;
+        while ((minBlockSize << sizeClass) < bytes)
+        {
+            if (++sizeClass == classCount)
+            {
+                throw std::bad_alloc();
+            }
+        }
+        return sizeClass;
+    }
+
+    static void* alignUp(void* ptr, size_t alignment) noexcept
+    {
+        const auto address = reinterpret_cast<std::uintptr_t>(ptr);
+        return reinterpret_cast<void*>((address + alignment - 1) & ~std::uintptr_t(alignment - 1));
+    }
+
+    /// @brief Requests a chunk of bytes usable bytes from the system allocator and links it to the list of chunks.
+    void* newChunk(size_t bytes)
+    {
+        if (bytes > std::numeric_limits<size_t>::max() - blockAlignment)
+        {
+            throw std::bad_alloc();
+        }
+        auto chunk = static_cast<char*>(::operator new(bytes + blockAlignment));
+        *reinterpret_cast<void**>(chunk) = m_chunks;
+        m_chunks = chunk;
+        ++m_upstreamAllocations;
+        return chunk + blockAlignment;
+    }
+
+    size_t m_chunkSize;  /*!< Size of the chunks shared by small blocks.*/
+    void* m_free[classCount] = {};  /*!< Heads of the intrusive free lists, one per size class.*/
+    void* m_chunks = nullptr;  /*!< Intrusive list of all chunks, for reset().*/
+    char* m_cursor = nullptr;  /*!< Next free byte in the current chunk.*/
+    char* m_end = nullptr;  /*!< End of the current chunk.*/
+    size_t m_upstreamAllocations = 0;  /*!< Amount of chunks allocated.*/
+    size_t m_recycled = 0;  /*!< Amount of allocations served from the free lists.*/
+};
+
+/// @brief Allocator allocating from a ring_buffer_arena.
+/// @tparam T Type of the elements.
+/// @note The allocator does not propagate on assignment or swap, a buffer keeps allocating from the arena it was created with. Buffers with different arenas
+/// compare unequal, moving between them relocates the elements once.
+template<typename T>
+class arena_allocator
+{
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    /// @brief Constructor.
+    /// @param arena Arena to allocate from. Must outlive the allocator and all memory allocated from it.
+    explicit arena_allocator(ring_buffer_arena& arena) noexcept : m_arena(&arena)
+    {
+    }
+
+    /// @brief Converting constructor, used for rebinding.
+    template<typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : m_arena(&other.arena())
+    {
+    }
+
+    /// @brief Arena the allocator allocates from.
+    ring_buffer_arena& arena() const noexcept
+    {
+        return *m_arena;
+    }
+
+    /// @brief Allocates memory for count elements from the arena.
+    /// @throw Throws std::bad_alloc if the arena can't allocate.
+    T* allocate(size_type count)
+    {
+        if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /// @brief Returns memory to the arena for reuse.
+    void deallocate(T* ptr, size_type count) noexcept
+    {
+        m_arena->deallocate(ptr, count * sizeof(T), alignof(T));
+    }
+
+    template<typename U>
+    bool operator==(const arena_allocator<U>& other) const noexcept
+    {
+        return m_arena == &other.arena();
+    }
+
+    template<typename U>
+    bool operator!=(const arena_allocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    ring_buffer_arena* m_arena;  /*!< Arena the memory comes from.*/
+};
+
+/// @brief Ring buffer allocating from a ring_buffer_arena.
+template<typename T>
+using arena_ring_buffer = ring_buffer<T, arena_allocator<T>>;
+
+#if defined(RING_BUFFER_HAS_PMR)
+
+/// @brief Memory resource allocating from a ring_buffer_arena, for std::pmr::polymorphic_allocator. Lets buffers of std::pmr types share the arena with their elements.
+class ring_buffer_arena_resource : public std::pmr::memory_resource
+{
+public:
+    /// @brief Constructor.
+    /// @param chunkSize Size of the chunks of the arena.
+    explicit ring_buffer_arena_resource(size_t chunkSize = 64 * 1024) noexcept : m_arena(chunkSize)
+    {
+    }
+
+    /// @brief The arena resources are allocated from.
+    ring_buffer_arena& arena() noexcept
+    {
+        return m_arena;
+    }
+
+    /// @brief Releases all memory, see ring_buffer_arena::reset().
+    void reset() noexcept
+    {
+        m_arena.reset();
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        return m_arena.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        m_arena.deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    ring_buffer_arena m_arena;  /*!< Arena the memory comes from.*/
+};
+
+/// @brief Ring buffer using a polymorphic allocator.
+template<typename T>
+using pmr_ring_buffer = ring_buffer<T, std::pmr::polymorphic_allocator<T>>;
+
+#endif
+
+#endif
@@ -0,0 +1,491 @@
+#ifndef DYNAMIC_RINGBUFFER_CHANNEL_HPP
+#define DYNAMIC_RINGBUFFER_CHANNEL_HPP
+
+#include "ring_buffer.hpp"
+
+#if !defined(__cpp_impl_coroutine)
+#error "ring_buffer_channel.hpp requires C++20 coroutines."
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+/// @brief Asynchronous FIFO channel over a ring_buffer. Producers co_await push() and consumers co_await pop() or pop_batch(). A consumer suspends while the channel
+/// is empty and, with a bound, a producer suspends while it is full, without spinning or blocking the thread.
+/// @tparam T Type of the elements. Must be MoveConstructible.
+/// @tparam Allocator Allocator of the underlying ring_buffer.
+/// @tparam CapacityPolicy Capacity policy of the underlying ring_buffer.
+/// @note Any number of coroutines on any threads may use the channel. A mutex guards the buffer and the lists of suspended coroutines for the few instructions
+/// of each operation and is never held while a coroutine runs. A value pushed while a consumer waits is handed to it directly, and a consumer that makes room moves
+/// the value of the first waiting producer into the buffer, so a resumed coroutine never has to wait again. Waiters are resumed in FIFO order through the resume
+/// function, which defaults to resuming them inline on the waking thread. Pass one that posts the handle to an event loop to resume them there instead.
+template<typename T, typename Allocator = std::allocator<T>, typename CapacityPolicy = default_capacity_policy>
+class ring_channel
+{
+public:
+
+    using buffer_type = ring_buffer<T, Allocator, CapacityPolicy>;
+    using size_type = typename buffer_type::size_type;
+    using value_type = T;
+    using resume_function = std::function<void(std::coroutine_handle<>)>;
+
+private:
+
+    /// @brief Suspended consumer. The producer that resumes it moves a value into m_value, which stays empty if the channel was closed.
+    struct consumer_node
+    {
+        std::coroutine_handle<> m_handle;
+        consumer_node* m_next = nullptr;
+        std::optional<T> m_value;
+    };
+
+    /// @brief Suspended producer. The consumer that resumes it moves *m_value into the buffer and sets m_accepted.
+    struct producer_node
+    {
+        std::coroutine_handle<> m_handle;
+        producer_node* m_next = nullptr;
+        T* m_value = nullptr;
+        bool m_accepted = false;
+    };
+
+    /// @brief Intrusive FIFO of suspended coroutines. The nodes live in the awaiters, inside the coroutine frames.
+    template<typename Node>
+    struct waiter_list
+    {
+        Node* m_first = nullptr;
+        Node* m_last = nullptr;
+
+        bool empty() const noexcept { return m_first == nullptr; }
+
+        void push(Node* node) noexcept
+        {
+            node->m_next = nullptr;
+            (m_last ? m_last->m_next : m_first) = node;
+            m_last = node;
+        }
+
+        Node* pop() noexcept
+        {
+            Node* node = m_first;
+            m_first = node->m_next;
+            if (m_first == nullptr)
+            {
+                m_last = nullptr;
+            }
+            return node;
+        }
+
+        /// @brief Removes all nodes, returning the first one. The rest stay linked through m_next.
+        Node* take() noexcept
+        {
+            m_last = nullptr;
+            return std::exchange(m_first, nullptr);
+        }
+    };
+
+public:
+
+    /// @brief Awaitable of push(). Resumes with true once the value is in the channel or handed to a consumer, false if the channel was closed.
+    class push_awaiter
+    {
+    public:
+        push_awaiter(const push_awaiter&) = delete;
+        push_awaiter& operator=(const push_awaiter&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        /// @brief Pushes the value unless the channel is full, otherwise queues the producer.
+        /// @return False if the producer continues without suspending.
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            m_node.m_handle = handle;
+            m_node.m_value = &m_value;
+            return m_channel.suspendPush(m_node);
+        }
+
+        bool await_resume() const noexcept { return m_node.m_accepted; }
+
+    private:
+        friend class ring_channel;
+
+        push_awaiter(ring_channel& channel, T&& value) : m_channel(channel), m_value(std::move(value)) {}
+
+        ring_channel& m_channel;
+        T m_value;
+        producer_node m_node;
+    };
+
+    /// @brief Awaitable of pop(). Resumes with the oldest value, or an empty optional once the channel is closed and drained.
+    class pop_awaiter
+    {
+    public:
+        pop_awaiter(const pop_awaiter&) = delete;
+        pop_awaiter& operator=(const pop_awaiter&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        /// @brief Takes a value unless the channel is empty, otherwise queues the consumer.
+        /// @return False if the consumer continues without suspending.
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            m_node.m_handle = handle;
+            return m_channel.suspendPop(m_node);
+        }
+
+        std::optional<T> await_resume() noexcept(std::is_nothrow_move_constructible<T>::value) { return std::move(m_node.m_value); }
+
+    private:
+        friend class ring_channel;
+
+        explicit pop_awaiter(ring_channel& channel) noexcept : m_channel(channel) {}
+
+        ring_channel& m_channel;
+        consumer_node m_node;
+    };
+
+    /// @brief Awaitable of pop_batch(). Resumes with the amount of values written, 0 only once the channel is closed and drained.
+    template<typename OutputIt>
+    class pop_batch_awaiter
+    {
+    public:
+        pop_batch_awaiter(const pop_batch_awaiter&) = delete;
+        pop_batch_awaiter& operator=(const pop_batch_awaiter&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        /// @brief Moves up to max values out unless the channel is empty, otherwise queues the consumer.
+        /// @return False if the consumer continues without suspending.
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            m_node.m_handle = handle;
+            return m_channel.suspendPopBatch(m_node, m_out, m_max, m_count);
+        }
+
+        /// @brief After waiting, writes the value handed over and whatever else has arrived since, up to max values.
+        size_type await_resume()
+        {
+            if (m_node.m_value)
+            {
+                *m_out = std::move(*m_node.m_value);
+                ++m_out;
+                m_count = 1 + m_channel.drain(m_out, m_max - 1);
+            }
+            return m_count;
+        }
+
+    private:
+        friend class ring_channel;
+
+        pop_batch_awaiter(ring_channel& channel, OutputIt out, size_type max) : m_channel(channel), m_out(out), m_max(max) {}
+
+        ring_channel& m_channel;
+        OutputIt m_out;
+        size_type m_max;
+        size_type m_count = 0;
+        consumer_node m_node;
+    };
+
+    /// @brief Constructs an open, empty channel.
+    /// @param bound Maximum amount of buffered values before producers suspend, 0 for an unbounded channel. A bounded channel allocates its memory up front.
+    /// @param resume Function that resumes a woken coroutine, an empty function resumes it inline on the waking thread.
+    /// @throw Can throw std::bad_alloc.
+    explicit ring_channel(size_type bound = 0, resume_function resume = resume_function()) : m_bound(bound), m_resume(std::move(resume))
+    {
+        if (bound)
+        {
+            m_buffer.reserve(bound + allocBuffer);
+        }
+    }
+
+    ring_channel(const ring_channel&) = delete;
+    ring_channel& operator=(const ring_channel&) = delete;
+
+    /// @brief Destructor.
+    /// @pre No coroutine is suspended on the channel. close() resumes them.
+    ~ring_channel() = default;
+
+    /// @brief Pushes value to the back of the channel, suspending while a bounded channel is full.
+    /// @param value Value to push. Kept in the awaiter while the producer is suspended.
+    /// @return Awaitable resuming with true once the value is in the channel, or false if the channel is or gets closed first.
+    /// If false the value is destroyed with the awaiter. A producer that must keep its value on failure can use try_push(T&&) instead.
+    /// @throw The awaitable can throw std::bad_alloc from an unbounded channel growing, or something from value_type's move constructor.
+    push_awaiter push(T value)
+    {
+        return push_awaiter(*this, std::move(value));
+    }
+
+    /// @brief Pops the front of the channel, suspending while it is empty.
+    /// @return Awaitable resuming with the value, or an empty optional once the channel is closed and drained.
+    pop_awaiter pop() noexcept
+    {
+        return pop_awaiter(*this);
+    }
+
+    /// @brief Moves up to max values from the front of the channel to out, suspending while it is empty.
+    /// @tparam OutputIt Output iterator, for example a pointer or std::back_insert_iterator.
+    /// @param out Destination of the values. Must stay valid until the awaitable resumes.
+    /// @param max Maximum amount of values to take, at least 1.
+    /// @return Awaitable resuming with the amount of values written, at least 1 unless the channel is closed and drained.
+    /// @note The values are moved one contiguous segment at a time, with memcpy for trivially copyable elements and pointer destinations.
+    template<typename OutputIt>
+    pop_batch_awaiter<OutputIt> pop_batch(OutputIt out, size_type max)
+    {
+        return pop_batch_awaiter<OutputIt>(*this, out, max);
+    }
+
+    /// @brief Pushes value without suspending.
+    /// @return True if the value was pushed or handed to a waiting consumer, false if the channel is full or closed. value is left unchanged if false.
+    /// @throw Can throw std::bad_alloc from an unbounded channel growing, or something from value_type's move constructor.
+    bool try_push(T&& value)
+    {
+        producer_node node;
+        node.m_value = &value;
+        if (!pushOrHandOff(node))
+        {
+            return false;
+        }
+        return node.m_accepted;
+    }
+
+    /// @brief Copies value to the channel without suspending. See try_push(T&&).
+    bool try_push(const T& value)
+    {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+
+    /// @brief Pops the front value without suspending.
+    /// @return The value, or an empty optional if the channel is empty.
+    std::optional<T> try_pop()
+    {
+        consumer_node node;
+        takeOne(node);
+        return std::move(node.m_value);
+    }
+
+    /// @brief Closes the channel and resumes all suspended coroutines. Waiting producers resume with false, waiting consumers with nothing.
+    /// @note The value of a waiting producer was moved into its push_awaiter by push() and is destroyed with the awaiter after co_await returns.
+    /// Values already in the channel can still be popped. Later pushes fail. Closing twice does nothing.
+    void close()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closed = true;
+        consumer_node* consumer = m_consumers.take();
+        producer_node* producer = m_producers.take();
+        lock.unlock();
+
+        // Resuming a coroutine can destroy its node, so the next one is read first.
+        while (consumer)
+        {
+            resume(std::exchange(consumer, consumer->m_next)->m_handle);
+        }
+        while (producer)
+        {
+            resume(std::exchange(producer, producer->m_next)->m_handle);
+        }
+    }
+
+    /// @brief True once close() has been called.
+    bool closed() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed;
+    }
+
+    /// @brief Amount of buffered values. Only a snapshot if other threads use the channel.
+    size_type size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_buffer.size();
+    }
+
+    /// @brief True if no values are buffered. Only a snapshot if other threads use the channel.
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// @brief Maximum amount of buffered values, 0 if the channel is unbounded.
+    size_type bound() const noexcept { return m_bound; }
+
+private:
+
+    bool full() const noexcept
+    {
+        return m_bound && m_buffer.size() >= m_bound;
+    }
+
+    void resume(std::coroutine_handle<> handle)
+    {
+        if (m_resume)
+        {
+            m_resume(handle);
+        }
+        else
+        {
+            handle.resume();
+        }
+    }
+
+    /// @brief Hands *node.m_value to the first waiting consumer, or pushes it if there is room.
+    /// @return False if the channel is full and open, node is unchanged. Otherwise node.m_accepted tells whether the value went in.
+    bool pushOrHandOff(producer_node& node)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return pushOrHandOff(node, lock);
+    }
+
+    bool pushOrHandOff(producer_node& node, std::unique_lock<std::mutex>& lock)
+    {
+        if (m_closed)
+        {
+            node.m_accepted = false;
+            return true;
+        }
+        if (!m_consumers.empty())
+        {
+            // The value is moved before the consumer is dequeued, so a throwing move constructor leaves it waiting.
+            m_consumers.m_first->m_value.emplace(std::move(*node.m_value));
+            consumer_node* consumer = m_consumers.pop();
+            node.m_accepted = true;
+            lock.unlock();
+            resume(consumer->m_handle);
+            return true;
+        }
+        if (full())
+        {
+            return false;
+        }
+        m_buffer.push_back(std::move(*node.m_value));
+        node.m_accepted = true;
+        return true;
+    }
+
+    /// @brief Pushes for push_awaiter, queuing the producer if the channel is full.
+    /// @return True if the producer has to suspend.
+    bool suspendPush(producer_node& node)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (pushOrHandOff(node, lock))
+        {
+            return false;
+        }
+        m_producers.push(&node);
+        return true;
+    }
+
+    /// @brief Moves the values of waiting producers into the room left by count popped values. Called with the lock held.
+    /// @return The admitted producers linked through m_next, to be resumed after unlocking.
+    producer_node* admitProducers(size_type count)
+    {
+        producer_node* first = nullptr;
+        producer_node* last = nullptr;
+        for (; count && !m_producers.empty() && !full(); --count)
+        {
+            m_buffer.push_back(std::move(*m_producers.m_first->m_value));
+            producer_node* producer = m_producers.pop();
+            producer->m_accepted = true;
+            producer->m_next = nullptr;
+            (last ? last->m_next : first) = producer;
+            last = producer;
+        }
+        return first;
+    }
+
+    void resumeProducers(producer_node* producer)
+    {
+        while (producer)
+        {
+            resume(std::exchange(producer, producer->m_next)->m_handle);
+        }
+    }
+
+    /// @brief Moves the front value into node.m_value if there is one, and admits a waiting producer into the room.
+    /// @return True if a value was taken.
+    bool takeOne(consumer_node& node)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return takeOne(node, lock);
+    }
+
+    bool takeOne(consumer_node& node, std::unique_lock<std::mutex>& lock)
+    {
+        if (m_buffer.empty())
+        {
+            return false;
+        }
+        node.m_value.emplace(std::move(m_buffer.front()));
+        m_buffer.pop_front();
+        producer_node* producers = admitProducers(1);
+        lock.unlock();
+        resumeProducers(producers);
+        return true;
+    }
+
+    /// @brief Pops for pop_awaiter, queuing the consumer if the channel is empty and open.
+    /// @return True if the consumer has to suspend.
+    bool suspendPop(consumer_node& node)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (takeOne(node, lock) || m_closed)
+        {
+            return false;
+        }
+        m_consumers.push(&node);
+        return true;
+    }
+
+    /// @brief Moves up to max buffered values to out and admits waiting producers into the room. Releases the lock.
+    /// @return Amount of values moved.
+    template<typename OutputIt>
+    size_type drain(OutputIt& out, size_type max, std::unique_lock<std::mutex>& lock)
+    {
+        const size_type count = std::min(max, m_buffer.size());
+        out = m_buffer.consume(out, count);
+        producer_node* producers = admitProducers(count);
+        lock.unlock();
+        resumeProducers(producers);
+        return count;
+    }
+
+    template<typename OutputIt>
+    size_type drain(OutputIt& out, size_type max)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return drain(out, max, lock);
+    }
+
+    /// @brief Pops for pop_batch_awaiter, queuing the consumer if the channel is empty and open.
+    /// @return True if the consumer has to suspend.
+    template<typename OutputIt>
+    bool suspendPopBatch(consumer_node& node, OutputIt& out, size_type max, size_type& count)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_buffer.empty())
+        {
+            count = drain(out, max, lock);
+            return false;
+        }
+        if (m_closed)
+        {
+            return false;
+        }
+        m_consumers.push(&node);
+        return true;
+    }
+
+    buffer_type m_buffer;  /*!< Buffered values, oldest first.*/
+    waiter_list<consumer_node> m_consumers;  /*!< Consumers suspended on an empty channel.*/
+    waiter_list<producer_node> m_producers;  /*!< Producers suspended on a full channel.*/
+    mutable std::mutex m_mutex;  /*!< Guards all of the above and m_closed.*/
+    size_type m_bound;  /*!< Maximum amount of buffered values, 0 if unbounded.*/
+    bool m_closed = false;
+    resume_function m_resume;  /*!< Resumes woken coroutines, inline if empty.*/
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef DYNAMIC_RINGBUFFER_IO_HPP
+#define DYNAMIC_RINGBUFFER_IO_HPP
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#error "ring_buffer_io.hpp requires a POSIX system with readv and writev."
+#endif
+
+namespace
+{
+    // Reads or writes the rest of an element that was transferred partially. Waits for the descriptor if it is non-blocking.
+    // Returns the amount of bytes transferred, less than count if the stream ended or failed before the element was complete.
+    template<typename Transfer>
+    size_t _completeElement(int fd, short events, char* bytes, size_t count, Transfer transfer) noexcept
+    {
+        size_t total = 0;
+        while (total < count)
+        {
+            const ssize_t done = transfer(fd, bytes + total, count - total);
+            if (done > 0)
+            {
+                total += static_cast<size_t>(done);
+            }
+            else if (done < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                pollfd waitFd{ fd, events, 0 };
+                ::poll(&waitFd, 1, -1);
+            }
+            else if (done == 0 || errno != EINTR)
+            {
+                break;
+            }
+        }
+        return total;
+    }
+
+    // Address of the index:th slot of two consecutive segments.
+    template<typename Span>
+    char* _segmentAddress(const Span& first, const Span& second, size_t index) noexcept
+    {
+        return reinterpret_cast<char*>(index < first.size() ? first.data() + index : second.data() + (index - first.size()));
+    }
+}
+
+/// @brief Reads up to max elements from a file descriptor directly into the free memory of the buffer, with a single readv over its two free segments.
+/// @param buffer Buffer to append the elements to.
+/// @param fd File descriptor to read from.
+/// @param max Maximum amount of elements to read.
+/// @return Amount of bytes appended to the buffer, 0 at the end of the stream, or -1 with errno set as by readv. errno is ENOBUFS if the buffer has no free memory.
+/// @pre value_type must be trivially copyable.
+/// @note The buffer does not grow, reserve() room for the expected data first. size() grows by the amount of whole elements read. If readv returns part of an element,
+/// the rest of it is read before returning, waiting for the descriptor if needed. If the stream ends in the middle of an element, the incomplete element is dropped.
+/// @details Linear complexity in relation to the amount of bytes read, which are copied once by the kernel.
+template<typename T, typename Allocator, typename CapacityPolicy>
+ssize_t read_from(ring_buffer<T, Allocator, CapacityPolicy>& buffer, int fd, size_t max) noexcept
+{
+    static_assert(std::is_trivially_copyable<T>::value, "read_from requires a trivially copyable value_type");
+
+    const auto first = buffer.free_array_one();
+    const auto second = buffer.free_array_two();
+    const auto firstCount = std::min(max, first.size());
+    const auto secondCount = std::min(max - firstCount, second.size());
+    if (max == 0)
+    {
+        return 0;
+    }
+    if (firstCount == 0)
+    {
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    iovec segments[2] = { { first.data(), firstCount * sizeof(T) }, { second.data(), secondCount * sizeof(T) } };
+    const ssize_t result = ::readv(fd, segments, secondCount ? 2 : 1);
+    if (result <= 0)
+    {
+        return result;
+    }
+
+    auto elements = static_cast<size_t>(result) / sizeof(T);
+    const auto partial = static_cast<size_t>(result) % sizeof(T);
+    if (partial)
+    {
+        auto bytes = _segmentAddress(first, second, elements) + partial;
+        const auto rest = sizeof(T) - partial;
+        if (_completeElement(fd, POLLIN, bytes, rest, [](int f, char* b, size_t c) { return ::read(f, b, c); }) == rest)
+        {
+            ++elements;
+        }
+    }
+
+    buffer.commit_back(elements);
+    return static_cast<ssize_t>(elements * sizeof(T));
+}
+
+/// @brief Writes up to max elements from the front of the buffer to a file descriptor, with a single writev over the two segments of elements.
+/// @param buffer Buffer to remove the written elements from.
+/// @param fd File descriptor to write to.
+/// @param max Maximum amount of elements to write.
+/// @return Amount of bytes written and removed from the buffer, or -1 with errno set as by writev.
+/// @pre value_type must be trivially copyable.
+/// @note If writev writes part of an element, the rest of it is written before returning, waiting for the descriptor if needed. An element is removed from the buffer once
+/// any of its bytes are written, as writing it again would repeat those bytes. If the rest of an element can't be written, the return value tells the exact amount of bytes written.
+/// @details Linear complexity in relation to the amount of bytes written, which are copied once by the kernel.
+template<typename T, typename Allocator, typename CapacityPolicy>
+ssize_t write_to(ring_buffer<T, Allocator, CapacityPolicy>& buffer, int fd, size_t max) noexcept
+{
+    static_assert(std::is_trivially_copyable<T>::value, "write_to requires a trivially copyable value_type");
+
+    const auto first = buffer.array_one();
+    const auto second = buffer.array_two();
+    const auto firstCount = std::min(max, first.size());
+    const auto secondCount = std::min(max - firstCount, second.size());
+    if (firstCount + secondCount == 0)
+    {
+        return 0;
+    }
+
+    iovec segments[2] = { { first.data(), firstCount * sizeof(T) }, { second.data(), secondCount * sizeof(T) } };
+    const ssize_t result = ::writev(fd, segments, secondCount ? 2 : 1);
+    if (result <= 0)
+    {
+        return result;
+    }
+
+    auto elements = static_cast<size_t>(result) / sizeof(T);
+    const auto partial = static_cast<size_t>(result) % sizeof(T);
+    auto written = result;
+    if (partial)
+    {
+        auto bytes = _segmentAddress(first, second, elements) + partial;
+        written += static_cast<ssize_t>(_completeElement(fd, POLLOUT, bytes, sizeof(T) - partial, [](int f, char* b, size_t c) { return ::write(f, b, c); }));
+        ++elements;
+    }
+
+    buffer.pop_front_n(elements);
+    return written;
+}
+
+#endif
@@ -0,0 +1,421 @@
+#ifndef DYNAMIC_RINGBUFFER_MAPPED_HPP
+#define DYNAMIC_RINGBUFFER_MAPPED_HPP
+
+#include "ring_buffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#error "ring_buffer_mapped.hpp requires a POSIX system with mmap."
+#endif
+
+/// @brief Layout of the first page of a mapped_ring_buffer file. The slots follow at the start of the next page.
+struct mapped_ring_buffer_header
+{
+    static constexpr std::uint64_t magic = 0x31464652474e4952ULL;  /*!< "RINGRFF1" in little endian.*/
+    static constexpr std::uint32_t version = 1;
+
+    std::uint64_t m_magic;  /*!< Written last when the file is created, so a file without it was never initialized.*/
+    std::uint32_t m_version;
+    std::uint32_t m_elementSize;  /*!< sizeof the element type, checked on reopen.*/
+    std::uint64_t m_capacity;  /*!< Amount of slots, one more than the amount of elements the file holds.*/
+    std::uint64_t m_headIndex;  /*!< Index past the last element.*/
+    std::uint64_t m_tailIndex;  /*!< Index of the first element.*/
+    std::uint64_t m_dropped;  /*!< Amount of elements overwritten since the file was created.*/
+};
+
+/// @brief Fixed capacity FIFO journal that lives in a memory mapped file, so it survives the process and reopens without parsing.
+/// @tparam T Type of the elements. Must be trivially copyable, the bytes are stored as they are.
+/// @note The file starts with a mapped_ring_buffer_header holding the capacity, head and tail indices, followed by the slots. Reopening an existing file maps it
+/// and takes the indices from the header, so restart time doesn't depend on the amount of elements. Like overwrite_ring_buffer, a push to a full journal drops the oldest element.
+/// Every push writes the element before it publishes the new head index, so a crashed process leaves a consistent file behind, the kernel still holds the pages.
+/// Surviving a system crash needs the pages on disk: sync() flushes the slots written since the previous sync, then the header, with msync.
+/// Pass a sync interval to do so automatically every that many pushes. Elements pushed after the last sync may be lost with the system.
+/// The file has the byte order and element layout of the machine that wrote it. Only one object may use a file at a time.
+template<typename T>
+class mapped_ring_buffer
+{
+    static_assert(std::is_trivially_copyable<T>::value, "mapped_ring_buffer stores the bytes of its elements, T must be trivially copyable");
+
+public:
+
+    using size_type = std::size_t;
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using span = ring_buffer_span<T>;
+    using const_span = ring_buffer_span<const T>;
+
+    /// @brief Opens the journal at path, creating it if the file is missing or empty.
+    /// @param path Path of the file.
+    /// @param capacity Maximum amount of elements a new file holds. An existing file keeps the capacity it was created with.
+    /// @param syncInterval Amount of pushes after which sync() is called automatically, 0 to sync only explicitly and on destruction. Automatic syncs don't report errors.
+    /// @throw Throws std::system_error if the file can't be opened, sized or mapped, std::invalid_argument if a new file would have no room,
+    /// and std::runtime_error if an existing file isn't a journal of sizeof(T) byte elements.
+    /// @details Constant complexity, the contents of an existing file aren't read.
+    mapped_ring_buffer(const char* path, size_type capacity, size_type syncInterval = 0)
+        : m_file(-1), m_header(nullptr), m_data(nullptr), m_mappedBytes(0), m_syncInterval(syncInterval), m_unsynced(0), m_syncedHead(0)
+    {
+        m_file = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_file < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: can't open journal");
+        }
+        try
+        {
+            openFile(capacity);
+        }
+        catch (...)
+        {
+            unmap();
+            throw;
+        }
+        m_syncedHead = m_header->m_headIndex;
+    }
+
+    /// @brief Opens the journal at path. See mapped_ring_buffer(const char*, size_type, size_type).
+    mapped_ring_buffer(const std::string& path, size_type capacity, size_type syncInterval = 0) : mapped_ring_buffer(path.c_str(), capacity, syncInterval) {}
+
+    mapped_ring_buffer(const mapped_ring_buffer&) = delete;
+    mapped_ring_buffer& operator=(const mapped_ring_buffer&) = delete;
+    mapped_ring_buffer& operator=(mapped_ring_buffer&&) = delete;
+
+    /// @brief Move constructor. Other no longer refers to a file, only destruction is allowed.
+    mapped_ring_buffer(mapped_ring_buffer&& other) noexcept
+        : m_file(std::exchange(other.m_file, -1)), m_header(std::exchange(other.m_header, nullptr)), m_data(std::exchange(other.m_data, nullptr)),
+        m_mappedBytes(std::exchange(other.m_mappedBytes, 0)), m_syncInterval(other.m_syncInterval), m_unsynced(std::exchange(other.m_unsynced, 0)), m_syncedHead(other.m_syncedHead)
+    {
+    }
+
+    /// @brief Destructor. Syncs the journal, then unmaps and closes the file.
+    ~mapped_ring_buffer()
+    {
+        if (m_header)
+        {
+            syncMapping();
+        }
+        unmap();
+    }
+
+    /// @brief Copies value to the back of the journal, dropping the front element if the journal is full.
+    /// @details Constant complexity, plus a sync every sync interval pushes.
+    void push_back(const value_type& value) noexcept
+    {
+        const auto head = m_header->m_headIndex;
+        const auto nextHead = next(head);
+        if (nextHead == m_header->m_tailIndex)
+        {
+            m_header->m_tailIndex = next(nextHead);
+            ++m_header->m_dropped;
+        }
+        std::memcpy(static_cast<void*>(m_data + head), &value, sizeof(T));
+        publishHead(nextHead, 1);
+    }
+
+    /// @brief Copies count values to the back of the journal, dropping front elements to make room. Only the last capacity() values are kept if there are more.
+    /// @param values Pointer to the first value.
+    /// @param count Amount of values.
+    /// @note The values are copied with at most two memcpy calls and the head index is published once.
+    /// @details Linear complexity in relation to count, plus at most one sync.
+    void append(const value_type* values, size_type count) noexcept
+    {
+        if (count > capacity())
+        {
+            m_header->m_dropped += count - capacity();
+            values += count - capacity();
+            count = capacity();
+        }
+        const auto room = capacity() - size();
+        if (count > room)
+        {
+            m_header->m_tailIndex = advance(m_header->m_tailIndex, count - room);
+            m_header->m_dropped += count - room;
+        }
+
+        const auto head = m_header->m_headIndex;
+        const auto firstCount = std::min<size_type>(count, slots() - head);
+        std::memcpy(static_cast<void*>(m_data + head), values, firstCount * sizeof(T));
+        std::memcpy(static_cast<void*>(m_data), values + firstCount, (count - firstCount) * sizeof(T));
+        publishHead(advance(head, count), count);
+    }
+
+    /// @brief Removes the front element.
+    /// @pre The journal is not empty.
+    void pop_front() noexcept
+    {
+        m_header->m_tailIndex = next(m_header->m_tailIndex);
+    }
+
+    /// @brief Removes the first count elements.
+    /// @pre count <= size().
+    void pop_front_n(size_type count) noexcept
+    {
+        m_header->m_tailIndex = advance(m_header->m_tailIndex, count);
+    }
+
+    /// @brief Removes all elements.
+    void clear() noexcept
+    {
+        m_header->m_tailIndex = m_header->m_headIndex;
+    }
+
+    /// @brief Returns the element at index, counted from the front.
+    /// @pre index < size().
+    reference operator[](size_type index) noexcept { return m_data[advance(m_header->m_tailIndex, index)]; }
+    const_reference operator[](size_type index) const noexcept { return m_data[advance(m_header->m_tailIndex, index)]; }
+
+    /// @brief Returns the element at index, counted from the front.
+    /// @throw Throws std::out_of_range if index >= size().
+    reference at(size_type index)
+    {
+        if (index >= size())
+        {
+            throw std::out_of_range("mapped_ring_buffer: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const
+    {
+        return const_cast<mapped_ring_buffer&>(*this).at(index);
+    }
+
+    /// @brief Returns the oldest element. The journal must not be empty.
+    reference front() noexcept { return m_data[m_header->m_tailIndex]; }
+    const_reference front() const noexcept { return m_data[m_header->m_tailIndex]; }
+
+    /// @brief Returns the newest element. The journal must not be empty.
+    reference back() noexcept { return m_data[retreat(m_header->m_headIndex)]; }
+    const_reference back() const noexcept { return m_data[retreat(m_header->m_headIndex)]; }
+
+    /// @brief Returns the elements from the front up to the end of the slots, or up to the back if they don't wrap. Together with array_two() all elements in order.
+    span array_one() noexcept { return span(m_data + m_header->m_tailIndex, firstSegmentSize()); }
+    const_span array_one() const noexcept { return const_span(m_data + m_header->m_tailIndex, firstSegmentSize()); }
+
+    /// @brief Returns the elements that wrapped around to the start of the slots, empty if none did.
+    span array_two() noexcept { return span(m_data, size() - firstSegmentSize()); }
+    const_span array_two() const noexcept { return const_span(m_data, size() - firstSegmentSize()); }
+
+    /// @brief Flushes the slots written since the previous sync to the file, then the header, and waits until both are on disk.
+    /// @throw Throws std::system_error if msync fails.
+    /// @details Linear complexity in relation to the amount of pushes since the previous sync.
+    void sync()
+    {
+        if (!syncMapping())
+        {
+            throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: msync failed");
+        }
+    }
+
+    /// @brief Amount of elements pushed since the previous sync.
+    size_type unsynced() const noexcept { return m_unsynced; }
+
+    /// @brief Amount of pushes between automatic syncs, 0 if syncs are only explicit.
+    size_type sync_interval() const noexcept { return m_syncInterval; }
+
+    /// @brief Changes the amount of pushes between automatic syncs, 0 to sync only explicitly.
+    void set_sync_interval(size_type syncInterval) noexcept { m_syncInterval = syncInterval; }
+
+    /// @brief Amount of elements in the journal.
+    size_type size() const noexcept
+    {
+        const auto head = m_header->m_headIndex;
+        const auto tail = m_header->m_tailIndex;
+        return static_cast<size_type>(head >= tail ? head - tail : slots() - tail + head);
+    }
+
+    bool empty() const noexcept { return m_header->m_headIndex == m_header->m_tailIndex; }
+
+    /// @brief Maximum amount of elements, fixed when the file was created.
+    size_type capacity() const noexcept { return slots() - 1; }
+
+    /// @brief Amount of elements overwritten by pushes to a full journal since the file was created.
+    std::uint64_t dropped() const noexcept { return m_header->m_dropped; }
+
+private:
+
+    /// @brief Size of the system page. The header fills the first page so the slots start page aligned.
+    static size_type pageSize() noexcept
+    {
+        static const size_type size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    size_type slots() const noexcept { return static_cast<size_type>(m_header->m_capacity); }
+
+    size_type next(size_type index) const noexcept { return index + 1 == slots() ? 0 : index + 1; }
+
+    size_type retreat(size_type index) const noexcept { return (index == 0 ? slots() : index) - 1; }
+
+    size_type advance(size_type index, size_type count) const noexcept
+    {
+        index += count;
+        return index >= slots() ? index - slots() : index;
+    }
+
+    size_type firstSegmentSize() const noexcept
+    {
+        const auto head = m_header->m_headIndex;
+        const auto tail = m_header->m_tailIndex;
+        return static_cast<size_type>(tail <= head ? head - tail : slots() - tail);
+    }
+
+    /// @brief Publishes the head index after the elements, and syncs if the interval is reached.
+    void publishHead(size_type head, size_type count) noexcept
+    {
+        // The compiler must not move the element stores after the index store, or a crash in between would expose stale slots.
+        std::atomic_signal_fence(std::memory_order_release);
+        m_header->m_headIndex = head;
+        m_unsynced += count;
+        if (m_syncInterval && m_unsynced >= m_syncInterval)
+        {
+            syncMapping();
+        }
+    }
+
+    /// @brief Maps a new or existing file. Called by the constructor once m_file is open.
+    void openFile(size_type capacity)
+    {
+        static_assert(alignof(T) <= 4096 && sizeof(mapped_ring_buffer_header) <= 4096, "the header and the alignment of T must fit in a page");
+
+        struct stat status;
+        if (::fstat(m_file, &status) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: can't stat journal");
+        }
+
+        const bool created = status.st_size == 0;
+        size_type slotCount = capacity + 1;
+        if (created)
+        {
+            if (capacity == 0 || capacity > (std::numeric_limits<size_type>::max() - pageSize()) / sizeof(T) - 1)
+            {
+                throw std::invalid_argument("mapped_ring_buffer: invalid capacity");
+            }
+            if (::ftruncate(m_file, static_cast<off_t>(pageSize() + slotCount * sizeof(T))) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: can't size journal");
+            }
+        }
+        else
+        {
+            mapped_ring_buffer_header header;
+            if (static_cast<size_type>(status.st_size) < pageSize() || ::pread(m_file, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+                header.m_magic != mapped_ring_buffer_header::magic || header.m_version != mapped_ring_buffer_header::version || header.m_elementSize != sizeof(T) ||
+                header.m_capacity < 2 || header.m_capacity > (static_cast<std::uint64_t>(status.st_size) - pageSize()) / sizeof(T) ||
+                header.m_headIndex >= header.m_capacity || header.m_tailIndex >= header.m_capacity)
+            {
+                throw std::runtime_error("mapped_ring_buffer: file is not a journal of this element type");
+            }
+            slotCount = static_cast<size_type>(header.m_capacity);
+        }
+
+        m_mappedBytes = pageSize() + slotCount * sizeof(T);
+        void* region = ::mmap(nullptr, m_mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+        if (region == MAP_FAILED)
+        {
+            m_mappedBytes = 0;
+            throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: can't map journal");
+        }
+        m_header = static_cast<mapped_ring_buffer_header*>(region);
+        m_data = reinterpret_cast<T*>(static_cast<char*>(region) + pageSize());
+
+        if (created)
+        {
+            m_header->m_version = mapped_ring_buffer_header::version;
+            m_header->m_elementSize = static_cast<std::uint32_t>(sizeof(T));
+            m_header->m_capacity = slotCount;
+            m_header->m_headIndex = 0;
+            m_header->m_tailIndex = 0;
+            m_header->m_dropped = 0;
+            std::atomic_signal_fence(std::memory_order_release);
+            m_header->m_magic = mapped_ring_buffer_header::magic;
+            if (::msync(region, pageSize(), MS_SYNC) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "mapped_ring_buffer: msync failed");
+            }
+        }
+    }
+
+    /// @brief Flushes the pages holding slots [first, first + count), which must not wrap.
+    bool syncSlots(size_type first, size_type count) noexcept
+    {
+        if (count == 0)
+        {
+            return true;
+        }
+        const auto begin = reinterpret_cast<std::uintptr_t>(m_data + first) & ~static_cast<std::uintptr_t>(pageSize() - 1);
+        const auto end = reinterpret_cast<std::uintptr_t>(m_data + first + count);
+        return ::msync(reinterpret_cast<void*>(begin), static_cast<size_t>(end - begin), MS_SYNC) == 0;
+    }
+
+    /// @brief Syncs the slots written since the previous sync, then the header.
+    /// @return False with errno set if an msync failed.
+    bool syncMapping() noexcept
+    {
+        const auto head = static_cast<size_type>(m_header->m_headIndex);
+        bool synced = true;
+        if (m_unsynced >= capacity())
+        {
+            synced = syncSlots(0, slots());
+        }
+        else if (m_syncedHead <= head)
+        {
+            synced = syncSlots(m_syncedHead, head - m_syncedHead);
+        }
+        else
+        {
+            synced = syncSlots(m_syncedHead, slots() - m_syncedHead) && syncSlots(0, head);
+        }
+        if (!synced || ::msync(m_header, pageSize(), MS_SYNC) != 0)
+        {
+            return false;
+        }
+        m_syncedHead = head;
+        m_unsynced = 0;
+        return true;
+    }
+
+    void unmap() noexcept
+    {
+        if (m_header)
+        {
+            ::munmap(m_header, m_mappedBytes);
+            m_header = nullptr;
+            m_data = nullptr;
+        }
+        if (m_file >= 0)
+        {
+            ::close(m_file);
+            m_file = -1;
+        }
+    }
+
+    int m_file;  /*!< Descriptor of the journal file.*/
+    mapped_ring_buffer_header* m_header;  /*!< Start of the mapping, holds the indices.*/
+    T* m_data;  /*!< First slot, one page after the header.*/
+    size_type m_mappedBytes;  /*!< Length of the mapping.*/
+    size_type m_syncInterval;  /*!< Pushes between automatic syncs, 0 for none.*/
+    size_type m_unsynced;  /*!< Elements pushed since the previous sync.*/
+    size_type m_syncedHead;  /*!< Head index at the previous sync, the slots from there up to the head are dirty.*/
+};
+
+#endif
@@ -0,0 +1,230 @@
+#ifndef DYNAMIC_RINGBUFFER_MIRRORED_HPP
+#define DYNAMIC_RINGBUFFER_MIRRORED_HPP
+
+#include "ring_buffer.hpp"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if !defined(__linux__)
+#include <atomic>
+#include <cstdio>
+#endif
+#else
+#error "ring_buffer_mirrored.hpp requires a POSIX system with mmap."
+#endif
+
+//Storage that maps the same memory twice back to back. Any m_capacity elements starting from an index in [0, m_capacity) are contiguous in virtual memory.
+//The memory comes from an anonymous shared memory file, the allocator is only used to construct and destroy the elements.
+    template<typename T, typename Allocator = std::allocator<T>>
+    struct mirrored_ring_buffer_base {
+
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+        using alloc_traits = std::allocator_traits<allocator_type>;
+
+        static constexpr size_type inline_capacity = 0;  /*!< Amount of elements that can be stored inside the object itself.*/
+        static constexpr bool is_mirrored = true;  /*!< True if the memory is mapped twice back to back, so that m_data[i] and m_data[i + m_capacity] are the same element.*/
+
+        size_type m_capacity;  /*!< Capacity of the buffer. Always fills whole pages.*/
+
+        T* m_data;  /*!< Pointer to the first mapping. The second one follows at m_data + m_capacity.*/
+        Allocator m_allocator;  /*!< Allocator used to construct/destruct elements.*/
+
+        mirrored_ring_buffer_base(const Allocator& alloc, size_type capacity)
+            : m_capacity(capacity), m_data(nullptr), m_allocator(alloc)
+        {
+            m_data = capacity ? allocateStorage(m_capacity) : nullptr;
+        }
+
+        mirrored_ring_buffer_base(const mirrored_ring_buffer_base&) = delete;
+        mirrored_ring_buffer_base& operator=(const mirrored_ring_buffer_base&) = delete;
+        mirrored_ring_buffer_base& operator=(mirrored_ring_buffer_base&&) = delete;
+
+        mirrored_ring_buffer_base(mirrored_ring_buffer_base&& other) noexcept
+            : m_capacity(std::exchange(other.m_capacity, 0)), m_data(std::exchange(other.m_data, nullptr)), m_allocator(std::move(other.m_allocator))
+        {
+        }
+
+        ~mirrored_ring_buffer_base() { deallocateStorage(m_data, m_capacity); }
+
+        /// @brief Mirrored memory is never inline.
+        bool isInline() const noexcept { return false; }
+
+        /// @brief Creates a new memory file and maps it twice.
+        /// @param capacity Amount of elements to allocate for. Rounded up so that the elements fill whole pages.
+        /// @throw Throws std::bad_alloc if the memory can't be created or mapped.
+        T* allocateStorage(size_type& capacity)
+        {
+            capacity = fitPages(capacity);
+            const int fd = createFile();
+            if (fd < 0)
+            {
+                throw std::bad_alloc();
+            }
+            return mapMirrored(fd, capacity);
+        }
+
+        /// @brief Maps the memory file of m_data again with room for capacity elements. The first m_capacity elements are shared with the current memory,
+        /// which stays valid until it is deallocated.
+        /// @param capacity Amount of elements to allocate for, greater than m_capacity. Rounded up so that the elements fill whole pages.
+        /// @return The new memory.
+        /// @throw Throws std::bad_alloc if the memory can't be mapped.
+        T* growStorage(size_type& capacity)
+        {
+            capacity = fitPages(capacity);
+            const int fd = ::dup(fileOf(m_data));
+            if (fd < 0)
+            {
+                throw std::bad_alloc();
+            }
+            return mapMirrored(fd, capacity);
+        }
+
+        /// @brief Unmaps memory returned by allocateStorage() or growStorage().
+        void deallocateStorage(T* data, size_type capacity) noexcept
+        {
+            if (data)
+            {
+                const int fd = fileOf(data);
+                ::munmap(reinterpret_cast<char*>(data) - headerSize(), headerSize() + 2 * capacity * sizeof(T));
+                ::close(fd);
+            }
+        }
+
+        /// @brief Deallocates the current memory and takes ownership of data. The current memory must not hold any constructed elements that aren't shared with data.
+        void replaceStorage(T* data, size_type capacity) noexcept
+        {
+            deallocateStorage(m_data, m_capacity);
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        /// @brief Gives up the ownership of the current memory without deallocating it, after it has been handed to another storage.
+        void detachStorage() noexcept
+        {
+            m_data = nullptr;
+            m_capacity = 0;
+        }
+
+        /// @brief Deallocates the current memory, leaving the storage without any. The current memory must not hold any constructed elements.
+        void releaseStorage() noexcept
+        {
+            deallocateStorage(m_data, m_capacity);
+            detachStorage();
+        }
+
+    private:
+        /// @brief Size of the system page. The descriptor of the memory file is stored in a private page in front of each mapping.
+        static size_type headerSize() noexcept
+        {
+            static const size_type pageSize = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+            return pageSize;
+        }
+
+        /// @brief Rounds capacity up to the smallest amount of elements that fills whole pages.
+        static size_type fitPages(size_type capacity) noexcept
+        {
+            size_type a = headerSize();
+            size_type b = sizeof(T);
+            while (b)
+            {
+                a = std::exchange(b, a % b);
+            }
+            const auto unit = headerSize() / a;
+            return (std::max<size_type>(capacity, 1) + unit - 1) / unit * unit;
+        }
+
+        static int fileOf(const T* data) noexcept
+        {
+            return *reinterpret_cast<const int*>(reinterpret_cast<const char*>(data) - headerSize());
+        }
+
+        /// @brief Creates an anonymous memory file.
+        /// @return File descriptor, or -1 on failure.
+        static int createFile() noexcept
+        {
+#if defined(__linux__)
+            return ::memfd_create("ring_buffer", MFD_CLOEXEC);
+#else
+            static std::atomic<unsigned> counter{ 0 };
+            char name[64];
+            std::snprintf(name, sizeof(name), "/ring_buffer.%ld.%u", static_cast<long>(::getpid()), counter++);
+            const int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+            if (fd >= 0)
+            {
+                ::shm_unlink(name);
+            }
+            return fd;
+#endif
+        }
+
+        /// @brief Sizes the file behind fd to capacity elements and maps it twice after a header page. Takes ownership of fd.
+        /// @throw Throws std::bad_alloc if the memory can't be mapped, fd is closed.
+        static T* mapMirrored(int fd, size_type capacity)
+        {
+            const auto bytes = capacity * sizeof(T);
+            if (capacity > (std::numeric_limits<size_type>::max() - headerSize()) / sizeof(T) / 2 || ::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+            {
+                ::close(fd);
+                throw std::bad_alloc();
+            }
+
+            // Reserve the whole address range first, then replace both halves with the file.
+            void* region = ::mmap(nullptr, headerSize() + 2 * bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::bad_alloc();
+            }
+
+            char* data = static_cast<char*>(region) + headerSize();
+            if (::mmap(data, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                ::mmap(data + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+            {
+                ::munmap(region, headerSize() + 2 * bytes);
+                ::close(fd);
+                throw std::bad_alloc();
+            }
+
+            *static_cast<int*>(region) = fd;
+            return reinterpret_cast<T*>(data);
+        }
+    };
+
+    template<typename T, typename Allocator>
+    constexpr typename mirrored_ring_buffer_base<T, Allocator>::size_type mirrored_ring_buffer_base<T, Allocator>::inline_capacity;
+    template<typename T, typename Allocator>
+    constexpr bool mirrored_ring_buffer_base<T, Allocator>::is_mirrored;
+
+/// @brief Mirrored capacity policy. The memory is mapped twice back to back, so all elements form one contiguous range starting from the first element.
+/// @tparam Policy Policy used for growth and moving the indices. Defaults to default_capacity_policy.
+/// @note operator[] needs no wrap around, data() never moves the elements and array_one() holds all elements, so a single pointer can be handed to write(), send() or SIMD code.
+/// The capacity is rounded up so that the elements fill whole pages. Growth maps the same memory again with more room and, for trivially relocatable elements,
+/// moves only the wrapped part on the shorter side instead of relocating every element. Requires a POSIX system, the memory comes from memfd_create or shm_open.
+template<typename Policy = default_capacity_policy>
+struct mirrored_capacity_policy : Policy
+{
+    /// @brief Storage the buffer allocates its elements from.
+    template<typename T, typename Allocator>
+    using storage = mirrored_ring_buffer_base<T, Allocator>;
+
+    /// @brief Indices up to twice the capacity address the mirror, no wrapping is needed.
+    /// @param index Index to wrap, must be less than twice the capacity.
+    /// @return The same index.
+    static constexpr size_t wrap(size_t index, size_t) noexcept
+    {
+        return index;
+    }
+};
+
+/// @brief Ring buffer with mirrored storage.
+template<typename T, typename Allocator = std::allocator<T>>
+using mirrored_ring_buffer = ring_buffer<T, Allocator, mirrored_capacity_policy<>>;
+
+#endif
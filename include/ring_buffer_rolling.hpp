@@ -0,0 +1,358 @@
+#ifndef DYNAMIC_RINGBUFFER_ROLLING_HPP
+#define DYNAMIC_RINGBUFFER_ROLLING_HPP
+
+#include "ring_buffer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+//===========================
+// Aggregators
+//===========================
+
+// An aggregator of a rolling_ring_buffer has three functions:
+//   void push(const T& value)  called after value has been appended to the window,
+//   void pop(const T& value)   called before value, the oldest element of the window, is removed. Must not throw,
+//   void clear()               called when the window is emptied.
+// Queries are up to the aggregator and should be constant time.
+
+/// @brief Sum of the window with Kahan-Babuska compensation, so that adding and removing elements of very different magnitude doesn't drift.
+/// @tparam T Type of the sum. For integral types the compensation is always zero.
+template<typename T>
+class rolling_sum
+{
+public:
+    /// @brief Adds value to the sum.
+    void push(const T& value) noexcept
+    {
+        add(value);
+    }
+
+    /// @brief Subtracts value from the sum.
+    void pop(const T& value) noexcept
+    {
+        add(-value);
+    }
+
+    void clear() noexcept
+    {
+        m_sum = T();
+        m_compensation = T();
+    }
+
+    /// @brief Compensated sum of the elements in the window.
+    T value() const noexcept
+    {
+        return m_sum + m_compensation;
+    }
+
+private:
+    /// @brief Neumaier's variant of Kahan summation, which also handles a term larger than the running sum.
+    void add(const T& value) noexcept
+    {
+        const T sum = m_sum + value;
+        if (magnitude(m_sum) >= magnitude(value))
+        {
+            m_compensation += (m_sum - sum) + value;
+        }
+        else
+        {
+            m_compensation += (value - sum) + m_sum;
+        }
+        m_sum = sum;
+    }
+
+    static T magnitude(const T& value) noexcept
+    {
+        return value < T() ? -value : value;
+    }
+
+    T m_sum = T();  /*!< Running sum.*/
+    T m_compensation = T();  /*!< Low order bits lost from m_sum.*/
+};
+
+/// @brief Mean and variance of the window, updated with Welford's algorithm for both added and removed elements.
+/// @tparam T Type of the elements. Integral elements are aggregated in double.
+/// @note Removing an element many orders of magnitude larger than the rest of the window loses the precision of the mean, use rolling_sum for an exact mean of such data.
+template<typename T>
+class rolling_moments
+{
+public:
+    using result_type = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+    void push(const T& value) noexcept
+    {
+        const auto x = static_cast<result_type>(value);
+        ++m_count;
+        const auto delta = x - m_mean;
+        m_mean += delta / static_cast<result_type>(m_count);
+        m_squares += delta * (x - m_mean);
+    }
+
+    void pop(const T& value) noexcept
+    {
+        const auto x = static_cast<result_type>(value);
+        if (--m_count == 0)
+        {
+            clear();
+            return;
+        }
+        const auto delta = x - m_mean;
+        m_mean -= delta / static_cast<result_type>(m_count);
+        m_squares -= delta * (x - m_mean);
+    }
+
+    void clear() noexcept
+    {
+        m_count = 0;
+        m_mean = result_type();
+        m_squares = result_type();
+    }
+
+    /// @brief Mean of the window, 0 if the window is empty.
+    result_type mean() const noexcept
+    {
+        return m_mean;
+    }
+
+    /// @brief Population variance of the window, 0 if the window is empty.
+    result_type variance() const noexcept
+    {
+        return m_count ? clamp(m_squares) / static_cast<result_type>(m_count) : result_type();
+    }
+
+    /// @brief Sample variance of the window, 0 if the window has less than two elements.
+    result_type sample_variance() const noexcept
+    {
+        return m_count > 1 ? clamp(m_squares) / static_cast<result_type>(m_count - 1) : result_type();
+    }
+
+private:
+    /// @brief Rounding can leave the sum of squares slightly negative once elements are removed.
+    static result_type clamp(result_type squares) noexcept
+    {
+        return squares < result_type() ? result_type() : squares;
+    }
+
+    size_t m_count = 0;  /*!< Amount of elements in the window.*/
+    result_type m_mean = result_type();  /*!< Running mean.*/
+    result_type m_squares = result_type();  /*!< Sum of squared differences from the mean.*/
+};
+
+/// @brief Extreme of the window by Compare, kept in a monotonic queue of the elements that can still become the extreme.
+/// @tparam T Type of the elements.
+/// @tparam Compare Ordering, std::less<T> keeps the minimum and std::greater<T> the maximum.
+/// @note push and pop are amortized constant time. The queue holds at most as many elements as the window.
+template<typename T, typename Compare>
+class rolling_extreme
+{
+public:
+    /// @brief Drops the queued elements that value beats, they are older and can't become the extreme anymore.
+    /// @throw Can throw std::bad_alloc or something from T's copy constructor.
+    void push(const T& value)
+    {
+        while (!m_candidates.empty() && m_compare(value, m_candidates.back()))
+        {
+            m_candidates.pop_back();
+        }
+        m_candidates.push_back(value);
+    }
+
+    /// @brief Removes value from the queue if it is the current extreme. Equal elements are all queued, so the oldest one is removed first.
+    void pop(const T& value) noexcept
+    {
+        if (!m_compare(m_candidates.front(), value) && !m_compare(value, m_candidates.front()))
+        {
+            m_candidates.pop_front();
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_candidates.clear();
+    }
+
+    /// @brief The extreme of the window.
+    /// @pre The window must not be empty, otherwise behaviour is undefined.
+    const T& value() const noexcept
+    {
+        return m_candidates.front();
+    }
+
+private:
+    ring_buffer<T> m_candidates;  /*!< Elements in arrival order, each beating all elements after it.*/
+    Compare m_compare;
+};
+
+/// @brief Minimum of the window.
+template<typename T>
+using rolling_min = rolling_extreme<T, std::less<T>>;
+
+/// @brief Maximum of the window.
+template<typename T>
+using rolling_max = rolling_extreme<T, std::greater<T>>;
+
+//===========================
+// Rolling buffer
+//===========================
+
+/// @brief FIFO window over a ring_buffer that keeps aggregates of its elements up to date on every append and removal, so that queries are constant time.
+/// @tparam T Type of the elements.
+/// @tparam Aggregators Aggregator types, for example rolling_sum<T>, rolling_moments<T>, rolling_min<T> and rolling_max<T>.
+/// @note The elements are read-only, modifying them would leave the aggregates out of date. With a window size, emplace_back() on a full window removes
+/// the oldest element first, like overwrite_capacity_policy, and the aggregators see it leave.
+template<typename T, typename... Aggregators>
+class rolling_ring_buffer
+{
+public:
+
+    using buffer_type = ring_buffer<T>;
+    using size_type = typename buffer_type::size_type;
+    using value_type = T;
+    using const_reference = const T&;
+    using const_iterator = typename buffer_type::const_iterator;
+    using iterator = const_iterator;
+    using const_span = typename buffer_type::const_span;
+
+    /// @brief Constructs an empty window.
+    /// @param window Maximum amount of elements, 0 for an unbounded window. A bounded window allocates its memory up front.
+    /// @throw Can throw std::bad_alloc. Aggregators are default constructed.
+    explicit rolling_ring_buffer(size_type window = 0) : m_window(window)
+    {
+        if (window)
+        {
+            m_buffer.reserve(window + allocBuffer);
+        }
+    }
+
+    /// @brief Constructs an element to the back of the window and adds it to the aggregates. Removes the oldest element first if the window is full.
+    /// @param args Arguments to construct value_type from.
+    /// @throw Can throw std::bad_alloc, or something from value_type's constructor or an aggregator.
+    /// @exception If value_type's constructor throws, the window is unchanged apart from the removed oldest element. If an aggregator throws, the new element is removed
+    /// and the aggregates are rebuilt from the remaining elements.
+    /// @details Amortized constant complexity, plus the complexity of the aggregators.
+    template<typename... Args>
+    void emplace_back(Args&&... args)
+    {
+        if (m_window && m_buffer.size() == m_window)
+        {
+            pop_front();
+        }
+        m_buffer.emplace_back(std::forward<Args>(args)...);
+        try
+        {
+            forEach([this](auto& aggregator) { aggregator.push(m_buffer.back()); });
+        }
+        catch (...)
+        {
+            m_buffer.pop_back();
+            rebuild();
+            throw;
+        }
+    }
+
+    /// @brief Copies val to the back of the window. See emplace_back().
+    void push_back(const value_type& val)
+    {
+        emplace_back(val);
+    }
+
+    /// @brief Moves val to the back of the window. See emplace_back().
+    void push_back(value_type&& val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    /// @brief Removes the oldest element and takes it out of the aggregates.
+    /// @pre The window must not be empty, otherwise behaviour is undefined.
+    /// @details Constant complexity, plus the complexity of the aggregators.
+    void pop_front() noexcept
+    {
+        forEach([this](auto& aggregator) { aggregator.pop(m_buffer.front()); });
+        m_buffer.pop_front();
+    }
+
+    /// @brief Removes the count oldest elements.
+    /// @pre count <= size(), otherwise behaviour is undefined.
+    /// @details Linear complexity in relation to count. The elements are destroyed and the tail index is moved once.
+    void pop_front_n(size_type count) noexcept
+    {
+        for (size_type i = 0; i < count; i++)
+        {
+            const auto& value = m_buffer[i];
+            forEach([&value](auto& aggregator) { aggregator.pop(value); });
+        }
+        m_buffer.pop_front_n(count);
+    }
+
+    /// @brief Removes all elements and clears the aggregates.
+    void clear() noexcept
+    {
+        m_buffer.clear();
+        forEach([](auto& aggregator) { aggregator.clear(); });
+    }
+
+    /// @brief The aggregator of type Aggregator.
+    template<typename Aggregator>
+    const Aggregator& aggregate() const noexcept
+    {
+        return std::get<Aggregator>(m_aggregators);
+    }
+
+    /// @brief The Index:th aggregator.
+    template<size_t Index>
+    const std::tuple_element_t<Index, std::tuple<Aggregators...>>& aggregate() const noexcept
+    {
+        return std::get<Index>(m_aggregators);
+    }
+
+    /// @brief Maximum amount of elements, 0 if the window is unbounded.
+    size_type window() const noexcept { return m_window; }
+
+    size_type size() const noexcept { return m_buffer.size(); }
+    bool empty() const noexcept { return m_buffer.empty(); }
+    const_reference front() const noexcept { return m_buffer.front(); }
+    const_reference back() const noexcept { return m_buffer.back(); }
+    const_reference operator[](size_type index) const noexcept { return m_buffer[index]; }
+    const_iterator begin() const noexcept { return m_buffer.begin(); }
+    const_iterator end() const noexcept { return m_buffer.end(); }
+    const_span array_one() const noexcept { return m_buffer.array_one(); }
+    const_span array_two() const noexcept { return m_buffer.array_two(); }
+
+    /// @brief The underlying buffer, read-only.
+    const buffer_type& buffer() const noexcept { return m_buffer; }
+
+private:
+    /// @brief Calls f on every aggregator in order.
+    template<typename Function>
+    void forEach(Function&& f)
+    {
+        forEach(f, std::index_sequence_for<Aggregators...>());
+    }
+
+    template<typename Function, size_t... Indices>
+    void forEach(Function& f, std::index_sequence<Indices...>)
+    {
+        using expand = int[];
+        (void)expand{ 0, (f(std::get<Indices>(m_aggregators)), 0)... };
+    }
+
+    /// @brief Recomputes the aggregates from the elements in the window.
+    void rebuild()
+    {
+        forEach([](auto& aggregator) { aggregator.clear(); });
+        for (const auto& value : m_buffer)
+        {
+            forEach([&value](auto& aggregator) { aggregator.push(value); });
+        }
+    }
+
+    buffer_type m_buffer;  /*!< Elements of the window, oldest first.*/
+    std::tuple<Aggregators...> m_aggregators;
+    size_type m_window;  /*!< Maximum amount of elements, 0 if unbounded.*/
+};
+
+#endif
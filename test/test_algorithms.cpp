@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_algorithms.hpp"
+#include "ring_buffer_mirrored.hpp"
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+//
+/// @brief Tests for the segment-wise reductions and transforms.
+//================ALGORITHMS=================//
+
+
+namespace
+{
+    // Buffer of count elements from value(0) to value(count - 1) that wraps around its physical end.
+    template<typename Buffer, typename Function>
+    Buffer wrappedBuffer(size_t count, Function value)
+    {
+        Buffer buffer;
+        buffer.reserve(count + 2);
+        const auto padding = count / 3 + 2;
+        for (size_t i = 0; i < padding; i++)
+        {
+            buffer.push_back(value(0));
+        }
+        buffer.pop_front_n(padding);
+        for (size_t i = 0; i < count; i++)
+        {
+            buffer.push_back(value(i));
+        }
+        EXPECT_FALSE(buffer.array_two().empty());
+        return buffer;
+    }
+
+    const ring_buffer_parallel fourThreads{ 4, 16 };
+}
+
+TEST(RingBufferAlgorithms, Reduce)
+{
+    const auto ints = wrappedBuffer<ring_buffer<int>>(1001, [](size_t i) { return static_cast<int>(i); });
+    ASSERT_EQ(reduce(ints, 0), 1000 * 1001 / 2);
+    ASSERT_EQ(reduce(ints, 10LL), 10 + 1000 * 1001 / 2);
+    ASSERT_EQ(reduce(fourThreads, ints, 0), 1000 * 1001 / 2);
+
+    // Small elements are summed in the type of init.
+    const auto bytes = wrappedBuffer<ring_buffer<unsigned char>>(1000, [](size_t) { return static_cast<unsigned char>(200); });
+    ASSERT_EQ(reduce(bytes, 0u), 200000u);
+
+    const auto floats = wrappedBuffer<ring_buffer<float>>(999, [](size_t i) { return 0.5f * static_cast<float>(i); });
+    const std::vector<float> values(floats.begin(), floats.end());
+    const auto expected = std::accumulate(values.begin(), values.end(), 0.0);
+    ASSERT_NEAR(reduce(floats, 0.0f), expected, 1e-3 * expected);
+    ASSERT_NEAR(reduce(fourThreads, floats, 0.0), expected, 1e-9 * expected);
+
+    const auto strings = wrappedBuffer<ring_buffer<std::string>>(10, [](size_t i) { return std::to_string(i); });
+    ASSERT_EQ(reduce(strings, std::string()), "0123456789");
+    ASSERT_EQ(reduce(strings, std::string(">"), [](std::string sum, const std::string& value) { return sum + value + ","; }), ">0,1,2,3,4,5,6,7,8,9,");
+
+    ASSERT_EQ(reduce(ring_buffer<double>(), 1.5), 1.5);
+    ASSERT_EQ(reduce(fourThreads, ring_buffer<double>(), 1.5), 1.5);
+}
+
+TEST(RingBufferAlgorithms, MinMax)
+{
+    auto values = wrappedBuffer<ring_buffer<double>>(1000, [](size_t i) { return std::sin(static_cast<double>(i)); });
+    values[3] = -7.0;
+    values[values.array_one().size() + 5] = 9.0;
+    ASSERT_EQ(min_max(values), std::make_pair(-7.0, 9.0));
+    ASSERT_EQ(min_max(fourThreads, values), std::make_pair(-7.0, 9.0));
+
+    const ring_buffer<int> single{ 42 };
+    ASSERT_EQ(min_max(single), std::make_pair(42, 42));
+    ASSERT_EQ(min_max(fourThreads, single), std::make_pair(42, 42));
+
+    const auto strings = wrappedBuffer<ring_buffer<std::string>>(20, [](size_t i) { return std::string(1, static_cast<char>('a' + (i * 7) % 20)); });
+    ASSERT_EQ(min_max(strings), std::make_pair(std::string("a"), std::string("t")));
+}
+
+TEST(RingBufferAlgorithms, TransformInplace)
+{
+    auto values = wrappedBuffer<ring_buffer<float>>(500, [](size_t i) { return static_cast<float>(i); });
+    transform_inplace(values, [](float value) { return value * 2.0f + 1.0f; });
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], static_cast<float>(2 * i + 1));
+    }
+
+    transform_inplace(fourThreads, values, [](float value) { return value - 1.0f; });
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], static_cast<float>(2 * i));
+    }
+
+    auto strings = wrappedBuffer<ring_buffer<std::string>>(5, [](size_t i) { return std::to_string(i); });
+    transform_inplace(strings, [](const std::string& value) { return value + value; });
+    ASSERT_EQ(strings.back(), "44");
+
+    ASSERT_THROW(transform_inplace(fourThreads, values, [](float value) -> float {
+        if (value > 900.0f)
+        {
+            throw std::runtime_error("out of range");
+        }
+        return value;
+    }), std::runtime_error);
+}
+
+TEST(RingBufferAlgorithms, Dot)
+{
+    // The buffers wrap at different points, so the products are summed over three chunks.
+    const auto lhs = wrappedBuffer<ring_buffer<int>>(300, [](size_t i) { return static_cast<int>(i % 10); });
+    ring_buffer<int> rhs;
+    for (int i = 0; i < 300; i++)
+    {
+        rhs.push_back(i % 3);
+    }
+    long long expected = 0;
+    for (size_t i = 0; i < lhs.size(); i++)
+    {
+        expected += lhs[i] * rhs[i];
+    }
+    ASSERT_EQ(dot(lhs, rhs, 0LL), expected);
+    ASSERT_EQ(dot(fourThreads, lhs, rhs, 0LL), expected);
+
+    // Only the first min(lhs.size(), rhs.size()) elements take part.
+    rhs.pop_back();
+    ASSERT_EQ(dot(lhs, rhs, 0LL), expected - lhs[299] * (299 % 3));
+
+    // Buffers of different types can be combined.
+    mirrored_ring_buffer<double> mirrored;
+    for (int i = 0; i < 100; i++)
+    {
+        mirrored.push_back(0.25 * i);
+    }
+    const auto doubles = wrappedBuffer<ring_buffer<double>>(100, [](size_t) { return 4.0; });
+    ASSERT_DOUBLE_EQ(dot(mirrored, doubles, 0.0), 99.0 * 100.0 / 2.0);
+}
+
+TEST(RingBufferAlgorithms, ParallelForEach)
+{
+    auto values = wrappedBuffer<ring_buffer<int>>(10000, [](size_t i) { return static_cast<int>(i); });
+    const ring_buffer_parallel policy{ 8, 100 };
+
+    // Each element is visited exactly once.
+    std::atomic<long long> sum{ 0 };
+    {
+        ring_buffer_thread_executor executor;
+        parallel_for_each(policy, values, [&sum](int& value) { sum += value; value = -value; }, executor);
+    }
+    ASSERT_EQ(sum.load(), 9999LL * 10000 / 2);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], -static_cast<int>(i));
+    }
+
+    // An executor that never runs its tasks leaves the work to the calling thread, ones that run late find nothing left.
+    std::vector<std::function<void()>> deferred;
+    parallel_for_each(policy, values, [](int& value) { value = -value; }, [&deferred](std::function<void()> task) { deferred.push_back(std::move(task)); });
+    for (auto& task : deferred)
+    {
+        task();
+    }
+    ASSERT_EQ(deferred.size(), 7);
+    ASSERT_EQ(values.back(), 9999);
+
+    // Tasks run inline by the executor, and a default policy that falls back to the calling thread.
+    parallel_for_each(policy, values, [](int& value) { ++value; }, [](std::function<void()> task) { task(); });
+    parallel_for_each(values, [](int& value) { --value; }, [](std::function<void()>) { FAIL(); });
+    ASSERT_EQ(values.front(), 0);
+    parallel_for_each(policy, values, [](int& value) { value *= 2; });
+    ASSERT_EQ(values.back(), 19998);
+
+    // The first exception reaches the caller.
+    ASSERT_THROW(parallel_for_each(policy, values, [](int& value) {
+        if (value == 5000)
+        {
+            throw std::runtime_error("bad value");
+        }
+    }), std::runtime_error);
+}
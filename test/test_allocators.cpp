@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_allocators.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+//
+/// @brief Tests for the allocators shipped with the ring buffer.
+//================HUGE PAGES=================//
+#if defined(RING_BUFFER_HAS_MMAP)
+
+
+TEST(HugePageAllocator, AllocatesAlignedPages)
+{
+    huge_page_allocator<int> alloc;
+    auto ptr = alloc.allocate(10);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % huge_page_size, 0u);
+
+    // The whole page is usable.
+    ptr[0] = 1;
+    ptr[huge_page_size / sizeof(int) - 1] = 2;
+    alloc.deallocate(ptr, 10);
+
+    huge_page_allocator<int, 4096> small;
+    auto smallPtr = small.allocate(2000);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(smallPtr) % 4096, 0u);
+    small.deallocate(smallPtr, 2000);
+}
+
+TEST(HugePageAllocator, NumaNodeAndEquality)
+{
+    huge_page_allocator<int> any;
+    huge_page_allocator<int> node0(0);
+    huge_page_allocator<std::string> rebound(node0);
+
+    ASSERT_EQ(any.numa_node(), huge_page_allocator<int>::any_node);
+    ASSERT_EQ(rebound.numa_node(), 0);
+    ASSERT_TRUE(node0 == rebound);
+    ASSERT_TRUE(any != node0);
+
+    // Binding is best effort, the memory is usable on systems without NUMA.
+    auto ptr = node0.allocate(1000);
+    ptr[999] = 5;
+    ASSERT_EQ(ptr[999], 5);
+    node0.deallocate(ptr, 1000);
+}
+
+TEST(HugePageAllocator, PageCapacityPolicy)
+{
+    using policy = page_capacity_policy<sizeof(int), 4096>;
+    static_assert(policy::fit(1) == 1024, "a single page");
+    static_assert(policy::fit(1024) == 1024, "exactly one page");
+    static_assert(policy::fit(1025) == 2048, "rounds up to whole pages");
+    static_assert(page_capacity_policy<24, 4096>::fit(1) == 170, "elements that don't divide the page");
+    static_assert(page_capacity_policy<4096 * 3, 4096>::fit(2) == 2, "elements larger than a page");
+
+    huge_page_ring_buffer<int> buffer;
+    ASSERT_EQ(buffer.capacity(), huge_page_size / sizeof(int));
+    for (int i = 0; i < 600000; i++)
+    {
+        buffer.push_back(i);
+    }
+    ASSERT_EQ(buffer.capacity() % (huge_page_size / sizeof(int)), 0u);
+    ASSERT_EQ(buffer.front(), 0);
+    ASSERT_EQ(buffer.back(), 599999);
+}
+
+TEST(HugePageAllocator, PropagatesWithBuffer)
+{
+    using allocator_type = huge_page_allocator<std::string, 4096>;
+    using buffer_type = ring_buffer<std::string, allocator_type, page_capacity_policy<sizeof(std::string), 4096>>;
+    buffer_type first(allocator_type(0));
+    buffer_type second;
+    first.push_back("first");
+    second.push_back("second");
+
+    swap(first, second);
+    ASSERT_EQ(first.get_allocator().numa_node(), allocator_type::any_node);
+    ASSERT_EQ(second.get_allocator().numa_node(), 0);
+    ASSERT_EQ(second.front(), "first");
+
+    first = second;
+    ASSERT_EQ(first.get_allocator().numa_node(), 0);
+    ASSERT_EQ(first.front(), "first");
+
+    buffer_type third;
+    third = std::move(second);
+    ASSERT_EQ(third.get_allocator().numa_node(), 0);
+    ASSERT_EQ(third.front(), "first");
+}
+#endif
+
+
+//================ARENA=================//
+
+
+TEST(RingBufferArena, RecyclesBySizeClass)
+{
+    ring_buffer_arena arena(4096);
+
+    auto first = arena.allocate(100);
+    auto second = arena.allocate(100);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(first) % alignof(std::max_align_t), 0u);
+    ASSERT_EQ(arena.upstream_allocations(), 1);
+
+    // 100 and 128 bytes are in the same class, 129 is not.
+    arena.deallocate(first, 100);
+    ASSERT_EQ(arena.allocate(128), first);
+    ASSERT_EQ(arena.recycled(), 1);
+    ASSERT_NE(arena.allocate(129), first);
+
+    // Blocks larger than a chunk get a chunk of their own and are recycled as well.
+    auto large = arena.allocate(10000);
+    ASSERT_EQ(arena.upstream_allocations(), 2);
+    arena.deallocate(large, 10000);
+    ASSERT_EQ(arena.allocate(9000), large);
+
+    // Over-aligned blocks are aligned but not recycled.
+    auto aligned = arena.allocate(64, 256);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 256, 0u);
+    arena.deallocate(aligned, 64, 256);
+    ASSERT_NE(arena.allocate(64), aligned);
+
+    arena.reset();
+    auto afterReset = arena.allocate(100);
+    ASSERT_NE(afterReset, nullptr);
+    arena.deallocate(afterReset, 100);
+}
+
+TEST(RingBufferArena, ShortLivedBuffers)
+{
+    ring_buffer_arena arena;
+    arena_allocator<std::string> alloc(arena);
+
+    for (int round = 0; round < 10; round++)
+    {
+        arena_ring_buffer<std::string> buffer(alloc);
+        for (int i = 0; i < 200; i++)
+        {
+            buffer.push_back(std::to_string(i));
+        }
+        ASSERT_EQ(buffer.back(), "199");
+    }
+    // Later buffers grow through blocks freed by the earlier ones.
+    ASSERT_EQ(arena.upstream_allocations(), 1);
+    ASSERT_GT(arena.recycled(), 0);
+}
+
+TEST(RingBufferArena, MoveBetweenArenas)
+{
+    ring_buffer_arena firstArena;
+    ring_buffer_arena secondArena;
+    arena_allocator<std::string> first(firstArena);
+    arena_allocator<std::string> second(secondArena);
+
+    arena_ring_buffer<std::string> source(first);
+    source.reserve(8);
+    for (int i = 0; i < 12; i++)
+    {
+        source.push_back(std::string(30, static_cast<char>('a' + i)));
+        if (source.size() > 5)
+        {
+            source.pop_front();
+        }
+    }
+    const std::vector<std::string> expected(source.begin(), source.end());
+
+    // Equal allocators take the memory over.
+    const auto data = &source.front();
+    arena_ring_buffer<std::string> sameArena(std::move(source), first);
+    ASSERT_EQ(&sameArena.front(), data);
+    ASSERT_TRUE(source.empty());
+
+    // Different allocators relocate once.
+    arena_ring_buffer<std::string> otherArena(std::move(sameArena), second);
+    ASSERT_TRUE(sameArena.empty());
+    ASSERT_TRUE(otherArena.get_allocator() == second);
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), otherArena.begin()));
+
+    // Move assignment keeps the allocator of the target.
+    arena_ring_buffer<std::string> target(first);
+    target.push_back("old");
+    target = std::move(otherArena);
+    ASSERT_TRUE(target.get_allocator() == first);
+    ASSERT_TRUE(otherArena.empty());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), target.begin()));
+    ASSERT_EQ(target.size(), expected.size());
+
+    target.push_back("new");
+    otherArena.push_back("reused");
+    ASSERT_EQ(target.back(), "new");
+    ASSERT_EQ(otherArena.front(), "reused");
+}
+
+TEST(RingBufferArena, MoveAssignTrivial)
+{
+    ring_buffer_arena firstArena;
+    ring_buffer_arena secondArena;
+    arena_ring_buffer<int> source{ arena_allocator<int>(firstArena) };
+    arena_ring_buffer<int> target{ arena_allocator<int>(secondArena) };
+    for (int i = 0; i < 100; i++)
+    {
+        source.push_back(i);
+    }
+    source.pop_front_n(50);
+    target = std::move(source);
+    ASSERT_EQ(target.size(), 50);
+    ASSERT_EQ(target.front(), 50);
+    ASSERT_EQ(target.back(), 99);
+    ASSERT_TRUE(source.empty());
+    static_assert(!std::is_nothrow_move_assignable<arena_ring_buffer<int>>::value, "unequal arenas can allocate");
+    static_assert(std::is_nothrow_move_assignable<ring_buffer<int>>::value, "std::allocator never allocates on move");
+}
+
+#if defined(RING_BUFFER_HAS_PMR)
+
+TEST(RingBufferArena, PolymorphicAllocator)
+{
+    ring_buffer_arena_resource resource;
+    {
+        pmr_ring_buffer<std::pmr::string> buffer{ std::pmr::polymorphic_allocator<std::pmr::string>(&resource) };
+        for (int i = 0; i < 100; i++)
+        {
+            buffer.emplace_back(40, 'x');
+        }
+        // Elements get the buffer's resource through uses-allocator construction.
+        ASSERT_EQ(buffer.back().get_allocator().resource(), &resource);
+
+        pmr_ring_buffer<std::pmr::string> other{ std::pmr::polymorphic_allocator<std::pmr::string>(std::pmr::new_delete_resource()) };
+        other = std::move(buffer);
+        ASSERT_EQ(other.size(), 100);
+        ASSERT_EQ(other.get_allocator().resource(), std::pmr::new_delete_resource());
+    }
+    ASSERT_GT(resource.arena().upstream_allocations(), 0);
+    resource.reset();
+}
+
+#endif
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_channel.hpp"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//
+/// @brief Tests for the coroutine channel.
+//================CHANNEL=================//
+
+
+namespace
+{
+    // Fire and forget coroutine that starts eagerly.
+    struct task
+    {
+        struct promise_type
+        {
+            task get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    task consumeAll(ring_channel<std::string>& channel, std::vector<std::string>& values, bool& done)
+    {
+        while (auto value = co_await channel.pop())
+        {
+            values.push_back(std::move(*value));
+        }
+        done = true;
+    }
+
+    task produce(ring_channel<int>& channel, int first, int count, int& accepted)
+    {
+        for (int i = first; i < first + count; i++)
+        {
+            if (!co_await channel.push(i))
+            {
+                co_return;
+            }
+            ++accepted;
+        }
+    }
+
+    task consumeBatches(ring_channel<int>& channel, std::vector<int>& values, std::vector<size_t>& batches)
+    {
+        while (const auto count = co_await channel.pop_batch(std::back_inserter(values), 3))
+        {
+            batches.push_back(count);
+        }
+    }
+
+    task sum(ring_channel<int>& channel, long long& total, std::atomic<bool>& done)
+    {
+        int values[16];
+        while (const auto count = co_await channel.pop_batch(values, 16))
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                total += values[i];
+            }
+        }
+        done = true;
+    }
+
+    task produceThenClose(ring_channel<int>& channel, int first, int count, std::atomic<int>& running)
+    {
+        for (int i = first; i < first + count; i++)
+        {
+            co_await channel.push(i);
+        }
+        if (--running == 0)
+        {
+            channel.close();
+        }
+    }
+}
+
+TEST(RingChannel, ConsumerSuspends)
+{
+    ring_channel<std::string> channel;
+    std::vector<std::string> values;
+    bool done = false;
+    consumeAll(channel, values, done);
+    ASSERT_TRUE(values.empty());
+
+    // A push while the consumer waits hands the value over and resumes it inline.
+    ASSERT_TRUE(channel.try_push("a"));
+    ASSERT_EQ(values, std::vector<std::string>({ "a" }));
+    ASSERT_TRUE(channel.empty());
+
+    channel.close();
+    ASSERT_TRUE(done);
+    ASSERT_TRUE(channel.closed());
+    ASSERT_FALSE(channel.try_push("b"));
+    ASSERT_FALSE(channel.try_pop());
+}
+
+TEST(RingChannel, ConsumerDrainsAfterClose)
+{
+    ring_channel<std::string> channel;
+    ASSERT_TRUE(channel.try_push("a"));
+    ASSERT_TRUE(channel.try_push(std::string("b")));
+    channel.close();
+
+    std::vector<std::string> values;
+    bool done = false;
+    consumeAll(channel, values, done);
+    ASSERT_TRUE(done);
+    ASSERT_EQ(values, std::vector<std::string>({ "a", "b" }));
+}
+
+TEST(RingChannel, ProducerSuspendsWhenFull)
+{
+    ring_channel<int> channel(2);
+    ASSERT_EQ(channel.bound(), 2);
+    int accepted = 0;
+    produce(channel, 0, 6, accepted);
+    ASSERT_EQ(accepted, 2);
+    ASSERT_EQ(channel.size(), 2);
+    ASSERT_FALSE(channel.try_push(10));
+
+    // Every pop moves the value of the waiting producer into the freed slot.
+    ASSERT_EQ(channel.try_pop(), 0);
+    ASSERT_EQ(accepted, 3);
+    ASSERT_EQ(channel.size(), 2);
+    ASSERT_EQ(channel.try_pop(), 1);
+    ASSERT_EQ(channel.try_pop(), 2);
+    ASSERT_EQ(accepted, 5);
+
+    // Closing resumes the producer with false.
+    channel.close();
+    ASSERT_EQ(accepted, 5);
+    ASSERT_EQ(channel.try_pop(), 3);
+    ASSERT_EQ(channel.try_pop(), 4);
+    ASSERT_FALSE(channel.try_pop());
+}
+
+TEST(RingChannel, BatchPop)
+{
+    ring_channel<int> channel(4);
+    int accepted = 0;
+    produce(channel, 0, 7, accepted);
+    ASSERT_EQ(accepted, 4);
+
+    // The first batch frees three slots for the producer, which refills them before the second batch.
+    std::vector<int> values;
+    std::vector<size_t> batches;
+    consumeBatches(channel, values, batches);
+    ASSERT_EQ(accepted, 7);
+    ASSERT_EQ(batches, std::vector<size_t>({ 3, 3, 1 }));
+    ASSERT_EQ(values, std::vector<int>({ 0, 1, 2, 3, 4, 5, 6 }));
+
+    // A value handed to the waiting batch is written first.
+    ASSERT_TRUE(channel.try_push(7));
+    ASSERT_EQ(batches.back(), 1);
+    ASSERT_EQ(values.back(), 7);
+    channel.close();
+    ASSERT_EQ(batches.size(), 4);
+}
+
+TEST(RingChannel, ResumeFunction)
+{
+    std::vector<std::coroutine_handle<>> ready;
+    ring_channel<std::string> channel(0, [&ready](std::coroutine_handle<> handle) { ready.push_back(handle); });
+    std::vector<std::string> values;
+    bool done = false;
+    consumeAll(channel, values, done);
+
+    // The consumer isn't resumed by the producer but by the loop below.
+    ASSERT_TRUE(channel.try_push("a"));
+    ASSERT_TRUE(values.empty());
+    ASSERT_EQ(ready.size(), 1);
+    ready.back().resume();
+    ASSERT_EQ(values, std::vector<std::string>({ "a" }));
+
+    channel.close();
+    ASSERT_EQ(ready.size(), 2);
+    ready.back().resume();
+    ASSERT_TRUE(done);
+}
+
+TEST(RingChannel, Threads)
+{
+    constexpr int producers = 4;
+    constexpr int count = 20000;
+    ring_channel<int> channel(64);
+    long long total = 0;
+    std::atomic<bool> done{ false };
+    std::atomic<int> running{ producers };
+    sum(channel, total, done);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++)
+    {
+        threads.emplace_back([&channel, &running, i] { produceThenClose(channel, i * count, count, running); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Every coroutine runs to completion on the threads that woke it.
+    ASSERT_TRUE(done);
+    const long long values = static_cast<long long>(producers) * count;
+    ASSERT_EQ(total, values * (values - 1) / 2);
+}
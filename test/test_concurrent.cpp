@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "ring_buffer.hpp"
+#include <thread>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+
+//
+/// @brief Tests for the concurrent ring buffer variants.
+//================SPSC=================//
+
+
+TEST(SpscRingBuffer, PushPopSingleThread)
+{
+    spsc_ring_buffer<std::string> buffer(3);
+
+    ASSERT_EQ(buffer.capacity(), 3);
+    ASSERT_TRUE(buffer.empty());
+
+    ASSERT_TRUE(buffer.try_push("one"));
+    ASSERT_TRUE(buffer.try_push(std::string("two")));
+    ASSERT_TRUE(buffer.try_emplace(5, 'x'));
+    ASSERT_FALSE(buffer.try_push("four"));
+    ASSERT_EQ(buffer.size(), 3);
+
+    std::string value;
+    ASSERT_TRUE(buffer.try_pop(value));
+    ASSERT_EQ(value, "one");
+    ASSERT_TRUE(buffer.try_push("four"));
+
+    ASSERT_TRUE(buffer.try_pop(value));
+    ASSERT_EQ(value, "two");
+    ASSERT_TRUE(buffer.try_pop(value));
+    ASSERT_EQ(value, "xxxxx");
+    ASSERT_TRUE(buffer.try_pop(value));
+    ASSERT_EQ(value, "four");
+    ASSERT_FALSE(buffer.try_pop(value));
+    ASSERT_TRUE(buffer.empty());
+
+    // Leave elements for the destructor.
+    ASSERT_TRUE(buffer.try_push("five"));
+    ASSERT_TRUE(buffer.try_push("six"));
+}
+
+TEST(SpscRingBuffer, BulkWrapAround)
+{
+    spsc_ring_buffer<int> buffer(5);
+    int input[] = {1, 2, 3, 4, 5, 6, 7};
+    int output[7] = {};
+
+    ASSERT_EQ(buffer.push_n(input, 3), 3);
+    ASSERT_EQ(buffer.pop_n(output, 2), 2);
+    ASSERT_EQ(output[0], 1);
+    ASSERT_EQ(output[1], 2);
+
+    // Only four free slots remain, write wraps around the end of the storage.
+    ASSERT_EQ(buffer.push_n(input + 3, 4), 4);
+    ASSERT_EQ(buffer.push_n(input, 1), 0);
+    ASSERT_EQ(buffer.size(), 5);
+
+    auto arrays = buffer.read_arrays();
+    ASSERT_EQ(arrays.first.size() + arrays.second.size(), 5);
+    ASSERT_EQ(arrays.first[0], 3);
+
+    ASSERT_EQ(buffer.pop_n(output, 7), 5);
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_EQ(output[i], i + 3);
+    }
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingBuffer, WriteCommit)
+{
+    spsc_ring_buffer<int> buffer(4);
+
+    auto free = buffer.write_arrays();
+    ASSERT_EQ(free.first.size() + free.second.size(), 4);
+    free.first[0] = 10;
+    free.first[1] = 20;
+    buffer.commit_write(2);
+
+    auto used = buffer.read_arrays();
+    ASSERT_EQ(used.first.size(), 2);
+    ASSERT_EQ(used.first[0], 10);
+    ASSERT_EQ(used.first[1], 20);
+    buffer.commit_read(1);
+
+    int value = 0;
+    ASSERT_TRUE(buffer.try_pop(value));
+    ASSERT_EQ(value, 20);
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(SpscRingBuffer, ProducerConsumer)
+{
+    constexpr int count = 100000;
+    spsc_ring_buffer<int> buffer(64);
+
+    std::thread producer([&buffer]()
+    {
+        int chunk[7];
+        int next = 0;
+        while (next < count)
+        {
+            // Alternate between single and bulk pushes.
+            if (next % 2)
+            {
+                if (buffer.try_push(next))
+                {
+                    ++next;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            else
+            {
+                int n = std::min(7, count - next);
+                for (int i = 0; i < n; ++i)
+                {
+                    chunk[i] = next + i;
+                }
+                auto pushed = static_cast<int>(buffer.push_n(chunk, n));
+                if (!pushed)
+                {
+                    std::this_thread::yield();
+                }
+                next += pushed;
+            }
+        }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    int out[5];
+    while (expected < count)
+    {
+        int value;
+        if (buffer.try_pop(value))
+        {
+            ordered &= value == expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+        auto popped = buffer.pop_n(out, 5);
+        for (size_t i = 0; i < popped; ++i)
+        {
+            ordered &= out[i] == expected++;
+        }
+    }
+
+    producer.join();
+    ASSERT_TRUE(ordered);
+    ASSERT_TRUE(buffer.empty());
+}
+
+
+//================MPMC=================//
+
+
+TEST(MpmcRingBuffer, PushPopSingleThread)
+{
+    mpmc_ring_buffer<std::string> buffer(3);
+
+    // Capacity is rounded up to a power of two.
+    ASSERT_EQ(buffer.capacity(), 4);
+    ASSERT_TRUE(buffer.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(buffer.try_push(std::to_string(i)));
+    }
+    ASSERT_FALSE(buffer.try_emplace("full"));
+    ASSERT_FALSE(buffer.try_push_for(std::string("full"), std::chrono::milliseconds(1)));
+    ASSERT_EQ(buffer.size(), 4);
+
+    std::string value;
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(buffer.try_pop(value));
+        ASSERT_EQ(value, std::to_string(i));
+    }
+    ASSERT_FALSE(buffer.try_pop(value));
+    ASSERT_FALSE(buffer.try_pop_for(value, std::chrono::milliseconds(1)));
+    ASSERT_TRUE(buffer.empty());
+
+    // Leave elements for the destructor after wrapping around.
+    buffer.push("wrapped");
+    ASSERT_TRUE(buffer.try_push_for(std::string("timed"), std::chrono::milliseconds(1)));
+    buffer.pop(value);
+    ASSERT_EQ(value, "wrapped");
+    ASSERT_EQ(buffer.size(), 1);
+}
+
+namespace
+{
+    // Element whose move constructor may throw, so emplacing it goes through a temporary.
+    struct ThrowingMove
+    {
+        explicit ThrowingMove(std::string v) : s(std::move(v)) {}
+        ThrowingMove(ThrowingMove&& other) noexcept(false) : s(std::move(other.s)) {}
+        ThrowingMove& operator=(ThrowingMove&& other) noexcept { s = std::move(other.s); return *this; }
+        std::string s;
+    };
+}
+
+TEST(MpmcRingBuffer, FullKeepsThrowingMoveValue)
+{
+    mpmc_ring_buffer<ThrowingMove> buffer(2);
+    ASSERT_TRUE(buffer.try_push(ThrowingMove("a")));
+    ASSERT_TRUE(buffer.try_push(ThrowingMove("b")));
+
+    // Failed pushes to the full buffer leave the value to the caller.
+    ThrowingMove value("kept");
+    ASSERT_FALSE(buffer.try_push(std::move(value)));
+    ASSERT_EQ(value.s, "kept");
+    ASSERT_FALSE(buffer.try_push_for(std::move(value), std::chrono::milliseconds(1)));
+    ASSERT_EQ(value.s, "kept");
+
+    // A blocking push retries until a consumer makes room, without losing the value on the way.
+    std::thread consumer([&buffer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ThrowingMove popped("");
+        buffer.pop(popped);
+    });
+    buffer.push(std::move(value));
+    consumer.join();
+
+    ThrowingMove popped("");
+    ASSERT_TRUE(buffer.try_pop(popped));
+    ASSERT_EQ(popped.s, "b");
+    ASSERT_TRUE(buffer.try_pop(popped));
+    ASSERT_EQ(popped.s, "kept");
+}
+
+TEST(MpmcRingBuffer, ManyProducersManyConsumers)
+{
+    constexpr int producers = 4;
+    constexpr int consumers = 3;
+    constexpr int perProducer = 20000;
+
+    mpmc_ring_buffer<int> buffer(32);
+    std::vector<std::vector<int>> received(consumers);
+    std::atomic<int> remaining(producers * perProducer);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&buffer, p]()
+        {
+            for (int i = 0; i < perProducer; ++i)
+            {
+                buffer.push(p * perProducer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&buffer, &remaining, &received, c]()
+        {
+            int value;
+            while (remaining.load() > 0)
+            {
+                if (buffer.try_pop_for(value, std::chrono::milliseconds(1)))
+                {
+                    received[c].push_back(value);
+                    --remaining;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Every element is received exactly once, and each producer's elements arrive in order to a single consumer.
+    std::vector<int> all;
+    for (auto& values : received)
+    {
+        std::vector<int> last(producers, -1);
+        for (int value : values)
+        {
+            ASSERT_GT(value, last[value / perProducer]);
+            last[value / perProducer] = value;
+        }
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), static_cast<size_t>(producers * perProducer));
+    for (int i = 0; i < producers * perProducer; ++i)
+    {
+        ASSERT_EQ(all[i], i);
+    }
+    ASSERT_TRUE(buffer.empty());
+}
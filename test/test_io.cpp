@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_io.hpp"
+#include "ring_buffer_mirrored.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+
+//
+/// @brief Tests for reading and writing ring buffers to file descriptors.
+//================FD I/O=================//
+
+
+namespace
+{
+    struct Pipe
+    {
+        int fds[2];
+        Pipe() { EXPECT_EQ(::pipe(fds), 0); }
+        ~Pipe() { ::close(fds[0]); if (fds[1] >= 0) ::close(fds[1]); }
+        int readEnd() const { return fds[0]; }
+        int writeEnd() const { return fds[1]; }
+    };
+
+    struct Record
+    {
+        int id;
+        char payload[12];
+    };
+}
+
+TEST(RingBufferIo, WrappedRoundTrip)
+{
+    Pipe pipe;
+    ring_buffer<char> buffer;
+    buffer.reserve(16);
+    for (int i = 0; i < 10; i++)
+    {
+        buffer.push_back('x');
+    }
+    buffer.pop_front_n(10);
+
+    // Free memory wraps around the end, both segments are filled with one readv.
+    const std::string message = "hello, ring buffer";
+    ASSERT_EQ(::write(pipe.writeEnd(), message.data(), message.size()), static_cast<ssize_t>(message.size()));
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 100), 15);
+    ASSERT_EQ(buffer.size(), 15);
+    ASSERT_FALSE(buffer.array_two().empty());
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), message.begin()));
+
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 100), -1);
+    ASSERT_EQ(errno, ENOBUFS);
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 0), 0);
+
+    ASSERT_EQ(write_to(buffer, pipe.writeEnd(), 5), 5);
+    ASSERT_EQ(buffer.size(), 10);
+    ASSERT_EQ(write_to(buffer, pipe.writeEnd(), 100), 10);
+    ASSERT_TRUE(buffer.empty());
+    ASSERT_EQ(write_to(buffer, pipe.writeEnd(), 100), 0);
+
+    char received[32] = {};
+    // The three bytes that didn't fit are still in the pipe before the written ones.
+    ASSERT_EQ(::read(pipe.readEnd(), received, sizeof(received)), 18);
+    ASSERT_EQ(std::string(received, 18), message.substr(15) + message.substr(0, 15));
+}
+
+TEST(RingBufferIo, NonBlockingEmpty)
+{
+    Pipe pipe;
+    ASSERT_EQ(::fcntl(pipe.readEnd(), F_SETFL, O_NONBLOCK), 0);
+    ring_buffer<char> buffer;
+    buffer.reserve(64);
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 64), -1);
+    ASSERT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+
+
+    // The end of the stream.
+    ::close(pipe.fds[1]);
+    pipe.fds[1] = -1;
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 64), 0);
+    ASSERT_TRUE(buffer.empty());
+}
+
+TEST(RingBufferIo, PartialElements)
+{
+    Pipe pipe;
+    ring_buffer<Record> buffer;
+    buffer.reserve(8);
+
+    Record records[3] = { { 1, "one" }, { 2, "two" }, { 3, "three" } };
+    // One and a half records arrive first, the rest is completed by read_from. At most two records are read, in case the writer is faster.
+    const auto half = sizeof(Record) + sizeof(Record) / 2;
+    ASSERT_EQ(::write(pipe.writeEnd(), records, half), static_cast<ssize_t>(half));
+    std::thread writer([&]() { ::write(pipe.writeEnd(), reinterpret_cast<char*>(records) + half, sizeof(records) - half); });
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 2), static_cast<ssize_t>(2 * sizeof(Record)));
+    writer.join();
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 8), static_cast<ssize_t>(sizeof(Record)));
+    ASSERT_EQ(buffer.size(), 3);
+    ASSERT_EQ(buffer[1].id, 2);
+    ASSERT_STREQ(buffer[2].payload, "three");
+
+    ASSERT_EQ(write_to(buffer, pipe.writeEnd(), 2), static_cast<ssize_t>(2 * sizeof(Record)));
+    ASSERT_EQ(buffer.size(), 1);
+    Record received[2];
+    ASSERT_EQ(::read(pipe.readEnd(), received, sizeof(received)), static_cast<ssize_t>(sizeof(received)));
+    ASSERT_STREQ(received[1].payload, "two");
+}
+
+TEST(RingBufferIo, MirroredSingleSegment)
+{
+    Pipe pipe;
+    mirrored_ring_buffer<char> buffer;
+    const auto capacity = buffer.capacity();
+    for (size_t i = 0; i < capacity - 10; i++)
+    {
+        buffer.push_back('a');
+    }
+    buffer.pop_front_n(capacity - 20);
+
+    const std::string message(100, 'm');
+    ASSERT_EQ(::write(pipe.writeEnd(), message.data(), message.size()), 100);
+    ASSERT_EQ(read_from(buffer, pipe.readEnd(), 100), 100);
+    ASSERT_TRUE(buffer.array_two().empty());
+    ASSERT_EQ(std::string(buffer.data() + 10, 100), message);
+}
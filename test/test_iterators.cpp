@@ -335,4 +335,45 @@ TEST(Iterators, Addition)
     ASSERT_EQ(*(-1 + cend), itControl[size-1]);
 
     ASSERT_EQ(*cit, itControl[0]);
-}
\ No newline at end of file
+}
+// Tests that iterators cross the physical end of memory correctly when the buffer wraps around.
+TEST(Iterators, WrapAround)
+{
+    ring_buffer<int> wrapped{ 0, 1, 2, 3, 4, 5 };
+    wrapped.pop_front();
+    wrapped.pop_front();
+    wrapped.pop_front();
+    wrapped.push_back(6);
+    wrapped.push_back(7);
+    wrapped.push_back(8);
+    ASSERT_FALSE(wrapped.array_two().empty());
+
+    // Forward and backward steps.
+    int expected = 3;
+    for (auto it = wrapped.begin(); it != wrapped.end(); ++it)
+    {
+        ASSERT_EQ(*it, expected++);
+    }
+    for (auto it = wrapped.end(); it != wrapped.begin();)
+    {
+        --it;
+        ASSERT_EQ(*it, --expected);
+    }
+
+    // Random access jumps across the wrap point.
+    const auto size = static_cast<std::ptrdiff_t>(wrapped.size());
+    for (std::ptrdiff_t i = 0; i < size; i++)
+    {
+        ASSERT_EQ(*(wrapped.begin() + i), wrapped[i]);
+        ASSERT_EQ(*(wrapped.end() - (size - i)), wrapped[i]);
+        ASSERT_EQ(wrapped.cbegin()[i], wrapped[i]);
+        ASSERT_EQ(wrapped.begin()[i], wrapped[i]);
+    }
+    ASSERT_EQ(wrapped.end() - wrapped.begin(), size);
+
+    // Algorithms and reverse iterators.
+    std::vector<int> copy(wrapped.size());
+    std::copy(wrapped.cbegin(), wrapped.cend(), copy.begin());
+    ASSERT_TRUE(std::equal(copy.begin(), copy.end(), wrapped.begin()));
+    ASSERT_TRUE(std::equal(copy.rbegin(), copy.rend(), wrapped.rbegin()));
+}
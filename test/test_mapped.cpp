@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_mapped.hpp"
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <unistd.h>
+
+
+//
+/// @brief Tests for the memory mapped journal.
+//================MAPPED=================//
+
+
+namespace
+{
+    struct Event
+    {
+        int id;
+        double value;
+    };
+
+    // Unique journal path that is removed again at the end of the test.
+    struct TempPath
+    {
+        TempPath() : path(::testing::TempDir() + "ring_buffer_mapped_" + std::to_string(::getpid()) + "_" + ::testing::UnitTest::GetInstance()->current_test_info()->name())
+        {
+            std::remove(path.c_str());
+        }
+
+        ~TempPath() { std::remove(path.c_str()); }
+
+        std::string path;
+    };
+
+    template<typename Journal>
+    std::vector<int> ids(const Journal& journal)
+    {
+        std::vector<int> result;
+        for (const auto& event : journal.array_one())
+        {
+            result.push_back(event.id);
+        }
+        for (const auto& event : journal.array_two())
+        {
+            result.push_back(event.id);
+        }
+        return result;
+    }
+}
+
+TEST(MappedRingBuffer, Reopen)
+{
+    const TempPath file;
+    {
+        mapped_ring_buffer<Event> journal(file.path, 4);
+        ASSERT_EQ(journal.capacity(), 4);
+        ASSERT_TRUE(journal.empty());
+        for (int i = 0; i < 7; i++)
+        {
+            journal.push_back({ i, 0.5 * i });
+        }
+        journal.pop_front();
+        ASSERT_EQ(ids(journal), std::vector<int>({ 4, 5, 6 }));
+        ASSERT_FALSE(journal.array_two().empty());
+    }
+
+    // The capacity and indices come from the file, the requested capacity only applies to new files.
+    mapped_ring_buffer<Event> journal(file.path, 100);
+    ASSERT_EQ(journal.capacity(), 4);
+    ASSERT_EQ(journal.size(), 3);
+    ASSERT_EQ(journal.dropped(), 3);
+    ASSERT_EQ(ids(journal), std::vector<int>({ 4, 5, 6 }));
+    ASSERT_EQ(journal.front().value, 2.0);
+    ASSERT_EQ(journal.back().id, 6);
+    ASSERT_EQ(journal[1].id, 5);
+    ASSERT_THROW(journal.at(3), std::out_of_range);
+
+    journal.clear();
+    ASSERT_TRUE(journal.empty());
+}
+
+TEST(MappedRingBuffer, Append)
+{
+    const TempPath file;
+    mapped_ring_buffer<Event> journal(file.path, 10);
+    std::vector<Event> events(25);
+    for (int i = 0; i < 25; i++)
+    {
+        events[i] = { i, 0.0 };
+    }
+
+    journal.append(events.data(), 6);
+    journal.pop_front_n(4);
+    journal.append(events.data() + 6, 10);
+    std::vector<int> expected(10);
+    std::iota(expected.begin(), expected.end(), 6);
+    ASSERT_EQ(ids(journal), expected);
+    ASSERT_EQ(journal.dropped(), 2);
+
+    // Only the last capacity() values of a larger batch are kept.
+    journal.append(events.data(), events.size());
+    std::iota(expected.begin(), expected.end(), 15);
+    ASSERT_EQ(ids(journal), expected);
+    ASSERT_EQ(journal.dropped(), 2 + 25);
+}
+
+TEST(MappedRingBuffer, Sync)
+{
+    const TempPath file;
+    mapped_ring_buffer<Event> journal(file.path, 100, 8);
+    ASSERT_EQ(journal.sync_interval(), 8);
+    for (int i = 0; i < 10; i++)
+    {
+        journal.push_back({ i, 0.0 });
+    }
+    ASSERT_EQ(journal.unsynced(), 2);
+    journal.sync();
+    ASSERT_EQ(journal.unsynced(), 0);
+
+    // More pushes than slots since the previous sync flush the whole journal.
+    journal.set_sync_interval(0);
+    for (int i = 0; i < 250; i++)
+    {
+        journal.push_back({ i, 0.0 });
+    }
+    ASSERT_EQ(journal.unsynced(), 250);
+    journal.sync();
+    ASSERT_EQ(journal.unsynced(), 0);
+
+    auto moved = std::move(journal);
+    ASSERT_EQ(moved.back().id, 249);
+}
+
+TEST(MappedRingBuffer, InvalidFiles)
+{
+    const TempPath file;
+    ASSERT_THROW(mapped_ring_buffer<Event>(file.path, 0), std::invalid_argument);
+    ASSERT_THROW(mapped_ring_buffer<Event>(::testing::TempDir() + "missing/journal", 4), std::system_error);
+
+    {
+        mapped_ring_buffer<Event> journal(file.path, 4);
+        journal.push_back({ 1, 1.0 });
+    }
+    ASSERT_THROW(mapped_ring_buffer<int>(file.path, 4), std::runtime_error);
+
+    // A file with other contents is not taken for a journal.
+    std::FILE* other = std::fopen(file.path.c_str(), "wb");
+    const std::string text(8192, 'x');
+    std::fwrite(text.data(), 1, text.size(), other);
+    std::fclose(other);
+    ASSERT_THROW(mapped_ring_buffer<Event>(file.path, 4), std::runtime_error);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_mirrored.hpp"
+#include <deque>
+#include <numeric>
+#include <string>
+#include <unistd.h>
+
+
+//
+/// @brief Tests for the mirrored ring buffer storage.
+//================MIRRORED=================//
+
+
+TEST(MirroredRingBuffer, CapacityFillsPages)
+{
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    mirrored_ring_buffer<int> ints;
+    ASSERT_EQ(ints.capacity() * sizeof(int) % pageSize, 0u);
+
+    struct Odd { char bytes[24]; };
+    mirrored_ring_buffer<Odd> odd;
+    ASSERT_EQ(odd.capacity() * sizeof(Odd) % pageSize, 0u);
+}
+
+TEST(MirroredRingBuffer, ContiguousWhenWrapped)
+{
+    mirrored_ring_buffer<int> buffer;
+    const auto capacity = buffer.capacity();
+    for (size_t i = 0; i < capacity - 1; i++)
+    {
+        buffer.push_back(static_cast<int>(i));
+    }
+    for (size_t i = 0; i < capacity / 2; i++)
+    {
+        buffer.pop_front();
+        buffer.push_back(static_cast<int>(i + capacity - 1));
+    }
+    ASSERT_EQ(buffer.capacity(), capacity);
+
+    // All elements are in the first segment and data() does not move them.
+    ASSERT_EQ(buffer.array_one().size(), buffer.size());
+    ASSERT_TRUE(buffer.array_two().empty());
+    const int* first = &buffer.front();
+    ASSERT_EQ(buffer.data(), first);
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        ASSERT_EQ(first[i], static_cast<int>(i + capacity / 2));
+        ASSERT_EQ(&buffer[i], first + i);
+    }
+    ASSERT_TRUE(std::equal(buffer.begin(), buffer.end(), first));
+}
+
+TEST(MirroredRingBuffer, GrowthByRemap)
+{
+    // Wrap the buffer at different positions before growing, so that both sides get moved.
+    for (size_t shift : { size_t(0), size_t(100), size_t(900) })
+    {
+        mirrored_ring_buffer<int> buffer;
+        std::deque<int> control;
+        const auto capacity = buffer.capacity();
+        for (size_t i = 0; i < capacity - 1; i++)
+        {
+            buffer.push_back(static_cast<int>(i));
+            control.push_back(static_cast<int>(i));
+        }
+        for (size_t i = 0; i < shift; i++)
+        {
+            buffer.pop_front();
+            control.pop_front();
+            buffer.push_back(-static_cast<int>(i));
+            control.push_back(-static_cast<int>(i));
+        }
+
+        // The pushed value refers to an element of the buffer.
+        buffer.push_back(buffer.front());
+        control.push_back(control.front());
+        ASSERT_GT(buffer.capacity(), capacity);
+        ASSERT_EQ(buffer.reallocations(), 1);
+        ASSERT_TRUE(std::equal(control.begin(), control.end(), buffer.data()));
+
+        for (int i = 0; i < 5000; i++)
+        {
+            buffer.push_back(i);
+            control.push_back(i);
+        }
+        ASSERT_EQ(buffer.size(), control.size());
+        ASSERT_TRUE(std::equal(control.begin(), control.end(), buffer.data()));
+    }
+}
+
+TEST(MirroredRingBuffer, NonTrivialElements)
+{
+    mirrored_ring_buffer<std::string> buffer;
+    std::deque<std::string> control;
+    for (int i = 0; i < 3000; i++)
+    {
+        buffer.push_back(std::to_string(i));
+        control.push_back(std::to_string(i));
+        if (i % 3 == 0)
+        {
+            buffer.pop_front();
+            control.pop_front();
+        }
+    }
+    buffer.insert(buffer.begin() + 10, "inserted");
+    control.insert(control.begin() + 10, "inserted");
+    buffer.erase(buffer.end() - 20);
+    control.erase(control.end() - 20);
+    ASSERT_TRUE(std::equal(control.begin(), control.end(), buffer.data()));
+
+    auto copy = buffer;
+    auto moved = std::move(buffer);
+    ASSERT_TRUE(std::equal(control.begin(), control.end(), copy.begin()));
+    ASSERT_TRUE(std::equal(control.begin(), control.end(), moved.begin()));
+
+    moved.shrink_to_fit();
+    ASSERT_TRUE(std::equal(control.begin(), control.end(), moved.data()));
+    swap(moved, copy);
+    ASSERT_EQ(moved.size(), control.size());
+}
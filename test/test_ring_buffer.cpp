@@ -6,6 +6,14 @@
 #include <string>
 #include <type_traits>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <cmath>
+#include <stdexcept>
+#include <sstream>
 
 // Set true to enable tests for private functions of the buffer. Also need to remove private identifier from RingBuffer code.
 #define TEST_INTERNALS 0
@@ -95,6 +103,116 @@ public:
 private:
     size_t* data_;
 };
+// Counts copy and move constructions, used to verify that relocation does not copy.
+template<bool NothrowMove>
+class RelocationCounter {
+public:
+    static size_t copies;
+    static size_t moves;
+
+    RelocationCounter(int value = 0) : value_(value) {}
+    RelocationCounter(const RelocationCounter& other) : value_(other.value_) { ++copies; }
+    RelocationCounter(RelocationCounter&& other) noexcept(NothrowMove) : value_(other.value_) { ++moves; }
+    RelocationCounter& operator=(const RelocationCounter&) = default;
+    RelocationCounter& operator=(RelocationCounter&&) = default;
+
+    bool operator==(const RelocationCounter& other) const { return value_ == other.value_; }
+
+    static void reset() { copies = 0; moves = 0; }
+
+private:
+    int value_;
+};
+
+template<bool NothrowMove>
+size_t RelocationCounter<NothrowMove>::copies = 0;
+template<bool NothrowMove>
+size_t RelocationCounter<NothrowMove>::moves = 0;
+
+// Copy constructor throws once the countdown reaches zero, moves never throw.
+class ThrowingCopy {
+public:
+    static int countdown;
+
+    ThrowingCopy(int value = 0) : value_(value) {}
+    ThrowingCopy(const ThrowingCopy& other) : value_(other.value_)
+    {
+        if (countdown-- == 0) throw std::runtime_error("copy");
+    }
+    ThrowingCopy(ThrowingCopy&& other) noexcept : value_(other.value_) {}
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+
+    bool operator==(const ThrowingCopy& other) const { return value_ == other.value_; }
+
+private:
+    int value_;
+};
+
+int ThrowingCopy::countdown = -1;
+
+// Allocator that counts live allocations, used to verify when memory is allocated.
+template<class T>
+struct CountingAllocator {
+    using value_type = T;
+
+    static size_t allocations;
+    static size_t deallocations;
+
+    CountingAllocator() = default;
+    template<class U>
+    CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count)
+    {
+        ++allocations;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) noexcept
+    {
+        if (ptr)
+        {
+            ++deallocations;
+        }
+        std::allocator<T>().deallocate(ptr, count);
+    }
+
+    static void reset() { allocations = 0; deallocations = 0; }
+
+    bool operator==(const CountingAllocator&) const noexcept { return true; }
+    bool operator!=(const CountingAllocator&) const noexcept { return false; }
+};
+
+template<class T>
+size_t CountingAllocator<T>::allocations = 0;
+template<class T>
+size_t CountingAllocator<T>::deallocations = 0;
+
+// Allocator with its own destroy, which must be called even for trivially destructible elements.
+template<class T>
+struct DestroyCountingAllocator : std::allocator<T> {
+    using value_type = T;
+
+    template<class U>
+    struct rebind { using other = DestroyCountingAllocator<U>; };
+
+    static size_t destroys;
+
+    DestroyCountingAllocator() = default;
+    template<class U>
+    DestroyCountingAllocator(const DestroyCountingAllocator<U>&) noexcept {}
+
+    template<class U>
+    void destroy(U*) noexcept
+    {
+        ++destroys;
+    }
+};
+
+template<class T>
+size_t DestroyCountingAllocator<T>::destroys = 0;
+
 // Define some factory functions.
 
 //==========================
@@ -353,6 +471,56 @@ TYPED_TEST(RingBufferTest, equalityComparable)
     ASSERT_TRUE(randomBuffer != this->t_buffer);
 }
 
+// Tests requirement: Container expression a < b, a > b, a <= b, a >= b, also when the buffers wrap at different points.
+TYPED_TEST(RingBufferTest, lessThanComparable)
+{
+    const std::vector<TypeParam> values(this->t_buffer.begin(), this->t_buffer.end());
+    ring_buffer<TypeParam> rotated;
+    rotated.reserve(values.size() + 2);
+    rotated.push_back_n(values.begin(), values.begin() + 4);
+    rotated.pop_front_n(4);
+    rotated.push_back_n(values.begin(), values.end());
+    ASSERT_FALSE(rotated.array_two().empty());
+    ASSERT_TRUE(rotated == this->t_buffer);
+    ASSERT_FALSE(rotated < this->t_buffer);
+    ASSERT_TRUE(rotated <= this->t_buffer && rotated >= this->t_buffer);
+
+    // A prefix is less than the whole buffer.
+    rotated.pop_back();
+    ASSERT_TRUE(rotated < this->t_buffer);
+    ASSERT_TRUE(this->t_buffer > rotated);
+
+    const auto other(CreateBuffer<TypeParam>(TEST_BUFFER_SIZE));
+    const std::vector<TypeParam> otherValues(other.begin(), other.end());
+    ASSERT_EQ(other < this->t_buffer, otherValues < values);
+    ASSERT_EQ(other >= this->t_buffer, otherValues >= values);
+}
+
+// Tests that find(), count() and contains() search both segments.
+TYPED_TEST(RingBufferTest, findCountContains)
+{
+    const auto value = getValue<TypeParam>();
+    this->t_buffer.pop_front_n(3);
+    this->t_buffer.push_back(value);
+    this->t_buffer.push_back(value);
+    this->t_buffer.push_back(value);
+    ASSERT_FALSE(this->t_buffer.array_two().empty());
+
+    const std::vector<TypeParam> reference(this->t_buffer.begin(), this->t_buffer.end());
+    const auto expected = std::find(reference.begin(), reference.end(), value) - reference.begin();
+    ASSERT_EQ(this->t_buffer.find(value) - this->t_buffer.begin(), expected);
+    ASSERT_EQ(this->t_buffer.count(value), static_cast<size_t>(std::count(reference.begin(), reference.end(), value)));
+    ASSERT_TRUE(this->t_buffer.contains(value));
+
+    const auto& constBuffer = this->t_buffer;
+    ASSERT_EQ(constBuffer.find(this->t_buffer.back()) - constBuffer.begin(), expected);
+
+    this->t_buffer.clear();
+    ASSERT_EQ(this->t_buffer.find(value), this->t_buffer.end());
+    ASSERT_FALSE(this->t_buffer.contains(value));
+    ASSERT_EQ(this->t_buffer.count(value), 0);
+}
+
 // Tests requirement: SequenceContainer expression X a(n, t), X (n, t)
 TYPED_TEST(RingBufferTest, sizeValConstruction)
 {
@@ -586,7 +754,7 @@ TYPED_TEST(RingBufferTest, insertRange)
 
     for (size_t i = 0; i < amount; i++)
     {
-        ASSERT_EQ(returnIt[i], posIt[i]);
+        ASSERT_EQ(returnIt[i], this->t_buffer[pos + i]);
         ASSERT_EQ(rangeSource[i], this->t_buffer[pos + i]);
     }
 }
@@ -1044,14 +1212,387 @@ TYPED_TEST(RingBufferTest, data)
     const auto testVal = getValue<TypeParam>();
     this->t_buffer.push_front(testVal);
 
-    // Sorts the buffer and checks for state.
+    // Elements are contiguous, so data() does not relocate them.
     auto* initialAddress = &this->t_buffer[0];
     auto* dataPtr = this->t_buffer.data();
+    ASSERT_EQ(dataPtr, initialAddress);
+
+    // Wrap the elements around the end of physical memory.
+    this->t_buffer.pop_front();
+    this->t_buffer.push_back(testVal);
+    this->t_buffer.push_back(testVal);
+    this->t_buffer.push_back(testVal);
+    ASSERT_FALSE(this->t_buffer.array_two().empty());
+
+    // Sorts the buffer and checks for state.
+    initialAddress = &this->t_buffer[0];
+    dataPtr = this->t_buffer.data();
     ASSERT_NE(dataPtr, initialAddress);
     ASSERT_EQ(dataPtr, &this->t_buffer[0]);
+    ASSERT_TRUE(this->t_buffer.array_two().empty());
+}
+
+// Tests that array_one() and array_two() cover all elements in logical order, and that the free segments cover the unused memory.
+TYPED_TEST(RingBufferTest, arrays)
+{
+    auto checkSegments = [](const ring_buffer<TypeParam>& buffer)
+    {
+        auto one = buffer.array_one();
+        auto two = buffer.array_two();
+        ASSERT_EQ(one.size() + two.size(), buffer.size());
+        ASSERT_TRUE(std::equal(one.begin(), one.end(), buffer.begin()));
+        ASSERT_TRUE(std::equal(two.begin(), two.end(), buffer.begin() + one.size()));
+    };
+
+    checkSegments(this->t_buffer);
+    ASSERT_TRUE(this->t_buffer.array_two().empty());
+
+    this->t_buffer.pop_front();
+    this->t_buffer.pop_front();
+    this->t_buffer.push_back(getValue<TypeParam>());
+    this->t_buffer.push_back(getValue<TypeParam>());
+    this->t_buffer.push_back(getValue<TypeParam>());
+    checkSegments(this->t_buffer);
+    ASSERT_FALSE(this->t_buffer.array_two().empty());
+
+    auto freeSlots = this->t_buffer.free_array_one().size() + this->t_buffer.free_array_two().size();
+    ASSERT_EQ(freeSlots, this->t_buffer.capacity() - this->t_buffer.size() - 1);
+
+    ring_buffer<TypeParam> emptyBuffer;
+    ASSERT_TRUE(emptyBuffer.array_one().empty());
+    ASSERT_TRUE(emptyBuffer.array_two().empty());
+}
+
+// Tests writing directly to the free segments and taking the written slots into use with commit_back().
+TEST(NonTypedTest, commit_back)
+{
+    ring_buffer<int> testBuffer{ 1, 2, 3, 4, 5 };
+    testBuffer.reserve(8);
+    testBuffer.pop_front();
+    testBuffer.pop_front();
+    testBuffer.pop_front();
+
+    auto one = testBuffer.free_array_one();
+    auto two = testBuffer.free_array_two();
+    ASSERT_EQ(one.size() + two.size(), testBuffer.capacity() - testBuffer.size() - 1);
+
+    int value = 6;
+    for (auto& slot : one) slot = value++;
+    for (auto& slot : two) slot = value++;
+    testBuffer.commit_back(one.size() + two.size());
+
+    ASSERT_EQ(testBuffer.size(), testBuffer.capacity() - 1);
+    for (size_t i = 0; i < testBuffer.size(); i++)
+    {
+        ASSERT_EQ(testBuffer[i], static_cast<int>(i) + 4);
+    }
+}
+
+
+
+// Tests that push_back_n() appends a range in order across the wrap point.
+TYPED_TEST(RingBufferTest, push_back_n)
+{
+    auto source = CreateBuffer<TypeParam>(TEST_BUFFER_SIZE);
+    std::vector<TypeParam> reference(this->t_buffer.begin(), this->t_buffer.end());
+
+    // Free some space at the front so that appended elements wrap around.
+    this->t_buffer.pop_front();
+    this->t_buffer.pop_front();
+    reference.erase(reference.begin(), reference.begin() + 2);
+
+    this->t_buffer.push_back_n(source.begin(), source.begin() + 3);
+    reference.insert(reference.end(), source.begin(), source.begin() + 3);
+    ASSERT_EQ(this->t_buffer.size(), reference.size());
+    ASSERT_TRUE(std::equal(reference.begin(), reference.end(), this->t_buffer.begin()));
+
+    // Appending more than the free space grows the buffer once.
+    this->t_buffer.push_back_n(source.begin(), source.end());
+    reference.insert(reference.end(), source.begin(), source.end());
+    ASSERT_EQ(this->t_buffer.size(), reference.size());
+    ASSERT_TRUE(std::equal(reference.begin(), reference.end(), this->t_buffer.begin()));
+}
+
+// Tests that consume() moves elements from the front in order and pop_front_n() removes them.
+TYPED_TEST(RingBufferTest, consume)
+{
+    const std::vector<TypeParam> original(this->t_buffer.begin(), this->t_buffer.end());
+    this->t_buffer.pop_front();
+    this->t_buffer.pop_front();
+    this->t_buffer.pop_front();
+    this->t_buffer.push_back_n(original.begin(), original.begin() + 3);
+
+    std::vector<TypeParam> reference(original.begin() + 3, original.end());
+    reference.insert(reference.end(), original.begin(), original.begin() + 3);
+    ASSERT_FALSE(this->t_buffer.array_two().empty());
+
+    std::vector<TypeParam> out(5);
+    auto outEnd = this->t_buffer.consume(out.begin(), out.size());
+    ASSERT_EQ(outEnd, out.end());
+    ASSERT_TRUE(std::equal(out.begin(), out.end(), reference.begin()));
+    ASSERT_EQ(this->t_buffer.size(), reference.size() - out.size());
+    ASSERT_TRUE(std::equal(this->t_buffer.begin(), this->t_buffer.end(), reference.begin() + out.size()));
+
+    this->t_buffer.pop_front_n(this->t_buffer.size());
+    ASSERT_TRUE(this->t_buffer.empty());
+}
+
+// Tests that consume_front() and consume_back() hand both segments to the callback in FIFO and LIFO order and remove the elements once.
+TYPED_TEST(RingBufferTest, consumeSegments)
+{
+    const std::vector<TypeParam> original(this->t_buffer.begin(), this->t_buffer.end());
+    this->t_buffer.pop_front_n(3);
+    this->t_buffer.push_back_n(original.begin(), original.begin() + 3);
+    std::vector<TypeParam> reference(original.begin() + 3, original.end());
+    reference.insert(reference.end(), original.begin(), original.begin() + 3);
+    const auto wrapped = this->t_buffer.array_two().size();
+    ASSERT_TRUE(wrapped > 0 && wrapped < 3);
+
+    // The last three elements span the wrap point, the newest segment comes first.
+    std::vector<size_t> segments;
+    std::vector<TypeParam> back;
+    this->t_buffer.consume_back(3, [&](typename ring_buffer<TypeParam>::span part) {
+        segments.push_back(part.size());
+        back.insert(back.begin(), part.begin(), part.end());
+    });
+    ASSERT_EQ(segments, (std::vector<size_t>{ wrapped, 3 - wrapped }));
+    ASSERT_TRUE(std::equal(back.begin(), back.end(), reference.end() - 3));
+    reference.erase(reference.end() - 3, reference.end());
+    ASSERT_EQ(this->t_buffer.size(), reference.size());
+    ASSERT_TRUE(std::equal(reference.begin(), reference.end(), this->t_buffer.begin()));
+
+    std::vector<TypeParam> front;
+    this->t_buffer.consume_front(2, [&](typename ring_buffer<TypeParam>::span part) { front.insert(front.end(), part.begin(), part.end()); });
+    ASSERT_EQ(front.size(), 2);
+    ASSERT_TRUE(std::equal(front.begin(), front.end(), reference.begin()));
+    ASSERT_TRUE(std::equal(this->t_buffer.begin(), this->t_buffer.end(), reference.begin() + 2));
+
+    segments.clear();
+    this->t_buffer.consume_front(this->t_buffer.size(), [&](typename ring_buffer<TypeParam>::span part) { segments.push_back(part.size()); });
+    ASSERT_EQ(segments.size(), 1);
+    ASSERT_TRUE(this->t_buffer.empty());
+    this->t_buffer.consume_back(0, [&](typename ring_buffer<TypeParam>::span) { FAIL(); });
+}
+
+// Tests that the callback's state is returned and that elements the callback throws on stay in the buffer.
+TEST(NonTypedTest, consumeCallback)
+{
+    ring_buffer<int> testBuffer{ 1, 2, 3, 4, 5, 6 };
+    struct Sum
+    {
+        int total = 0;
+        void operator()(ring_buffer<int>::span part)
+        {
+            for (auto value : part)
+            {
+                total += value;
+            }
+        }
+    };
+    ASSERT_EQ(testBuffer.consume_front(3, Sum()).total, 6);
+    ASSERT_EQ(testBuffer.size(), 3);
+
+    ASSERT_THROW(testBuffer.consume_back(2, [](ring_buffer<int>::span) { throw std::runtime_error("decode"); }), std::runtime_error);
+    ASSERT_EQ(testBuffer.size(), 3);
+    ASSERT_EQ(testBuffer.consume_back(3, Sum()).total, 15);
+    ASSERT_TRUE(testBuffer.empty());
+}
+
+// Tests comparison and search of trivially comparable buffers, which go through memcmp and memchr.
+TEST(NonTypedTest, BitwiseComparison)
+{
+    ring_buffer<int> lhs;
+    ring_buffer<int> rhs;
+    lhs.reserve(1000);
+    rhs.reserve(1000);
+    const std::vector<int> padding(300);
+    lhs.push_back_n(padding.begin(), padding.end());
+    lhs.pop_front_n(padding.size());
+    for (int i = 0; i < 900; i++)
+    {
+        lhs.push_back(i);
+        rhs.push_back(i);
+    }
+    ASSERT_FALSE(lhs.array_two().empty());
+    ASSERT_TRUE(rhs.array_two().empty());
+    ASSERT_TRUE(lhs == rhs);
+
+    // Mismatches in each of the three chunks: before lhs wraps, after it and at the end.
+    for (size_t index : { size_t(5), lhs.array_one().size(), size_t(899) })
+    {
+        lhs[index] = -1;
+        ASSERT_TRUE(lhs != rhs);
+        ASSERT_TRUE(lhs < rhs);
+        lhs[index] = static_cast<int>(index);
+        ASSERT_TRUE(lhs == rhs);
+    }
+
+    ASSERT_EQ(lhs.find(700) - lhs.begin(), 700);
+    ASSERT_EQ(lhs.find(5000), lhs.end());
+    ASSERT_EQ(lhs.count(3), 1);
+
+    ring_buffer<char> text{ 'a', 'b', 'c', 'd' };
+    text.pop_front_n(2);
+    text.push_back('a');
+    text.push_back('e');
+    ASSERT_EQ(text.find('a') - text.begin(), 2);
+    ASSERT_TRUE(text.contains('e'));
+    ASSERT_FALSE(text.contains('b'));
+
+    // Floating point elements compare with operator==.
+    ring_buffer<double> zeros{ 0.0, std::nan("") };
+    ring_buffer<double> negativeZeros{ -0.0, std::nan("") };
+    ASSERT_FALSE(zeros == negativeZeros);
+    zeros.pop_back();
+    negativeZeros.pop_back();
+    ASSERT_TRUE(zeros == negativeZeros);
+
+    // They are ordered with operator< only, like std::lexicographical_compare: NaN and signed zeros are equivalent and don't decide.
+    ring_buffer<double> nanOne{ std::nan(""), 1.0 };
+    ring_buffer<double> nanTwo{ std::nan(""), 2.0 };
+    ASSERT_TRUE(nanOne < nanTwo);
+    ASSERT_FALSE(nanTwo < nanOne);
+    ASSERT_FALSE(zeros < negativeZeros);
+    ASSERT_FALSE(negativeZeros < zeros);
+    negativeZeros.push_back(std::nan(""));
+    ASSERT_TRUE(zeros < negativeZeros);
+
+    // Wrapped buffers are compared across their wrap points.
+    ring_buffer<double> wrapped;
+    wrapped.reserve(8);
+    const std::vector<double> doublePadding(6);
+    wrapped.push_back_n(doublePadding.begin(), doublePadding.end());
+    wrapped.pop_front_n(doublePadding.size());
+    const double values[] = { std::nan(""), 1.0, 2.0, 3.0 };
+    wrapped.push_back_n(values, values + 4);
+    ASSERT_FALSE(wrapped.array_two().empty());
+    ring_buffer<double> flat(values, values + 4);
+    ASSERT_FALSE(wrapped < flat);
+    ASSERT_FALSE(flat < wrapped);
+    flat.back() = 4.0;
+    ASSERT_TRUE(wrapped < flat);
+    ASSERT_FALSE(flat < wrapped);
+}
+
+// Tests that chunks() and partition() cover the elements in order, respect the wrap point and start chunks on cache lines.
+TEST(NonTypedTest, Chunks)
+{
+    ring_buffer<int> testBuffer;
+    testBuffer.reserve(1000);
+    const std::vector<int> padding(333);
+    testBuffer.push_back_n(padding.begin(), padding.end());
+    testBuffer.pop_front_n(padding.size());
+    for (int i = 0; i < 900; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    ASSERT_FALSE(testBuffer.array_two().empty());
+
+    for (size_t count : { size_t(1), size_t(50), size_t(100), size_t(2000) })
+    {
+        const auto chunks = testBuffer.chunks(count);
+        int expected = 0;
+        for (size_t i = 0; i < chunks.size(); i++)
+        {
+            const auto& chunk = chunks[i];
+            ASSERT_FALSE(chunk.empty());
+            const bool segmentStart = chunk.data() == testBuffer.array_one().data() || chunk.data() == testBuffer.array_two().data();
+            ASSERT_TRUE(segmentStart || reinterpret_cast<std::uintptr_t>(chunk.data()) % 64 == 0);
+            const bool segmentEnd = chunk.end() == testBuffer.array_one().end() || chunk.end() == testBuffer.array_two().end();
+            ASSERT_TRUE(segmentEnd || chunk.size() >= count);
+            for (auto value : chunk)
+            {
+                ASSERT_EQ(value, expected++);
+            }
+        }
+        ASSERT_EQ(expected, 900);
+    }
+
+    const auto& constBuffer = testBuffer;
+    const auto parts = constBuffer.partition(8);
+    ASSERT_GE(parts.size(), 2);
+    ASSERT_LE(parts.size(), 9);
+    size_t total = 0;
+    for (const auto& part : parts)
+    {
+        total += part.size();
+    }
+    ASSERT_EQ(total, 900);
+    ASSERT_TRUE(testBuffer.partition(0).empty());
+    ASSERT_TRUE(ring_buffer<int>().partition(4).empty());
+}
+
+// Tests that append() copies trivially copyable elements into both free segments and grows at most once.
+TEST(NonTypedTest, append)
+{
+    ring_buffer<int> testBuffer{ 1, 2, 3, 4, 5 };
+    testBuffer.pop_front_n(3);
+
+    const int source[] = { 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 };
+    testBuffer.append(source, 4);
+    ASSERT_EQ(testBuffer.capacity(), 7);
+    ASSERT_FALSE(testBuffer.array_two().empty());
+
+    testBuffer.append(source + 4, 8);
+    ASSERT_EQ(testBuffer.size(), 14);
+    for (size_t i = 0; i < testBuffer.size(); i++)
+    {
+        ASSERT_EQ(testBuffer[i], static_cast<int>(i) + 4);
+    }
+
+    int out[14] = {};
+    ASSERT_EQ(testBuffer.consume(out, 14), out + 14);
+    ASSERT_TRUE(testBuffer.empty());
+    for (int i = 0; i < 14; i++)
+    {
+        ASSERT_EQ(out[i], i + 4);
+    }
 }
 
+// Tests that every growth path moves the existing elements instead of copying them when the move constructor is noexcept.
+TEST(NonTypedTest, GrowthMovesElements)
+{
+    using Counter = RelocationCounter<true>;
+    ring_buffer<Counter> testBuffer;
+    Counter::reset();
 
+    for (int i = 0; i < 50; i++)
+    {
+        testBuffer.emplace_back(i);
+    }
+    for (int i = 0; i < 50; i++)
+    {
+        testBuffer.emplace_front(i);
+    }
+    const Counter value(7);
+    testBuffer.insert(testBuffer.begin() + 10, testBuffer.capacity(), value);
+    testBuffer.reserve(testBuffer.capacity() * 2);
+    testBuffer.shrink_to_fit();
+
+    // Only the elements inserted from the lvalue are copied.
+    ASSERT_EQ(Counter::copies, testBuffer.size() - 100);
+    ASSERT_GT(Counter::moves, 0);
+}
+
+// Tests that growth falls back to copying when the move constructor might throw, to retain the strong exception guarantee.
+TEST(NonTypedTest, GrowthCopiesThrowingMove)
+{
+    using Counter = RelocationCounter<false>;
+    ring_buffer<Counter> testBuffer;
+    Counter::reset();
+
+    for (int i = 0; i < 20; i++)
+    {
+        testBuffer.emplace_back(i);
+    }
+
+    ASSERT_EQ(Counter::moves, 0);
+    ASSERT_GT(Counter::copies, 0);
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_EQ(testBuffer[i], Counter(i));
+    }
+}
 
 // Tests requirement: Optional a.shrink_to_fit().
 TYPED_TEST(RingBufferTest, shrink_to_fit)
@@ -1118,4 +1659,890 @@ TYPED_TEST(RingBufferTest, MonkeyTesting)
         auto validElement = testBuffer[i];
     }
 }
+
+// Tests that pow2_ring_buffer keeps its capacity at a power of two through growth, reserve and shrink.
+TEST(Pow2RingBuffer, CapacityIsPowerOfTwo)
+{
+    auto isPow2 = [](size_t value) { return value != 0 && (value & (value - 1)) == 0; };
+
+    pow2_ring_buffer<int> testBuffer;
+    ASSERT_TRUE(isPow2(testBuffer.capacity()));
+
+    for (int i = 0; i < 100; i++)
+    {
+        testBuffer.push_back(i);
+        ASSERT_TRUE(isPow2(testBuffer.capacity()));
+    }
+
+    testBuffer.reserve(300);
+    ASSERT_EQ(testBuffer.capacity(), 512);
+
+    testBuffer.shrink_to_fit();
+    ASSERT_EQ(testBuffer.capacity(), 128);
+
+    pow2_ring_buffer<int> sizedBuffer(5, 1);
+    ASSERT_EQ(sizedBuffer.capacity(), 8);
+
+    // Capacities beyond the highest power of two are rejected instead of wrapping around.
+    const size_t highest = (std::numeric_limits<size_t>::max() >> 1) + 1;
+    ASSERT_EQ(pow2_capacity_policy::fit(highest), highest);
+    ASSERT_THROW(pow2_capacity_policy::fit(highest + 1), std::length_error);
+    ASSERT_THROW(testBuffer.reserve(highest + 1), std::length_error);
+    ASSERT_EQ(testBuffer.capacity(), 128);
+}
+
+// Tests that mask based indexing gives the same elements as the default buffer when the buffer wraps around.
+TEST(Pow2RingBuffer, WrappedIndexing)
+{
+    pow2_ring_buffer<int> testBuffer;
+    ring_buffer<int> control;
+
+    for (int i = 0; i < 6; i++)
+    {
+        testBuffer.push_back(i);
+        control.push_back(i);
+    }
+
+    // Move the tail forward so that the next elements wrap around the physical end.
+    for (int i = 0; i < 4; i++)
+    {
+        testBuffer.pop_front();
+        control.pop_front();
+        testBuffer.push_back(i + 10);
+        control.push_back(i + 10);
+    }
+    testBuffer.push_front(42);
+    control.push_front(42);
+
+    ASSERT_EQ(testBuffer.size(), control.size());
+    for (size_t i = 0; i < control.size(); i++)
+    {
+        ASSERT_EQ(testBuffer[i], control[i]);
+        ASSERT_EQ(testBuffer.at(i), control.at(i));
+    }
+    ASSERT_TRUE(std::equal(testBuffer.begin(), testBuffer.end(), control.begin()));
+    ASSERT_THROW(testBuffer.at(testBuffer.size()), std::out_of_range);
+
+    testBuffer.insert(testBuffer.begin() + 2, size_t(3), 7);
+    control.insert(control.begin() + 2, size_t(3), 7);
+    ASSERT_TRUE(std::equal(testBuffer.begin(), testBuffer.end(), control.begin()));
+}
+
+// Tests that a full overwriting buffer drops the oldest elements without allocating.
+TEST(OverwriteRingBuffer, PushBackOverwritesFront)
+{
+    overwrite_ring_buffer<int> testBuffer;
+    testBuffer.reserve(5);
+    const auto capacity = testBuffer.capacity();
+    ASSERT_EQ(capacity, 5);
+
+    for (int i = 0; i < 10; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    ASSERT_EQ(testBuffer.capacity(), capacity);
+    ASSERT_EQ(testBuffer.size(), 4);
+    ASSERT_EQ(testBuffer.dropped(), 6);
+    ASSERT_TRUE(std::equal(testBuffer.begin(), testBuffer.end(), std::vector<int>{6, 7, 8, 9}.begin()));
+
+    // Pushing to the front drops the newest element.
+    testBuffer.push_front(5);
+    ASSERT_EQ(testBuffer.dropped(), 7);
+    ASSERT_TRUE(std::equal(testBuffer.begin(), testBuffer.end(), std::vector<int>{5, 6, 7, 8}.begin()));
+
+    testBuffer.reset_dropped();
+    ASSERT_EQ(testBuffer.dropped(), 0);
+
+    // Growth that the buffer can't overwrite its way out of is refused.
+    ASSERT_THROW(testBuffer.insert(testBuffer.begin() + 1, 0), std::length_error);
+    ASSERT_EQ(testBuffer.size(), 4);
+    ASSERT_EQ(testBuffer.capacity(), capacity);
+
+    // A moved-from buffer has no capacity pinned, its next push allocates like a new buffer's, and later pushes overwrite again.
+    auto moved = std::move(testBuffer);
+    ASSERT_EQ(testBuffer.capacity(), 0);
+    testBuffer.push_back(1);
+    ASSERT_EQ(testBuffer.capacity(), overwrite_ring_buffer<int>().capacity());
+    ASSERT_EQ(testBuffer.back(), 1);
+    const auto reusedCapacity = testBuffer.capacity();
+    for (int i = 2; i < 10; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    ASSERT_EQ(testBuffer.capacity(), reusedCapacity);
+    ASSERT_EQ(testBuffer.back(), 9);
+    auto appended = std::move(moved);
+    const int values[] = { 1, 2, 3 };
+    moved.append(values, 3);
+    ASSERT_EQ(moved.size(), 3);
+    ASSERT_EQ(moved.dropped(), 0);
+
+    // Regular buffers never drop.
+    ring_buffer<int> growing{ 1, 2, 3 };
+    growing.push_back(4);
+    ASSERT_EQ(growing.dropped(), 0);
+}
+
+// Tests that bulk appends to an overwriting buffer keep the newest elements.
+TEST(OverwriteRingBuffer, AppendOverwritesFront)
+{
+    ring_buffer<std::string, std::allocator<std::string>, overwrite_capacity_policy<pow2_capacity_policy>> testBuffer;
+    testBuffer.reserve(8);
+    std::vector<std::string> source{ "a", "b", "c", "d", "e" };
+
+    testBuffer.push_back_n(source.begin(), source.end());
+    ASSERT_EQ(testBuffer.dropped(), 0);
+    testBuffer.push_back_n(source.begin(), source.end());
+    ASSERT_EQ(testBuffer.size(), 7);
+    ASSERT_EQ(testBuffer.dropped(), 3);
+    ASSERT_EQ(testBuffer.front(), "d");
+    ASSERT_EQ(testBuffer.back(), "e");
+
+    // Range longer than the buffer keeps only its tail.
+    std::vector<std::string> longSource(20);
+    for (size_t i = 0; i < longSource.size(); i++)
+    {
+        longSource[i] = std::to_string(i);
+    }
+    testBuffer.push_back_n(longSource.begin(), longSource.end());
+    ASSERT_EQ(testBuffer.capacity(), 8);
+    ASSERT_EQ(testBuffer.size(), 7);
+    ASSERT_EQ(testBuffer.dropped(), 3 + 20);
+    ASSERT_TRUE(std::equal(testBuffer.begin(), testBuffer.end(), longSource.end() - 7));
+
+    overwrite_ring_buffer<int> trivialBuffer;
+    trivialBuffer.reserve(4);
+    int values[] = { 1, 2, 3, 4, 5 };
+    trivialBuffer.append(values, 2);
+    trivialBuffer.append(values + 2, 3);
+    ASSERT_EQ(trivialBuffer.dropped(), 2);
+    ASSERT_TRUE(std::equal(trivialBuffer.begin(), trivialBuffer.end(), values + 2));
+}
+
+// Tests that a small buffer allocates only when it outgrows its inline storage, and gives the memory back on shrink_to_fit.
+TEST(SmallRingBuffer, InlineUntilFull)
+{
+    using Alloc = CountingAllocator<std::string>;
+    Alloc::reset();
+    {
+        small_ring_buffer<std::string, 8, Alloc> testBuffer;
+        ASSERT_EQ(testBuffer.capacity(), 9);
+
+        for (int i = 0; i < 20; i++)
+        {
+            testBuffer.push_back(std::to_string(i));
+            if (testBuffer.size() > 6)
+            {
+                testBuffer.pop_front();
+            }
+        }
+        ASSERT_EQ(testBuffer.size(), 6);
+        testBuffer.push_back("20");
+        testBuffer.push_back("21");
+        ASSERT_EQ(testBuffer.size(), 8);
+        ASSERT_EQ(Alloc::allocations, 0);
+
+        testBuffer.push_front("13");
+        ASSERT_EQ(Alloc::allocations, 1);
+        ASSERT_GT(testBuffer.capacity(), 9);
+        for (size_t i = 0; i < testBuffer.size(); i++)
+        {
+            ASSERT_EQ(testBuffer[i], std::to_string(13 + i));
+        }
+
+        testBuffer.pop_back();
+        testBuffer.pop_front();
+        testBuffer.shrink_to_fit();
+        ASSERT_EQ(testBuffer.capacity(), 9);
+        ASSERT_EQ(Alloc::deallocations, 1);
+        for (size_t i = 0; i < testBuffer.size(); i++)
+        {
+            ASSERT_EQ(testBuffer[i], std::to_string(14 + i));
+        }
+
+        // Shrinking inline storage does nothing.
+        testBuffer.shrink_to_fit();
+        ASSERT_EQ(testBuffer.capacity(), 9);
+        ASSERT_EQ(Alloc::allocations, 1);
+
+        testBuffer.assign(3, "x");
+        ASSERT_EQ(Alloc::allocations, 1);
+        testBuffer.assign(12, "y");
+        ASSERT_EQ(Alloc::allocations, 2);
+        ASSERT_EQ(testBuffer.size(), 12);
+    }
+    ASSERT_EQ(Alloc::allocations, Alloc::deallocations);
+}
+
+// Tests moving, swapping and copying small buffers in every combination of inline and allocated storage.
+TEST(SmallRingBuffer, MoveAndSwap)
+{
+    auto makeBuffer = [](int count)
+    {
+        small_ring_buffer<std::string, 4> buffer;
+        // Wrap inline elements around the physical end.
+        buffer.push_back("dropped");
+        buffer.push_back("dropped");
+        buffer.pop_front();
+        buffer.pop_front();
+        for (int i = 0; i < count; i++)
+        {
+            buffer.push_back(std::to_string(i));
+        }
+        return buffer;
+    };
+    auto matches = [](const small_ring_buffer<std::string, 4>& buffer, int count)
+    {
+        if (buffer.size() != static_cast<size_t>(count)) return false;
+        for (int i = 0; i < count; i++)
+        {
+            if (buffer[i] != std::to_string(i)) return false;
+        }
+        return true;
+    };
+
+    auto inlineBuffer = makeBuffer(3);
+    auto moved(std::move(inlineBuffer));
+    ASSERT_TRUE(matches(moved, 3));
+    ASSERT_TRUE(inlineBuffer.empty());
+    inlineBuffer.push_back("0");
+    ASSERT_TRUE(matches(inlineBuffer, 1));
+
+    auto heapBuffer = makeBuffer(10);
+    auto movedHeap(std::move(heapBuffer));
+    ASSERT_TRUE(matches(movedHeap, 10));
+    ASSERT_TRUE(heapBuffer.empty());
+    ASSERT_EQ(heapBuffer.capacity(), 5);
+
+    // The reallocation counts are swapped with the elements, whichever side is inline.
+    const auto heapReallocations = movedHeap.reallocations();
+    ASSERT_GT(heapReallocations, 0);
+    ASSERT_EQ(moved.reallocations(), 0);
+    swap(moved, movedHeap);
+    ASSERT_TRUE(matches(moved, 10));
+    ASSERT_TRUE(matches(movedHeap, 3));
+    ASSERT_EQ(moved.reallocations(), heapReallocations);
+    ASSERT_EQ(movedHeap.reallocations(), 0);
+
+    auto other = makeBuffer(2);
+    other.swap(moved);
+    ASSERT_EQ(other.reallocations(), heapReallocations);
+    ASSERT_EQ(moved.reallocations(), 0);
+    other.swap(moved);
+    swap(movedHeap, other);
+    ASSERT_TRUE(matches(movedHeap, 2));
+    ASSERT_TRUE(matches(other, 3));
+
+    moved = std::move(other);
+    ASSERT_TRUE(matches(moved, 3));
+
+    auto copy = makeBuffer(7);
+    copy = moved;
+    ASSERT_TRUE(matches(copy, 3));
+    ASSERT_TRUE(copy == moved);
+}
+
+template<class T>
+T numberedValue(int i)
+{
+    return T(i);
+}
+
+template<>
+std::string numberedValue<std::string>(int i)
+{
+    return std::to_string(i);
+}
+
+// Tests in place insertion on both sides of a wrapped buffer against std::deque, without allocating.
+template<class T>
+void checkInPlaceInsert()
+{
+    using Alloc = CountingAllocator<T>;
+    ring_buffer<T, Alloc> testBuffer;
+    testBuffer.reserve(256);
+    std::deque<T> control;
+
+    for (int i = 0; i < 40; i++)
+    {
+        testBuffer.push_back(numberedValue<T>(i));
+        control.push_back(numberedValue<T>(i));
+    }
+    for (int i = 0; i < 30; i++)
+    {
+        testBuffer.pop_front();
+        control.pop_front();
+        testBuffer.push_back(numberedValue<T>(i + 100));
+        control.push_back(numberedValue<T>(i + 100));
+    }
+
+    Alloc::reset();
+    std::vector<T> range{ numberedValue<T>(1), numberedValue<T>(2), numberedValue<T>(3), numberedValue<T>(4), numberedValue<T>(5) };
+    const size_t positions[] = { 0, 1, 3, 17, 20, 25, 38, 40 };
+    for (auto pos : positions)
+    {
+        pos = std::min(pos, control.size());
+        ASSERT_EQ(*testBuffer.insert(testBuffer.begin() + pos, numberedValue<T>(7)), numberedValue<T>(7));
+        control.insert(control.begin() + pos, numberedValue<T>(7));
+
+        testBuffer.insert(testBuffer.begin() + pos, size_t(3), numberedValue<T>(8));
+        control.insert(control.begin() + pos, size_t(3), numberedValue<T>(8));
+
+        testBuffer.insert(testBuffer.begin() + pos, range.begin(), range.end());
+        control.insert(control.begin() + pos, range.begin(), range.end());
+
+        testBuffer.emplace(testBuffer.end() - pos, numberedValue<T>(9));
+        control.emplace(control.end() - pos, numberedValue<T>(9));
+
+        // Inserted value refers to an element that is moved.
+        testBuffer.insert(testBuffer.begin() + pos, testBuffer[control.size() / 2]);
+        control.insert(control.begin() + pos, T(control[control.size() / 2]));
+
+        ASSERT_EQ(testBuffer.size(), control.size());
+        ASSERT_TRUE(std::equal(control.begin(), control.end(), testBuffer.begin()));
+    }
+    ASSERT_EQ(Alloc::allocations, 0);
+    ASSERT_EQ(testBuffer.capacity(), 256);
+}
+
+TEST(NonTypedTest, InsertInPlace)
+{
+    checkInPlaceInsert<int>();
+    checkInPlaceInsert<std::string>();
+    checkInPlaceInsert<NonTrivialTestType>();
+}
+
+// Tests that a throwing copy during in place insertion leaves the buffer unchanged.
+TEST(NonTypedTest, InsertInPlaceStrongGuarantee)
+{
+    ring_buffer<ThrowingCopy> testBuffer;
+    testBuffer.reserve(32);
+    for (int i = 0; i < 10; i++)
+    {
+        testBuffer.push_back(ThrowingCopy(i));
+    }
+    testBuffer.pop_front();
+    testBuffer.pop_front();
+    std::vector<ThrowingCopy> original(testBuffer.begin(), testBuffer.end());
+    std::vector<ThrowingCopy> range(5, ThrowingCopy(42));
+
+    for (size_t pos : { size_t(1), size_t(6) })
+    {
+        ThrowingCopy::countdown = 3;
+        ASSERT_THROW(testBuffer.insert(testBuffer.begin() + pos, range.begin(), range.end()), std::runtime_error);
+        ThrowingCopy::countdown = 2;
+        ASSERT_THROW(testBuffer.insert(testBuffer.begin() + pos, size_t(4), ThrowingCopy(42)), std::runtime_error);
+        ThrowingCopy::countdown = -1;
+
+        ASSERT_EQ(testBuffer.capacity(), 32);
+        ASSERT_EQ(testBuffer.size(), original.size());
+        ASSERT_TRUE(std::equal(original.begin(), original.end(), testBuffer.begin()));
+    }
+}
+
+// Tests erasure on both sides of a wrapped buffer against std::deque.
+template<class T>
+void checkShorterSideErase()
+{
+    ring_buffer<T> testBuffer;
+    testBuffer.reserve(128);
+    std::deque<T> control;
+    for (int i = 0; i < 100; i++)
+    {
+        testBuffer.push_back(numberedValue<T>(i));
+        control.push_back(numberedValue<T>(i));
+    }
+    for (int i = 0; i < 60; i++)
+    {
+        testBuffer.pop_front();
+        control.pop_front();
+        testBuffer.push_back(numberedValue<T>(i + 100));
+        control.push_back(numberedValue<T>(i + 100));
+    }
+
+    const size_t positions[] = { 0, 2, 30, 45, 60, 97 };
+    for (auto pos : positions)
+    {
+        pos = std::min(pos, control.size() - 1);
+        auto result = testBuffer.erase(testBuffer.begin() + pos);
+        auto expected = control.erase(control.begin() + pos);
+        ASSERT_EQ(result - testBuffer.begin(), expected - control.begin());
+
+        const auto count = std::min(size_t(4), control.size() - pos);
+        testBuffer.erase(testBuffer.begin() + pos, testBuffer.begin() + pos + count);
+        control.erase(control.begin() + pos, control.begin() + pos + count);
+
+        ASSERT_EQ(testBuffer.size(), control.size());
+        ASSERT_TRUE(std::equal(control.begin(), control.end(), testBuffer.begin()));
+    }
+    ASSERT_EQ(testBuffer.erase(testBuffer.begin() + 3, testBuffer.begin() + 3), testBuffer.begin() + 3);
+    testBuffer.erase(testBuffer.begin(), testBuffer.end());
+    ASSERT_TRUE(testBuffer.empty());
+    ASSERT_EQ(testBuffer.capacity(), 128);
+}
+
+TEST(NonTypedTest, EraseShorterSide)
+{
+    checkShorterSideErase<int>();
+    checkShorterSideErase<std::string>();
+    checkShorterSideErase<NonTrivialTestType>();
+}
+
+// Tests discarding elements from both ends of a wrapped buffer.
+TEST(NonTypedTest, AdvanceFrontDropBack)
+{
+    ring_buffer<int> ints;
+    ring_buffer<std::shared_ptr<int>> pointers;
+    auto shared = std::make_shared<int>(5);
+    ints.reserve(16);
+    pointers.reserve(16);
+    for (int i = 0; i < 12; i++)
+    {
+        ints.push_back(i);
+        pointers.push_back(shared);
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        ints.pop_front();
+        ints.push_back(i + 12);
+        pointers.pop_front();
+        pointers.push_back(shared);
+    }
+
+    ints.advance_front(5);
+    ints.drop_back(4);
+    ASSERT_EQ(ints.size(), 3);
+    ASSERT_EQ(ints.front(), 13);
+    ASSERT_EQ(ints.back(), 15);
+
+    pointers.advance_front(5);
+    pointers.drop_back(4);
+    ASSERT_EQ(pointers.size(), 3);
+    ASSERT_EQ(shared.use_count(), 4);
+
+    ints.drop_back(3);
+    pointers.advance_front(3);
+    ASSERT_TRUE(ints.empty());
+    ASSERT_TRUE(pointers.empty());
+    ASSERT_EQ(shared.use_count(), 1);
+    ASSERT_EQ(ints.capacity(), 16);
+}
+
+// Tests that elements are destroyed through an allocator's own destroy, and skipped otherwise.
+TEST(NonTypedTest, TrivialDestroy)
+{
+    static_assert(_trivial_destroy<std::allocator<int>>::value, "std::allocator<int> destroy is a no-op");
+    static_assert(_trivial_destroy<CountingAllocator<int>>::value, "CountingAllocator<int> has no destroy");
+    static_assert(!_trivial_destroy<DestroyCountingAllocator<int>>::value, "DestroyCountingAllocator<int> has destroy");
+    static_assert(!_trivial_destroy<std::allocator<std::string>>::value, "std::string is not trivially destructible");
+
+    DestroyCountingAllocator<int>::destroys = 0;
+    {
+        ring_buffer<int, DestroyCountingAllocator<int>> testBuffer;
+        testBuffer.reserve(16);
+        for (int i = 0; i < 20; i++)
+        {
+            testBuffer.push_back(i);
+            if (testBuffer.size() > 10)
+            {
+                testBuffer.pop_front();
+            }
+        }
+        ASSERT_EQ(DestroyCountingAllocator<int>::destroys, 10);
+        testBuffer.pop_front_n(3);
+        testBuffer.drop_back(2);
+        ASSERT_EQ(DestroyCountingAllocator<int>::destroys, 15);
+        testBuffer.clear();
+        ASSERT_EQ(DestroyCountingAllocator<int>::destroys, 20);
+        testBuffer.assign(size_t(4), 1);
+        ASSERT_EQ(testBuffer.size(), 4);
+    }
+    ASSERT_EQ(DestroyCountingAllocator<int>::destroys, 24);
+
+    auto shared = std::make_shared<int>(1);
+    {
+        ring_buffer<std::shared_ptr<int>> pointers(size_t(6), shared);
+        pointers.assign(size_t(2), shared);
+        ASSERT_EQ(shared.use_count(), 3);
+        pointers.clear();
+        ASSERT_EQ(shared.use_count(), 1);
+        pointers.assign(size_t(3), shared);
+    }
+    ASSERT_EQ(shared.use_count(), 1);
+}
+
+struct QuadrupleGrowth
+{
+    size_t operator()(size_t capacity) const { return capacity * 4; }
+};
+
+// Tests the growth functions, the minimum capacity and the reallocation count.
+TEST(NonTypedTest, GrowthPolicy)
+{
+    static_assert(geometric_growth<>()(10) == 15, "default growth is 1.5");
+    static_assert(geometric_growth<>()(3) == 4, "growth rounds down");
+    static_assert(doubling_growth()(8) == 16, "doubling");
+    static_assert(fixed_growth<100>()(8) == 108, "fixed increment");
+
+    ring_buffer<int, std::allocator<int>, growth_capacity_policy<doubling_growth, 1024>> doubling;
+    ASSERT_EQ(doubling.capacity(), 1024);
+    for (int i = 0; i < 1023; i++)
+    {
+        doubling.push_back(i);
+    }
+    ASSERT_EQ(doubling.reallocations(), 0);
+    doubling.push_back(0);
+    ASSERT_EQ(doubling.reallocations(), 1);
+    ASSERT_EQ(doubling.capacity(), 2048);
+
+    ring_buffer<int> geometric;
+    for (int i = 0; i < 1023; i++)
+    {
+        geometric.push_back(i);
+    }
+    ASSERT_GT(geometric.reallocations(), 10);
+    geometric.reset_reallocations();
+    ASSERT_EQ(geometric.reallocations(), 0);
+
+    ring_buffer<int, std::allocator<int>, growth_capacity_policy<fixed_growth<100>, 10>> fixed;
+    for (int i = 0; i < 10; i++)
+    {
+        fixed.push_back(i);
+    }
+    ASSERT_EQ(fixed.reallocations(), 1);
+    ASSERT_EQ(fixed.capacity(), 110);
+    fixed.shrink_to_fit();
+    ASSERT_EQ(fixed.capacity(), 12);
+    fixed.clear();
+    fixed.shrink_to_fit();
+    ASSERT_EQ(fixed.capacity(), 10);
+    ASSERT_EQ(fixed.reallocations(), 3);
+
+    ring_buffer<int, std::allocator<int>, growth_capacity_policy<QuadrupleGrowth>> quadruple;
+    quadruple.push_back(1);
+    quadruple.push_back(2);
+    ASSERT_EQ(quadruple.capacity(), 8);
+
+    ring_buffer<int, std::allocator<int>, growth_capacity_policy<fixed_growth<3>, 5, pow2_capacity_policy>> pow2;
+    ASSERT_EQ(pow2.capacity(), 8);
+    for (int i = 0; i < 8; i++)
+    {
+        pow2.push_back(i);
+    }
+    ASSERT_EQ(pow2.capacity(), 16);
+
+    auto moved = std::move(pow2);
+    ASSERT_EQ(moved.reallocations(), 1);
+    ASSERT_EQ(pow2.reallocations(), 0);
+    swap(moved, pow2);
+    ASSERT_EQ(pow2.reallocations(), 1);
+}
+
+// Tests copying a buffer whose elements wrap around the end of memory.
+TEST(NonTypedTest, CopyWrapped)
+{
+    ring_buffer<std::string> testBuffer;
+    testBuffer.reserve(8);
+    for (int i = 0; i < 12; i++)
+    {
+        testBuffer.push_back(std::to_string(i));
+        if (testBuffer.size() > 5)
+        {
+            testBuffer.pop_front();
+        }
+    }
+
+    ring_buffer<std::string> copy(testBuffer);
+    ring_buffer<std::string> allocatorCopy(testBuffer, testBuffer.get_allocator());
+    ASSERT_TRUE(copy == testBuffer);
+    ASSERT_TRUE(allocatorCopy == testBuffer);
+    copy.push_back("12");
+    ASSERT_EQ(copy.front(), "7");
+    ASSERT_EQ(copy.back(), "12");
+}
+namespace
+{
+    // Element whose move constructor may throw, so inserts relocate the whole buffer instead of shifting elements.
+    struct ThrowingMove
+    {
+        ThrowingMove(int v) : value(v) {}
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&& other) noexcept(false) : value(other.value) {}
+        ThrowingMove& operator=(const ThrowingMove&) = default;
+        int value;
+    };
+}
+
+// Tests the counters and hooks of stats_capacity_policy.
+TEST(NonTypedTest, Statistics)
+{
+    static_assert(std::is_empty<ring_buffer_stats_collector<false>>::value, "disabled statistics must not take space");
+
+    stats_ring_buffer<int> testBuffer;
+    std::vector<std::pair<size_t, size_t>> growths;
+    testBuffer.on_growth([&growths](size_t oldCapacity, size_t newCapacity) { growths.emplace_back(oldCapacity, newCapacity); });
+    for (int i = 0; i < 20; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    auto stats = testBuffer.statistics();
+    ASSERT_EQ(stats.pushes, 20);
+    ASSERT_EQ(stats.peak_size, 20);
+    ASSERT_EQ(stats.growths, testBuffer.reallocations());
+    ASSERT_EQ(growths.size(), stats.growths);
+    for (const auto& growth : growths)
+    {
+        ASSERT_LT(growth.first, growth.second);
+    }
+    ASSERT_EQ(growths.back().second, testBuffer.capacity());
+
+    testBuffer.pop_front();
+    testBuffer.pop_back();
+    testBuffer.pop_front_n(3);
+    testBuffer.erase(testBuffer.begin() + 2);
+    testBuffer.insert(testBuffer.begin() + 4, { 1, 2 });
+    stats = testBuffer.statistics();
+    ASSERT_EQ(stats.pops, 6);
+    ASSERT_EQ(stats.pushes, 22);
+    ASSERT_EQ(stats.peak_size, 20);
+    ASSERT_EQ(stats.slow_inserts, 0);
+
+    // Wrap the elements around, then make them contiguous again.
+    while (testBuffer.array_two().empty())
+    {
+        testBuffer.pop_front();
+        testBuffer.push_back(0);
+    }
+    const auto bytes = testBuffer.statistics().bytes_relocated;
+    testBuffer.data();
+    testBuffer.data();
+    stats = testBuffer.statistics();
+    ASSERT_EQ(stats.linearizations, 1);
+    ASSERT_EQ(stats.bytes_relocated, bytes + testBuffer.size() * sizeof(int));
+    ASSERT_EQ(stats.growths, growths.size());
+
+    // Moving transfers the statistics and the hook, copies start fresh.
+    auto moved = std::move(testBuffer);
+    ASSERT_EQ(moved.statistics().pushes, stats.pushes);
+    ASSERT_EQ(testBuffer.statistics().pushes, 0);
+    const auto copy = moved;
+    ASSERT_EQ(copy.statistics().pushes, 0);
+    const decltype(moved) allocatorCopy(moved, moved.get_allocator());
+    ASSERT_EQ(allocatorCopy.statistics().pushes, 0);
+    moved.shrink_to_fit();
+    moved.append(std::vector<int>(100).data(), 100);
+    ASSERT_EQ(growths.size(), stats.growths + 1);
+    moved.reset_statistics();
+    ASSERT_EQ(moved.statistics().pushes, 0);
+    ASSERT_EQ(moved.statistics().growths, 0);
+
+    // Inserting elements that can't be shifted without exceptions relocates the buffer.
+    ring_buffer<ThrowingMove, std::allocator<ThrowingMove>, stats_capacity_policy<>> throwing;
+    throwing.reserve(16);
+    throwing.push_back(1);
+    throwing.push_back(2);
+    throwing.emplace(throwing.begin() + 1, 3);
+    throwing.insert(throwing.begin() + 1, 2, ThrowingMove(4));
+    ASSERT_EQ(throwing.statistics().slow_inserts, 2);
+    ASSERT_EQ(throwing.statistics().growths, 1);
+    ASSERT_EQ(throwing[1].value, 4);
+
+    // Buffers without the policy count nothing.
+    ring_buffer<int> plain{ 1, 2, 3 };
+    plain.push_back(4);
+    ASSERT_EQ(plain.statistics().pushes, 0);
+}
+
+// Tests the overflow hook of an overwriting buffer with statistics.
+TEST(NonTypedTest, OverflowHook)
+{
+    ring_buffer<int, std::allocator<int>, stats_capacity_policy<overwrite_capacity_policy<>>> testBuffer;
+    testBuffer.reserve(5);
+    size_t overflows = 0;
+    size_t calls = 0;
+    testBuffer.on_overflow([&](size_t dropped) { overflows += dropped; ++calls; });
+    for (int i = 0; i < 6; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    testBuffer.push_front(-1);
+    ASSERT_EQ(overflows, 3);
+    ASSERT_EQ(calls, 3);
+
+    const std::vector<int> values(10, 7);
+    testBuffer.append(values.data(), values.size());
+    ASSERT_EQ(overflows, 13);
+    ASSERT_EQ(calls, 4);
+
+    const auto stats = testBuffer.statistics();
+    ASSERT_EQ(stats.overflows, testBuffer.dropped());
+    ASSERT_EQ(stats.overflows, 13);
+    ASSERT_EQ(stats.pushes, 17);
+    ASSERT_EQ(stats.pops, 0);
+    ASSERT_EQ(stats.peak_size, 4);
+    ASSERT_EQ(stats.growths, 1);
+}
+
+// Tests the round trip of raw elements through a stream, for wrapped and fixed capacity buffers.
+TEST(NonTypedTest, SerializeTrivial)
+{
+    ring_buffer<int> testBuffer;
+    testBuffer.reserve(16);
+    for (int i = 0; i < 20; i++)
+    {
+        testBuffer.push_back(i);
+        if (testBuffer.size() > 10)
+        {
+            testBuffer.pop_front();
+        }
+    }
+    ASSERT_FALSE(testBuffer.array_two().empty());
+
+    std::stringstream stream;
+    testBuffer.serialize(stream);
+    ASSERT_EQ(stream.str().size(), 16 + 10 * sizeof(int));
+    const auto restored = ring_buffer<int>::deserialize(stream);
+    ASSERT_TRUE(restored == testBuffer);
+    ASSERT_EQ(restored.capacity(), 10 + allocBuffer);
+    ASSERT_TRUE(restored.array_two().empty());
+
+    // Buffers of other policies read the same format.
+    stream.seekg(0);
+    const auto fixed = static_ring_buffer<int, 16>::deserialize(stream);
+    ASSERT_EQ(std::vector<int>(fixed.begin(), fixed.end()), std::vector<int>(testBuffer.begin(), testBuffer.end()));
+    stream.seekg(0);
+    ASSERT_THROW((static_ring_buffer<int, 8>::deserialize(stream)), std::length_error);
+
+    const auto empty = ring_buffer<int>::restore(ring_buffer<int>().snapshot());
+    ASSERT_TRUE(empty.empty());
+}
+
+// Tests snapshots of elements that go through ring_buffer_serializer, and rejection of bad data.
+TEST(NonTypedTest, SnapshotRestore)
+{
+    ring_buffer<std::string> testBuffer;
+    for (int i = 0; i < 12; i++)
+    {
+        testBuffer.push_back(std::string(static_cast<size_t>(i), 'a' + static_cast<char>(i)));
+        if (testBuffer.size() > 6)
+        {
+            testBuffer.pop_front();
+        }
+    }
+
+    std::vector<char> bytes;
+    testBuffer.snapshot(bytes);
+    const auto restored = ring_buffer<std::string>::restore(bytes);
+    ASSERT_TRUE(restored == testBuffer);
+    ASSERT_EQ(restored.capacity(), 6 + allocBuffer);
+    ASSERT_EQ(restored.back(), std::string(11, 'l'));
+
+    // Truncated data and data of other element types are rejected.
+    ASSERT_THROW(ring_buffer<std::string>::restore(bytes.data(), bytes.size() - 1), std::runtime_error);
+    ASSERT_THROW(ring_buffer<std::string>::restore(bytes.data(), 8), std::runtime_error);
+    ASSERT_THROW(ring_buffer<int>::restore(bytes), std::runtime_error);
+    const auto ints = ring_buffer<int>({ 1, 2, 3 }).snapshot();
+    ASSERT_THROW(ring_buffer<double>::restore(ints), std::runtime_error);
+    ASSERT_THROW(ring_buffer<int>::restore(ints.data(), ints.size() - 4), std::runtime_error);
+
+    // Corrupt sizes larger than the remaining bytes are rejected before anything is allocated.
+    using counted_buffer = ring_buffer<int, CountingAllocator<int>>;
+    auto corrupt = ints;
+    const std::uint64_t hugeSize = std::uint64_t(1) << 40;
+    std::memcpy(corrupt.data() + 8, &hugeSize, sizeof(hugeSize));
+    CountingAllocator<int>::reset();
+    ASSERT_THROW(counted_buffer::restore(corrupt), std::runtime_error);
+    ASSERT_EQ(CountingAllocator<int>::allocations, 0);
+    std::memcpy(bytes.data() + 16, &hugeSize, sizeof(hugeSize));
+    ASSERT_THROW(ring_buffer<std::string>::restore(bytes), std::runtime_error);
+}
+
+// Tests that hysteresis_capacity_policy shrinks only after enough pops in a row below the low watermark.
+TEST(NonTypedTest, HysteresisShrink)
+{
+    ring_buffer<int, std::allocator<int>, hysteresis_capacity_policy<25, 50, 8>> testBuffer;
+    testBuffer.reserve(1002);
+    for (int i = 0; i < 1000; i++)
+    {
+        testBuffer.push_back(i);
+    }
+
+    // 250 elements are exactly at the low watermark, every pop below it counts.
+    testBuffer.pop_front_n(750);
+    for (int i = 0; i < 7; i++)
+    {
+        testBuffer.pop_front();
+    }
+    ASSERT_EQ(testBuffer.capacity(), 1002);
+
+    // A pop that leaves the buffer at or above the watermark starts over.
+    for (int i = 0; i < 10; i++)
+    {
+        testBuffer.push_back(i);
+    }
+    testBuffer.pop_back();
+    for (int i = 0; i < 9; i++)
+    {
+        testBuffer.pop_front();
+    }
+    ASSERT_EQ(testBuffer.capacity(), 1002);
+
+    // The eighth pop in a row below it shrinks the buffer to half full.
+    testBuffer.drop_back(1);
+    ASSERT_EQ(testBuffer.size(), 242);
+    ASSERT_EQ(testBuffer.capacity(), 486);
+    ASSERT_EQ(testBuffer.front(), 766);
+    ASSERT_EQ(testBuffer.back(), 7);
+    ASSERT_EQ(testBuffer.reallocations(), 2);
+
+    // Half full is well above the low watermark, so popping on doesn't shrink it again.
+    for (int i = 0; i < 100; i++)
+    {
+        testBuffer.pop_front();
+    }
+    ASSERT_EQ(testBuffer.capacity(), 486);
+}
+
+// Tests that a buffer alternating between bursts and idle periods recycles its memory through the spare.
+TEST(NonTypedTest, SpareRecycling)
+{
+    CountingAllocator<int>::reset();
+    ring_buffer<int, CountingAllocator<int>, hysteresis_capacity_policy<25, 50, 8, spare_capacity_policy<>>> testBuffer;
+
+    const auto cycle = [&testBuffer]() {
+        for (int i = 0; i < 1000; i++)
+        {
+            testBuffer.push_back(i);
+        }
+        const auto burstCapacity = testBuffer.capacity();
+
+        // Idle: a few elements come and go.
+        testBuffer.pop_front_n(testBuffer.size() - 20);
+        for (int i = 0; i < 20; i++)
+        {
+            testBuffer.push_back(i);
+            testBuffer.pop_front();
+        }
+        return burstCapacity;
+    };
+
+    const auto burstCapacity = cycle();
+    ASSERT_EQ(testBuffer.capacity(), 42);
+    ASSERT_EQ(testBuffer.spare_capacity(), burstCapacity);
+    const auto firstCycle = CountingAllocator<int>::allocations;
+
+    // Later bursts take the spare in one step and the idle periods take back the small memory.
+    const auto reallocations = testBuffer.reallocations();
+    ASSERT_EQ(cycle(), burstCapacity);
+    ASSERT_EQ(cycle(), burstCapacity);
+    ASSERT_EQ(CountingAllocator<int>::allocations, firstCycle);
+    ASSERT_EQ(testBuffer.reallocations(), reallocations + 4);
+    ASSERT_EQ(testBuffer.capacity(), 42);
+    ASSERT_EQ(std::vector<int>(testBuffer.begin(), testBuffer.end()), std::vector<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 }));
+
+    testBuffer.release_spare();
+    ASSERT_EQ(testBuffer.spare_capacity(), 0);
+    cycle();
+    ASSERT_GT(CountingAllocator<int>::allocations, firstCycle);
+}
 }
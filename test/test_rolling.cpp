@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "ring_buffer_rolling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <new>
+#include <numeric>
+#include <random>
+
+
+//
+/// @brief Tests for the rolling window aggregates.
+//================ROLLING=================//
+
+
+namespace
+{
+    // Aggregator that throws from push once the countdown reaches zero.
+    struct ThrowingAggregator
+    {
+        static int countdown;
+        int pushed = 0;
+
+        void push(const int&)
+        {
+            if (countdown-- == 0) throw std::bad_alloc();
+            ++pushed;
+        }
+        void pop(const int&) noexcept { --pushed; }
+        void clear() noexcept { pushed = 0; }
+    };
+    int ThrowingAggregator::countdown = -1;
+}
+
+// Tests that the aggregates match a recomputation over the window after every operation, with many equal elements for the monotonic queues.
+TEST(RollingRingBuffer, MatchesRecomputation)
+{
+    using rolling = rolling_ring_buffer<int, rolling_sum<long long>, rolling_moments<int>, rolling_min<int>, rolling_max<int>>;
+    rolling window(50);
+    std::deque<int> reference;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int> values(-20, 20);
+
+    for (int step = 0; step < 2000; step++)
+    {
+        if (random() % 5 == 0 && !reference.empty())
+        {
+            window.pop_front();
+            reference.pop_front();
+        }
+        else
+        {
+            const int value = values(random);
+            window.push_back(value);
+            reference.push_back(value);
+            if (reference.size() > 50)
+            {
+                reference.pop_front();
+            }
+        }
+
+        ASSERT_EQ(window.size(), reference.size());
+        if (reference.empty())
+        {
+            continue;
+        }
+        const auto sum = std::accumulate(reference.begin(), reference.end(), 0LL);
+        const auto mean = static_cast<double>(sum) / reference.size();
+        double squares = 0;
+        for (auto value : reference)
+        {
+            squares += (value - mean) * (value - mean);
+        }
+        ASSERT_EQ(window.aggregate<rolling_sum<long long>>().value(), sum);
+        ASSERT_NEAR(window.aggregate<1>().mean(), mean, 1e-9);
+        ASSERT_NEAR(window.aggregate<1>().variance(), squares / reference.size(), 1e-7);
+        ASSERT_EQ(window.aggregate<rolling_min<int>>().value(), *std::min_element(reference.begin(), reference.end()));
+        ASSERT_EQ(window.aggregate<rolling_max<int>>().value(), *std::max_element(reference.begin(), reference.end()));
+    }
+
+    window.pop_front_n(10);
+    reference.erase(reference.begin(), reference.begin() + 10);
+    ASSERT_EQ(window.aggregate<0>().value(), std::accumulate(reference.begin(), reference.end(), 0LL));
+    ASSERT_TRUE(std::equal(window.begin(), window.end(), reference.begin()));
+
+    window.clear();
+    ASSERT_TRUE(window.empty());
+    ASSERT_EQ(window.aggregate<0>().value(), 0);
+    ASSERT_EQ(window.aggregate<1>().variance(), 0.0);
+}
+
+// Tests that the compensated sum keeps small elements that a plain sum loses next to a large one.
+TEST(RollingRingBuffer, CompensatedSum)
+{
+    rolling_ring_buffer<double, rolling_sum<double>> window(1001);
+    window.push_back(1e16);
+    for (int i = 0; i < 1000; i++)
+    {
+        window.push_back(1.0);
+    }
+    // The window is full, the large element leaves.
+    window.push_back(1.0);
+    ASSERT_EQ(window.front(), 1.0);
+    ASSERT_EQ(window.aggregate<0>().value(), 1001.0);
+}
+
+// Tests that an aggregator throwing from push leaves the window and the aggregates as they were.
+TEST(RollingRingBuffer, AggregatorThrows)
+{
+    rolling_ring_buffer<int, rolling_sum<int>, ThrowingAggregator> window;
+    window.push_back(1);
+    window.push_back(2);
+    ThrowingAggregator::countdown = 0;
+    ASSERT_THROW(window.push_back(3), std::bad_alloc);
+    ThrowingAggregator::countdown = -1;
+
+    ASSERT_EQ(window.size(), 2);
+    ASSERT_EQ(window.back(), 2);
+    ASSERT_EQ(window.aggregate<0>().value(), 3);
+    ASSERT_EQ(window.aggregate<1>().pushed, 2);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "ring_buffer.hpp"
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+//
+/// @brief Tests for the fixed capacity static_ring_buffer.
+//================STATIC=================//
+
+
+namespace
+{
+    // Element whose move constructor may throw, so it can't be shifted in place.
+    struct ThrowingMove
+    {
+        ThrowingMove(int v) : value(v) {}
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&& other) noexcept(false) : value(other.value) {}
+        ThrowingMove& operator=(const ThrowingMove&) = default;
+        int value;
+    };
+
+#if defined(RING_BUFFER_HAS_CONSTEXPR)
+    struct Point
+    {
+        int x;
+        int y;
+    };
+
+    // Pushes to both ends, pops some elements and sums the rest in order.
+    constexpr int constexprSum()
+    {
+        static_ring_buffer<int, 8> buffer;
+        for (int i = 1; i <= 5; i++)
+        {
+            buffer.push_back(i);
+        }
+        buffer.pop_front();
+        buffer.push_front(10);
+        buffer.emplace_back(20);
+        buffer.pop_back();
+
+        int sum = 0;
+        for (const auto& value : buffer)
+        {
+            sum += value;
+        }
+        return sum + static_cast<int>(buffer.size()) * 100 + buffer.front() * 1000 + buffer[4];
+    }
+
+    // Wraps the indices around a power of two capacity.
+    constexpr int constexprWrap()
+    {
+        static_ring_buffer<Point, 4> buffer;
+        int sum = 0;
+        for (int i = 0; i < 10; i++)
+        {
+            buffer.emplace_back(Point{ i, 2 * i });
+            if (buffer.size() == 3)
+            {
+                sum += buffer.front().x + buffer.back().y;
+                buffer.pop_front();
+            }
+        }
+        buffer.clear();
+        return sum + static_cast<int>(buffer.size() + buffer.capacity());
+    }
+
+    static_assert(constexprSum() == 10 + 2 + 3 + 4 + 5 + 500 + 10000 + 5, "static_ring_buffer must work in constant expressions");
+    static_assert(constexprWrap() == 116 + 4, "static_ring_buffer must wrap in constant expressions");
+#endif
+}
+
+TEST(StaticRingBuffer, FixedCapacity)
+{
+    static_assert(static_capacity_policy<256>::is_pow2 && !static_capacity_policy<10>::is_pow2, "power of two capacities are masked");
+
+    static_ring_buffer<int, 10> buffer;
+    ASSERT_EQ(buffer.capacity(), 10);
+    for (int i = 0; i < 9; i++)
+    {
+        buffer.push_back(i);
+    }
+    ASSERT_THROW(buffer.push_back(9), std::length_error);
+    ASSERT_THROW(buffer.push_front(9), std::length_error);
+    ASSERT_THROW(buffer.reserve(11), std::length_error);
+    ASSERT_EQ(buffer.size(), 9);
+    ASSERT_EQ(buffer.back(), 8);
+
+    // Reserving or shrinking within the capacity does nothing.
+    buffer.reserve(5);
+    buffer.shrink_to_fit();
+    ASSERT_EQ(buffer.capacity(), 10);
+    ASSERT_EQ(buffer.reallocations(), 0);
+
+    // The elements live inside the object.
+    const auto* object = reinterpret_cast<const char*>(&buffer);
+    const auto* first = reinterpret_cast<const char*>(&buffer.front());
+    ASSERT_TRUE(first >= object && first < object + sizeof(buffer));
+}
+
+TEST(StaticRingBuffer, Wrapping)
+{
+    static_ring_buffer<std::string, 8> buffer;
+    for (int i = 0; i < 20; i++)
+    {
+        buffer.push_back(std::to_string(i));
+        if (buffer.size() > 5)
+        {
+            buffer.pop_front();
+        }
+    }
+    ASSERT_FALSE(buffer.array_two().empty());
+    ASSERT_EQ(std::vector<std::string>(buffer.begin(), buffer.end()), std::vector<std::string>({ "15", "16", "17", "18", "19" }));
+
+    // Iterators wrap with the mask, random access crosses the physical end.
+    ASSERT_EQ(*(buffer.begin() + 4), "19");
+    ASSERT_EQ(buffer.end() - buffer.begin(), 5);
+    ASSERT_EQ(buffer.rbegin()[1], "18");
+
+    buffer.insert(buffer.begin() + 2, "x");
+    buffer.erase(buffer.begin());
+    ASSERT_EQ(std::vector<std::string>(buffer.begin(), buffer.end()), std::vector<std::string>({ "16", "x", "17", "18", "19" }));
+
+    // data() rearranges the elements in place.
+    while (buffer.array_two().empty())
+    {
+        buffer.push_back(buffer.front());
+        buffer.pop_front();
+    }
+    const auto* data = buffer.data();
+    ASSERT_EQ(data, &buffer.front());
+    ASSERT_EQ(std::vector<std::string>(data, data + buffer.size()), std::vector<std::string>(buffer.begin(), buffer.end()));
+    ASSERT_EQ(buffer.reallocations(), 0);
+}
+
+TEST(StaticRingBuffer, CopyMoveSwap)
+{
+    static_ring_buffer<std::string, 6> lhs;
+    static_ring_buffer<std::string, 6> rhs;
+    for (int i = 0; i < 9; i++)
+    {
+        lhs.push_back(std::to_string(i));
+        if (lhs.size() > 4)
+        {
+            lhs.pop_front();
+        }
+    }
+    rhs.push_back("a");
+
+    const auto copy = lhs;
+    ASSERT_TRUE(copy == lhs);
+
+    swap(lhs, rhs);
+    ASSERT_EQ(lhs.size(), 1);
+    ASSERT_EQ(lhs.front(), "a");
+    ASSERT_TRUE(rhs == copy);
+
+    auto moved = std::move(rhs);
+    ASSERT_TRUE(moved == copy);
+    ASSERT_TRUE(rhs.empty());
+    rhs = moved;
+    ASSERT_TRUE(rhs == copy);
+    lhs = std::move(moved);
+    ASSERT_TRUE(lhs == copy);
+}
+
+TEST(StaticRingBuffer, Overwrite)
+{
+    ring_buffer<int, std::allocator<int>, overwrite_capacity_policy<static_capacity_policy<4>>> buffer;
+    for (int i = 0; i < 10; i++)
+    {
+        buffer.push_back(i);
+    }
+    ASSERT_EQ(std::vector<int>(buffer.begin(), buffer.end()), std::vector<int>({ 7, 8, 9 }));
+    ASSERT_EQ(buffer.dropped(), 7);
+
+    const std::vector<int> values(10);
+    std::iota(buffer.begin(), buffer.end(), 0);
+    buffer.append(values.data(), values.size());
+    ASSERT_EQ(buffer.size(), 3);
+    ASSERT_EQ(buffer.dropped(), 7 + 10);
+}
+
+TEST(StaticRingBuffer, ThrowingMoves)
+{
+    // Elements that can't be shifted without exceptions would need a second memory area to insert in the middle.
+    static_ring_buffer<ThrowingMove, 8> buffer;
+    buffer.push_back(1);
+    buffer.push_back(2);
+    buffer.push_front(0);
+    ASSERT_THROW(buffer.insert(buffer.begin() + 1, ThrowingMove(5)), std::length_error);
+    ASSERT_EQ(buffer.size(), 3);
+    ASSERT_EQ(buffer[1].value, 1);
+}